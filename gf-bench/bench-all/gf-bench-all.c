@@ -62,15 +62,15 @@ BenchGfNishidaRegion16()
 {
 	char		buf[BUFSIZ], *p, *q;
 	int		n, idx, err = 0;
-	int64_t		sse_idx, avx_idx;
-	uint64_t	bench_res[5];
+	int64_t		sse_idx, avx_idx, avx512_idx, gfni_idx;
+	uint64_t	bench_res[8];
 	FILE		*fp = NULL;
 
 	// Iniitialize
 	memset(bench_res, 0, sizeof(bench_res));
 
 	// Start benchmark 
-	sse_idx = avx_idx = -1;
+	sse_idx = avx_idx = avx512_idx = gfni_idx = -1;
 	for (n = 0; n < num_repeat; n++) {
 		idx = 0;
 		if ((fp = popen("make bench 2> /dev/null", "r")) == NULL) {
@@ -81,7 +81,8 @@ BenchGfNishidaRegion16()
 		}
 
 		// Scan result
-		while(fgets(buf, sizeof(buf), fp) != NULL) {
+		while(fgets(buf, sizeof(buf), fp) != NULL &&
+		      idx < sizeof(bench_res) / sizeof(bench_res[0])) {
 			// Trim bug
 			p = TrimString(buf);
 
@@ -96,6 +97,12 @@ BenchGfNishidaRegion16()
 				if (strstr(p, "SSE") != NULL) {
 					sse_idx = idx;
 				}
+				else if (strstr(p, "GFNI") != NULL) {
+					gfni_idx = idx;
+				}
+				else if (strstr(p, "AVX-512") != NULL) {
+					avx512_idx = idx;
+				}
 				else if (strstr(p, "AVX") != NULL) {
 					avx_idx = idx;
 				}
@@ -131,6 +138,18 @@ BenchGfNishidaRegion16()
 			(double)(SPACE * REPEAT) / ((double)bench_res[avx_idx] /
 					(double)num_repeat));
 	}
+	if (avx512_idx >= 0) {
+		printf("gf-nishida-region-16-4-AVX512, %f\n",
+			(double)(SPACE * REPEAT) /
+				((double)bench_res[avx512_idx] /
+					(double)num_repeat));
+	}
+	if (gfni_idx >= 0) {
+		printf("gf-nishida-region-16-4-GFNI, %f\n",
+			(double)(SPACE * REPEAT) /
+				((double)bench_res[gfni_idx] /
+					(double)num_repeat));
+	}
 #elif defined(_arm64_) // NEON
 	printf("gf-nishida-region-16-4-NEON, %f\n",
 		(double)(SPACE * REPEAT) / ((double)bench_res[3] /
@@ -0,0 +1,126 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2016, 2022
+ *      ASUSA Corporation.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the University nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+// Generate gf-tables.h, the GF16 tables in C source, for gf.c built with
+// _GF_STATIC_TABLES_.
+//
+// Usage:
+//     cc [-DGF16_PRIM=<poly>] [-D_GF16_COMPACT_] -o gf-gen gf-gen.c gf.c
+//     ./gf-gen > gf-tables.h
+//
+// Then build gf.c with the same GF16_PRIM and _GF16_COMPACT_ plus
+// -D_GF_STATIC_TABLES_. The tables go to .rodata and GF16init() only
+// sets pointers to them.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include "gf.h"
+
+// Number of table entries (see GF16init())
+#if defined(_GF16_COMPACT_)
+#define GEN_MEML_SIZE	((65536 - 1) * 2 + 2)
+#define GEN_MEMIDX_SIZE	(65536 + 1)
+#define GEN_IDX_TYPE	"uint16_t"
+#else
+#define GEN_MEML_SIZE	(65536 * 4)
+#define GEN_MEMIDX_SIZE	65536
+#define GEN_IDX_TYPE	"int"
+#endif
+
+// Print array of n entries as C initializer without trailing zeros
+static void
+GenPrintTbl(const char *type, const char *name, size_t size,
+	    const uint32_t *tb, size_t n)
+{
+	size_t	i, last;
+
+	// Trailing zeros are left to zero initialization
+	for (last = n; last > 0 && tb[last - 1] == 0; last--);
+
+	printf("static const _Alignas(64) %s %s[%zu] = {", type, name, size);
+	for (i = 0; i < last; i++) {
+		printf("%s0x%x,", (i & 7) ? " " : "\n\t", tb[i]);
+	}
+	printf("\n};\n\n");
+}
+
+int
+main(void)
+{
+	uint32_t	*tb;
+	int		i;
+
+	// Generate tables as usual
+	GF16init();
+
+	if ((tb = (uint32_t *)malloc(sizeof(uint32_t) * GEN_MEML_SIZE))
+		== NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return 1;
+	}
+
+	printf("// Generated by gf-gen. DO NOT EDIT.\n\n");
+	printf("#ifndef _GF_TABLES_H_\n#define _GF_TABLES_H_\n\n");
+	// alpha^16 is the low 16 bits of the primitive polynomial
+	printf("#define GF16_TABLES_PRIM\t0x%x\n", 0x10000 | GF16memL[16]);
+#if defined(_GF16_COMPACT_)
+	printf("#define GF16_TABLES_COMPACT\t1\n\n");
+#else
+	printf("#define GF16_TABLES_COMPACT\t0\n\n");
+#endif
+
+	for (i = 0; i < GEN_MEML_SIZE; i++) {
+		tb[i] = GF16memL[i];
+	}
+	GenPrintTbl("uint16_t", "GF16memLtbl", GEN_MEML_SIZE, tb,
+		    GEN_MEML_SIZE);
+
+	for (i = 0; i < GEN_MEMIDX_SIZE; i++) {
+		tb[i] = (uint32_t)GF16memIdx[i];
+	}
+	GenPrintTbl(GEN_IDX_TYPE, "GF16memIdxTbl", GEN_MEMIDX_SIZE, tb,
+		    GEN_MEMIDX_SIZE);
+
+	printf("#endif // _GF_TABLES_H_\n");
+	free(tb);
+
+	if (fflush(stdout) != 0 || ferror(stdout)) {
+		fprintf(stderr, "Error: %s: Failed to write tables\n",
+			__func__);
+		return 1;
+	}
+
+	return 0;
+}
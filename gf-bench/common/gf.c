@@ -46,12 +46,32 @@
 #include <stdlib.h> 
 #include <stdint.h> 
 #include <string.h> 
+#include <strings.h> 
 #include <errno.h> 
 #include <time.h> 
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #define	_GF_MAIN_
 #include "gf.h"
 #undef	_GF_MAIN_
 
+// Definitions for SIMD dispatch (see GFsetSIMD())
+static int	GFsimd = -1;	// SIMD instruction set selected
+static size_t	GFalign = 1;	// Alignment of output for SIMD stores
+#define GF_DOT_MAX	32	// Max # of sources of dot product at once
+#define GF_ENC_TILE	4	// # of rows encoded at once
+
+// Force inlining to make arguments constant (e.g. t of GF16encTile*())
+#if defined(__GNUC__) || defined(__clang__)
+#define GF_INLINE	inline __attribute__((always_inline))
+#else
+#define GF_INLINE	inline
+#endif
+static void	GFinitSIMD(void);
+
 
 /**************************************************************************
 	8bit
@@ -61,61 +81,201 @@
 #define GF8_PRIM	487	// Prim poly (others are 285, 299, 301, 333, ...
 #define GF8_SIZE	256	// = 8bit
 
-// Initialize 8bit GF
-void
-GF8init(void)
+// Default field (GF8memMul and GF8memDiv)
+static GF8ctx	GF8ctxDef = { GF8_PRIM, NULL, NULL };
+
+// Create multiplication and division tables of GF(2^8) by prim
+// They are flat [256][256] arrays, so GF8mul(a, b) is one load from
+// GF8memMul + (a << 8) + b without loading pointer of row a first.
+//
+// Return value:
+//     pointer to 512 rows aligned to 64 bytes (0 - 255: a * b,
+//     256 - 511: a / b) or NULL if prim is not primitive or failed.
+//     Free it later.
+//
+static uint8_t *
+GF8crtMulTbl(uint32_t prim)
 {
 	int		i, j, idx_i, idx_j;
-	uint8_t		*GF8memL, *GF8memH;
-	int		*GF8memIdx;
-	uint8_t		t, *p;
+	uint8_t		*memL, *memH, (*memMul)[GF8_SIZE], (*memDiv)[GF8_SIZE];
+	int		*memIdx;
+	uint8_t		t;
 	uint32_t	n;
 
 	// Allocate memory
-	GF8memL = (uint8_t *)malloc(sizeof(uint8_t) * GF8_SIZE * 4);
-	GF8memH = GF8memL + GF8_SIZE - 1; // Second half
-	GF8memIdx = (int *)malloc(sizeof(int) * GF8_SIZE);
-	GF8memMul = (uint8_t **)malloc(sizeof(uint8_t*) * GF8_SIZE * 2);
-	GF8memDiv = GF8memMul + GF8_SIZE;
-	p = (uint8_t *)malloc(sizeof(uint8_t) * GF8_SIZE * GF8_SIZE * 2);
-	for (i = 0; i < GF8_SIZE; i++) {
-		GF8memMul[i] = p;
-		p += GF8_SIZE;
-		GF8memDiv[i] = p;
-		p += GF8_SIZE;
+	memL = (uint8_t *)malloc(sizeof(uint8_t) * GF8_SIZE * 4);
+	memIdx = (int *)malloc(sizeof(int) * GF8_SIZE);
+	memMul = (uint8_t (*)[GF8_SIZE])aligned_alloc(64,
+				sizeof(uint8_t) * GF8_SIZE * GF8_SIZE * 2);
+	if (memL == NULL || memIdx == NULL || memMul == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		goto err;
 	}
-	GF8memL[0] = t = 1;
+	memH = memL + GF8_SIZE - 1; // Second half
+	memDiv = memMul + GF8_SIZE;
+	memL[0] = t = 1;
 
-	// Set GF8mem and GF8memIdx
+	// Set memL and memIdx
 	for (i = 0; i < GF8_SIZE - 1;) {
 		n = (uint32_t)t << 1;
 		i++;
-		GF8memL[i] = t = (uint8_t)((n >= GF8_SIZE) ? n ^ GF8_PRIM : n);
-		GF8memIdx[t] = i;
+		memL[i] = t = (uint8_t)((n >= GF8_SIZE) ? n ^ prim : n);
+		memIdx[t] = i;
+
+		// Period of x must be 255
+		if ((t == 1) != (i == GF8_SIZE - 1) || t == 0) {
+			fprintf(stderr, "Error: %s: 0x%x is not primitive\n",
+				__func__, prim);
+			goto err;
+		}
 	}
-	GF8memIdx[0] = (GF8_SIZE << 1) - 1;
-	GF8memIdx[1] = 0;
+	memIdx[0] = (GF8_SIZE << 1) - 1;
+	memIdx[1] = 0;
 
-	// Copy GF8memL to GF8memH
-	memcpy(GF8memH, GF8memL, sizeof(uint8_t) * (GF8_SIZE - 1));
+	// Copy memL to memH
+	memcpy(memH, memL, sizeof(uint8_t) * (GF8_SIZE - 1));
 
-	// Fill remaining after GF8memH with zero
-	memset(&GF8memL[(GF8_SIZE << 1) - 2], 0,
+	// Fill remaining after memH with zero
+	memset(&memL[(GF8_SIZE << 1) - 2], 0,
 		sizeof(uint8_t) * ((GF8_SIZE << 1) + 2));
 
-	// Set GF8memMul and GF8memDiv
+	// Set memMul and memDiv
 	for (i = 0; i < GF8_SIZE; i++) {
-		idx_i = GF8memIdx[i];
+		idx_i = memIdx[i];
 		for (j = 0; j < GF8_SIZE; j++) {
-			idx_j = GF8memIdx[j];
-			GF8memMul[i][j] = GF8memL[idx_i + idx_j];
-			GF8memDiv[i][j] = GF8memH[idx_i - idx_j];
+			idx_j = memIdx[j];
+			memMul[i][j] = memL[idx_i + idx_j];
+			// a / 0 is 0 (memH[idx_i - idx_j] is before memL)
+			memDiv[i][j] = j == 0 ? 0 : memH[idx_i - idx_j];
 		}
 	}
 
 	// Free temp space
-	free(GF8memL);
-	free(GF8memIdx);
+	free(memL);
+	free(memIdx);
+
+	return (uint8_t *)memMul;
+
+err:
+	free(memL);
+	free(memIdx);
+	free(memMul);
+	return NULL;
+}
+
+// Set up the default field after GF8memMul is set
+static void
+GF8initDef(void)
+{
+	GF8memDiv = GF8memMul != NULL ? GF8memMul + GF8_SIZE : NULL;
+	GF8ctxDef.memMul = GF8memMul;
+	GF8ctxDef.memDiv = GF8memDiv;
+
+	// Select region kernels
+	GFinitSIMD();
+}
+
+// Initialize 8bit GF
+void
+GF8init(void)
+{
+	// Set GF8memMul and GF8memDiv
+	GF8memMul = (uint8_t (*)[GF8_SIZE])GF8crtMulTbl(GF8_PRIM);
+	GF8initDef();
+}
+
+// Create field instance of GF(2^8) with primitive polynomial prim such as
+// 0x11d (x^8 + x^4 + x^3 + x^2 + 1) independent of GF8_PRIM
+//
+// Args:
+//     prim: primitive polynomial of degree 8 (0x100 - 0x1ff)
+//
+// Return value:
+//     pointer to field or NULL if failed. Free it by GF8freeCtx().
+//
+// Usage:
+//     GF8ctx *gf = GF8crtCtx(0x11d);
+//     c = GF8mulCtx(gf, a, b);
+//     GF8mulRegionCtx(gf, y, x, len, a);
+//     GF8freeCtx(gf);
+//
+GF8ctx *
+GF8crtCtx(uint32_t prim)
+{
+	GF8ctx	*ctx;
+
+	// Check prim
+	if (prim < GF8_SIZE || prim >= GF8_SIZE << 1) {
+		fprintf(stderr, "Error: %s: Illegal polynomial: 0x%x "
+			"(degree must be 8)\n", __func__, prim);
+		return NULL;
+	}
+
+	if ((ctx = (GF8ctx *)malloc(sizeof(GF8ctx))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	if ((ctx->memMul = (uint8_t (*)[GF8_SIZE])GF8crtMulTbl(prim)) == NULL) {
+		free(ctx);
+		return NULL;
+	}
+	ctx->memDiv = ctx->memMul + GF8_SIZE;
+	ctx->prim = prim;
+
+	// Select region kernels if GF8init() hasn't
+	GFinitSIMD();
+
+	return ctx;
+}
+
+// Free field instance created by GF8crtCtx()
+void
+GF8freeCtx(GF8ctx *ctx)
+{
+	if (ctx == NULL) {
+		return;
+	}
+	free(ctx->memMul);
+	free(ctx);
+}
+
+// Copy field instance (NULL: default field of GF8init()) to new memory
+// The copy is written by the calling thread, so on NUMA systems the pages
+// are placed on the node of the CPU it runs on (first touch).
+//
+// Return value:
+//     pointer to copy or NULL if failed. Free it by GF8freeCtx().
+//
+GF8ctx *
+GF8dupCtx(const GF8ctx *src)
+{
+	GF8ctx	*ctx;
+
+	if (src == NULL) {
+		src = &GF8ctxDef;
+	}
+	if (src->memMul == NULL) {
+		fprintf(stderr, "Error: %s: Field is not initialized\n",
+			__func__);
+		return NULL;
+	}
+
+	if ((ctx = (GF8ctx *)malloc(sizeof(GF8ctx))) == NULL ||
+	    (ctx->memMul = (uint8_t (*)[GF8_SIZE])aligned_alloc(64,
+			sizeof(uint8_t) * GF8_SIZE * GF8_SIZE * 2)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		free(ctx);
+		return NULL;
+	}
+	memcpy(ctx->memMul, src->memMul, sizeof(uint8_t) * GF8_SIZE * GF8_SIZE);
+	ctx->memDiv = ctx->memMul + GF8_SIZE;
+	memcpy(ctx->memDiv, src->memDiv, sizeof(uint8_t) * GF8_SIZE * GF8_SIZE);
+	ctx->prim = src->prim;
+
+	return ctx;
 }
 
 /******************** For regional calculation ********************/ 
@@ -317,497 +477,4758 @@ GF8crt4bitRegTbl256(uint8_t a, int type)
 	return tb_l;
 }
 
-// Test GF8
-void
-GF8test(void)
-{
-	int		i, j;
-	uint8_t		a, b, c, d, *tbl_0, *tbl_1;
-
-	for (i = 0; i < 256; i++) {
-		a = (uint8_t)i;
-		for (j = 1; j < 256; j++) {
-			b = (uint8_t)j;
-			c = GF8mul(a, b);
-			d = GF8div(c, b);
-
-			if (d != i) {
-				printf("GF8test: d (%d) != i (%d)\n",
-					d, i);
-				printf("i = %d, j = %d, c = %d, d = %d\n",
-					i, j, c, d);
-				exit(1);
-			}
-		}
-	}
-
-	a = 0;
-	do {
-		// Test one step lookup region multiplication
-		tbl_0 = GF8crtRegTbl(a, 0);
-		for (i = 0; i < 256; i++) {
-			d = tbl_0[i];
-			if (d != GF8mul(a, i)) {
-				printf("GF8test: %d != GF8mul(%d, %d)\n",
-					d, a, i);
-				exit(1);
-			}
-		}
-		free(tbl_0);
-
-		// Test 4bit split table lookup region multiplication
-		tbl_0 = GF8crt4bitRegTbl(a, 0);
-		tbl_1 = tbl_0 + 16;
-		for (i = 0; i < 256; i++) {
-			d = tbl_1[i >> 4] ^ tbl_0[i & 0xf];
-			if (d != GF8mul(a, i)) {
-				printf("GF8test: %d != GF8mul(%d, %d)\n",
-					d, a, i);
-				exit(1);
-			}
-		}
-		free(tbl_0);
-
-		// Division
-		if (a) {
-			// Test one step lookup region division
-			tbl_0 = GF8crtRegTbl(a, 1);
-			for (i = 0; i < 256; i++) {
-				d = tbl_0[i];
-				if (d != GF8div(i, a)) {
-					printf("GF8test: %d != GF8div(%d, %d)"
-					       "\n", d, i, a);
-					exit(1);
-				}
-			}
-			free(tbl_0);
-
-			// Test 4bit split table lookup region division
-			tbl_0 = GF8crt4bitRegTbl(a, 1);
-			tbl_1 = tbl_0 + 16;
-			for (i = 0; i < 256; i++) {
-				d = tbl_1[i >> 4] ^ tbl_0[i & 0xf];
-				if (d != GF8div(i, a)) {
-					printf("GF8test: %d != GF8div(%d, %d)"
-					       "\n", d, i, a);
-					exit(1);
-				}
-			}
-			free(tbl_0);
-		}
-
-		a++;
-	} while (a);
-
-	puts("GF8test: Passed");
-}
-
-/**************************************************************************
-	16bit
-**************************************************************************/
-
-// Definitions for GF16
-#define	GF16_PRIM	69643	// Prim poly: 0x1100b = x^16 + x^12 + x^3 + x +1
-#define	GF16_SIZE	65536	// = 16bit 
-/*
-	For more primitive polynomials, see:
-	http://web.eecs.utk.edu/~plank/plank/papers/CS-07-593/primitive-polynomial-table.txt
-*/
-
-// Initialize 16bit GF
-void
-GF16init(void)
+// Create 8x8 bit matrix of multiplication by a for GFNI affine
+// instruction (gf2p8affineqb) from col[j] = a * 2^j.
+// Bit j of row i is bit i of a * 2^j and row i is placed in byte 7 - i.
+static uint64_t
+GF8affineMtx(const uint8_t *col)
 {
-	int		i;
-	uint32_t	n;
-	
-	// Allocate memory 
-	GF16memL = (uint16_t *)malloc(sizeof(uint16_t) * GF16_SIZE * 4);
-	GF16memH = GF16memL + GF16_SIZE - 1; // Second half
-	GF16memIdx = (int *)malloc(sizeof(int) * GF16_SIZE);
-	GF16memL[0] = n = 1;
+	int		j;
+	uint64_t	x;
 
-	// Set GF16memL and GF16memIdx
-	for (i = 0; i < GF16_SIZE - 1;) {
-#if 1
-		n <<= 1;
-		i++;
-		if (n >= GF16_SIZE) {
-			n ^= GF16_PRIM;
-		}
-		GF16memL[i] = (uint16_t)n;
-		GF16memIdx[n] = i;
-#else
-		n = (uint32_t)GF16memL[i] << 1;
-		i++;
-		GF16memL[i] = (uint16_t)
-			((n >= GF16_SIZE) ? n ^ GF16_PRIM : n);
-		GF16memIdx[GF16memL[i]] = i;
-#endif
+	// Byte j = column j
+	for (x = 0, j = 0; j < 8; j++) {
+		x |= (uint64_t)col[j] << (j << 3);
 	}
-	GF16memIdx[0] = (GF16_SIZE << 1) - 1;
-	GF16memIdx[1] = 0;
 
-	// Copy first half of GF16memL to second half
-	memcpy(GF16memH, GF16memL, sizeof(uint16_t) * (GF16_SIZE - 1));
+	// Transpose 8x8 bit matrix (byte i = row i)
+	x = (x & 0xaa55aa55aa55aa55ULL) |
+	    ((x & 0x00aa00aa00aa00aaULL) << 7) |
+	    ((x >> 7) & 0x00aa00aa00aa00aaULL);
+	x = (x & 0xcccc3333cccc3333ULL) |
+	    ((x & 0x0000cccc0000ccccULL) << 14) |
+	    ((x >> 14) & 0x0000cccc0000ccccULL);
+	x = (x & 0xf0f0f0f00f0f0f0fULL) |
+	    ((x & 0x00000000f0f0f0f0ULL) << 28) |
+	    ((x >> 28) & 0x00000000f0f0f0f0ULL);
 
-	// Fill remaining space after GF16memH with zero
-	memset(&GF16memL[(GF16_SIZE << 1) - 2], 0,
-		sizeof(uint16_t) * ((GF16_SIZE << 1) + 2));
+	// Reverse bytes (row i -> byte 7 - i)
+	return __builtin_bswap64(x);
 }
 
-/******************** For regional calculation ********************/ 
-
-// Create table for regional calculation such as:
-//     a * x[i]
-//     x[i] / a
-// This method may fit L2 cache and will be fast.
+// Create matrix table for GFNI (64 bytes)
+// It is 8x8 bit matrix of multiplication by a (or 1 / a) in GF(2^8)
+// repeated 8 times so that it can be loaded into any SIMD register.
 //
 // Args:
-//     a: static value in regional calculation (or coefficient)
-//     type: 0: a * x[i]
-//           1: x[i] / a
+//     a: multiplier or divisor
+//     type: 0: y[i] = a * x[i], 1: y[i] = x[i] / a
 //
 // Return value:
 //     pointer to table or NULL if failed. Free it later.
 //
-// How to use:
-//    For a * x[i],
-//        uint16_t *gf_a = GF16crtRegTbl(a, 0);
-//        for (i = 0; i < N; i++) {
-//            y[i] = gf_a[x[i]]; // This is equal to GFmul(a, x[i]);
-//            // Or use y[i] = GF16LkupRT(gf_a, x[i]);
-//        }
-//        free(gf_a);
-//
-//    For x[i] / a,
-//        uint16_t *gf_a = GF16crtRegTbl(a, 1);
-//        for (i = 0; i < N; i++) {
-//            y[i] = gf_a[x[i]]; // This is equal to GFdiv(x[i], a);
-//            // Or use y[i] = GF16LkupRT(gf_a, x[i]);
-//        }
-//        free(gf_a);
+// Usage:
+//     use with GF8affineSIMD256 or GF8affineSIMD512 in gf.h.
+//     See gf-bench/multiplication/gf-nishida-region-8/gf-bench.c
+//     for more details.
 //
-uint16_t *
-GF16crtRegTbl(uint16_t a, int type)
+uint64_t *
+GF8crtAffineTbl(uint8_t a, int type)
 {
 	int		i;
-	uint16_t	*table = NULL, *a_addr;
-
-	// Allocate table
-	if ((table = (uint16_t *)
-			aligned_alloc(64, GF16_SIZE * sizeof(uint16_t)))
-				== NULL) {
-		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
-			__func__, strerror(errno));
-		return NULL;	
-	}
+	uint8_t		col[8], *a_addr;
+	uint64_t	*tb, mtx;
 
-	// Input values
+	// Check type
 	switch (type) {
 	case 0: // a * x[i]
-		a_addr = GF16memL + GF16memIdx[a];
-
-		// Input values
-		for (i = 0; i < GF16_SIZE; i++) {
-			table[i] = a_addr[GF16memIdx[i]];
-		}
+		a_addr = GF8memMul[a];
 		break;
 
 	case 1: // x[i] / a
-		a_addr = GF16memH - GF16memIdx[a];
-
-		// Input values
-		for (i = 0; i < GF16_SIZE; i++) {
-			table[i] = a_addr[GF16memIdx[i]];
-		}
+		a_addr = GF8memMul[GF8div(1, a)];
 		break;
 
 	default:
 		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
-			"(value must be 0, 1, or 2)\n",
+			"(value must be 0 or 1)\n",
 			__func__, type);
-		free(table);
 		return NULL;
 	}
 
-	return table;
+	// Allocate table
+	if ((tb = (uint64_t *)aligned_alloc(64, 64)) == NULL) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+
+	// Create matrix from a * 2^j
+	for (i = 0; i < 8; i++) {
+		col[i] = a_addr[1 << i];
+	}
+	mtx = GF8affineMtx(col);
+
+	// Input values
+	for (i = 0; i < 8; i++) {
+		tb[i] = mtx;
+	}
+
+	return tb;
 }
 
-// Create 8bit split tables for regional calculation such as:
-//     a * x[i]
-//     x[i] / a
-// This method may fit L1 cache and will be even faster.
-//
-// Args:
+/******************** Region drivers ********************/ 
+
+// Fill 4bit split tables (32 bytes) of GF8crt4bitRegTbl() of field ctx
+// into tb without allocation
+static void
+GF8set4bitRegTbl(const GF8ctx *ctx, uint8_t *tb, uint8_t a, int type)
+{
+	int	i;
+	uint8_t	*a_addr;
+
+	// a * x[i] or x[i] / a (= (1 / a) * x[i])
+	a_addr = ctx->memMul[type ? GF8divCtx(ctx, 1, a) : a];
+
+	// Input values
+	for (i = 0; i < 16; i++) {
+		tb[i] = a_addr[i];
+		tb[16 + i] = a_addr[i << 4];
+	}
+}
+
+// Region kernels for each SIMD instruction set
+// They process as many bytes as fit SIMD registers and return the number
+// of bytes processed. xor: 0: y[i] = a * x[i], 1: y[i] ^= a * x[i]
+
+// No SIMD
+static size_t
+GF8lkupRegionNone(const uint8_t *gf_tb, const uint8_t *input,
+		  uint8_t *output, size_t len, int xor)
+{
+	return 0;
+}
+
+#if defined(_GF_X86_)
+// SSSE3 -- every 16 bytes
+GF_TARGET("ssse3") static size_t
+GF8lkupRegionSSSE3(const uint8_t *gf_tb, const uint8_t *input,
+		   uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m128i	tb_a_l, tb_a_h;
+
+	// Load tables
+	tb_a_l = _mm_loadu_si128((__m128i *)(gf_tb + 0));
+	tb_a_h = _mm_loadu_si128((__m128i *)(gf_tb + 16));
+
+	for (n = 0; n + 16 <= len; n += 16) { // Do every 128bit
+		if (xor) {
+			GF8lkupSIMD128Xor(tb_a_l, tb_a_h, input + n,
+					  output + n);
+		}
+		else {
+			GF8lkupSIMD128(tb_a_l, tb_a_h, input + n, output + n);
+		}
+	}
+
+	return n;
+}
+
+// AVX2 -- every 32 bytes
+GF_TARGET("avx2") static size_t
+GF8lkupRegionAVX2(const uint8_t *gf_tb, const uint8_t *input,
+		  uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m256i	tb_a_l, tb_a_h;
+
+	// Broadcast 128bit tables to both lanes
+	tb_a_l = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 0)));
+	tb_a_h = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 16)));
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 256bit
+		if (xor) {
+			GF8lkupSIMD256Xor(tb_a_l, tb_a_h, input + n,
+					  output + n);
+		}
+		else {
+			GF8lkupSIMD256(tb_a_l, tb_a_h, input + n, output + n);
+		}
+	}
+
+	// Remaining 16 bytes
+	return n + GF8lkupRegionSSSE3(gf_tb, input + n, output + n,
+				      len - n, xor);
+}
+
+// AVX-512BW -- every 64 bytes
+GF_TARGET("avx512f,avx512bw") static size_t
+GF8lkupRegionAVX512(const uint8_t *gf_tb, const uint8_t *input,
+		    uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m512i	tb_a_l, tb_a_h;
+
+	// Broadcast 128bit tables to all lanes
+	tb_a_l = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 0)));
+	tb_a_h = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 16)));
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 512bit
+		if (xor) {
+			GF8lkupSIMD512Xor(tb_a_l, tb_a_h, input + n,
+					  output + n);
+		}
+		else {
+			GF8lkupSIMD512(tb_a_l, tb_a_h, input + n, output + n);
+		}
+	}
+
+	// Remaining 48 bytes
+	return n + GF8lkupRegionAVX2(gf_tb, input + n, output + n,
+				     len - n, xor);
+}
+
+// Get GFNI matrix from 4bit split tables
+// a * 2^j (j = 0, ..., 7) are in tb_l[1, 2, 4, 8] and tb_h[1, 2, 4, 8].
+static inline uint64_t
+GF8affineMtx4bit(const uint8_t *gf_tb)
+{
+	uint8_t	col[8];
+
+	col[0] = gf_tb[1];
+	col[1] = gf_tb[2];
+	col[2] = gf_tb[4];
+	col[3] = gf_tb[8];
+	col[4] = gf_tb[16 + 1];
+	col[5] = gf_tb[16 + 2];
+	col[6] = gf_tb[16 + 4];
+	col[7] = gf_tb[16 + 8];
+
+	return GF8affineMtx(col);
+}
+
+// AVX2 + GFNI -- every 32 bytes
+GF_TARGET("gfni,avx2") static size_t
+GF8affineRegionAVX2(const uint8_t *gf_tb, const uint8_t *input,
+		    uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m256i	mtx_a;
+
+	// Broadcast matrix to all 64bit
+	mtx_a = _mm256_set1_epi64x((long long)GF8affineMtx4bit(gf_tb));
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 256bit
+		if (xor) {
+			GF8affineSIMD256Xor(mtx_a, input + n, output + n);
+		}
+		else {
+			GF8affineSIMD256(mtx_a, input + n, output + n);
+		}
+	}
+
+	// Remaining 16 bytes
+	return n + GF8lkupRegionSSSE3(gf_tb, input + n, output + n,
+				      len - n, xor);
+}
+
+// AVX-512BW + GFNI -- every 64 bytes
+GF_TARGET("gfni,avx512f,avx512bw") static size_t
+GF8affineRegionAVX512(const uint8_t *gf_tb, const uint8_t *input,
+		      uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m512i	mtx_a;
+
+	// Broadcast matrix to all 64bit
+	mtx_a = _mm512_set1_epi64((long long)GF8affineMtx4bit(gf_tb));
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 512bit
+		if (xor) {
+			GF8affineSIMD512Xor(mtx_a, input + n, output + n);
+		}
+		else {
+			GF8affineSIMD512(mtx_a, input + n, output + n);
+		}
+	}
+
+	// Remaining 48 bytes
+	return n + GF8affineRegionAVX2(gf_tb, input + n, output + n,
+				       len - n, xor);
+}
+#elif defined(_arm64_) // NEON
+// NEON -- every 16 bytes
+static size_t
+GF8lkupRegionNEON(const uint8_t *gf_tb, const uint8_t *input,
+		  uint8_t *output, size_t len, int xor)
+{
+	size_t		n;
+	uint8x16_t	tb_a_l, tb_a_h;
+
+	// Load tables
+	tb_a_l = vld1q_u8(gf_tb + 0);
+	tb_a_h = vld1q_u8(gf_tb + 16);
+
+	for (n = 0; n + 16 <= len; n += 16) { // Do every 128bit
+		if (xor) {
+			GF8lkupSIMD128Xor(tb_a_l, tb_a_h, input + n,
+					  output + n);
+		}
+		else {
+			GF8lkupSIMD128(tb_a_l, tb_a_h, input + n, output + n);
+		}
+	}
+
+	return n;
+}
+#endif
+
+// Region kernel selected by GFsetSIMD()
+static size_t	(*GF8lkupRegionSIMD)(const uint8_t *, const uint8_t *,
+				     uint8_t *, size_t, int)
+			= GF8lkupRegionNone;
+
+// Body of GF8lkupRegion() and GF8lkupRegionXor()
+// xor is constant and the branches are removed after inlining.
+static inline void
+GF8lkupRegionBody(const uint8_t *gf_tb, const uint8_t *input,
+		  uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+
+	// Align output for SIMD stores
+	n = (GFalign - ((uintptr_t)output & (GFalign - 1))) & (GFalign - 1);
+	if (len < GFalign * 4) {
+		n = 0;
+	}
+	for (len -= n; n; n--) {
+		*output = GF8Lkup4bitRT(gf_tb, *input) ^ (xor ? *output : 0);
+		input++;
+		output++;
+	}
+
+	// SIMD
+	n = GF8lkupRegionSIMD(gf_tb, input, output, len, xor);
+	input += n;
+	output += n;
+	len -= n;
+
+	// Tail
+	for (; len; len--) {
+		*output = GF8Lkup4bitRT(gf_tb, *input) ^ (xor ? *output : 0);
+		input++;
+		output++;
+	}
+}
+
+// Calculate a * x[i] over a whole region such as:
+//     y[i] = a * x[i]
+// The widest SIMD kernel available is used. Unaligned heads and the tail
+// that does not fill a SIMD register are processed by GF8Lkup4bitRT(),
+// so any address and length can be given.
+//
+// Args:
+//     gf_tb: tables created by GF8crt4bitRegTbl() (32 bytes)
+//     input: x[]
+//     output: y[]
+//     len: length of region in bytes
+//
+// Usage:
+//     uint8_t *gf_tb = GF8crt4bitRegTbl(a, 0);
+//     GF8lkupRegion(gf_tb, x, y, len);
+//     free(gf_tb);
+//
+void
+GF8lkupRegion(const uint8_t *gf_tb, const uint8_t *input, uint8_t *output,
+	      size_t len)
+{
+	GF8lkupRegionBody(gf_tb, input, output, len, 0);
+}
+
+// Same as GF8lkupRegion() but XOR results into y[i] such as:
+//     y[i] ^= a * x[i]
+// This saves another pass over y[] in erasure coding (parity update).
+void
+GF8lkupRegionXor(const uint8_t *gf_tb, const uint8_t *input, uint8_t *output,
+		 size_t len)
+{
+	GF8lkupRegionBody(gf_tb, input, output, len, 1);
+}
+
+// Calculate dst[i] = a * src[i] over a whole buffer
+// Tables are built on stack, so nothing is allocated per call.
+void
+GF8mulRegion(uint8_t *dst, const uint8_t *src, size_t len, uint8_t a)
+{
+	GF8mulRegionCtx(&GF8ctxDef, dst, src, len, a);
+}
+
+// Calculate dst[i] = src[i] / a over a whole buffer (a must not be 0)
+void
+GF8divRegion(uint8_t *dst, const uint8_t *src, size_t len, uint8_t a)
+{
+	GF8divRegionCtx(&GF8ctxDef, dst, src, len, a);
+}
+
+// Calculate dst[i] ^= a * src[i] over a whole buffer
+void
+GF8mulAddRegion(uint8_t *dst, const uint8_t *src, size_t len, uint8_t a)
+{
+	GF8mulAddRegionCtx(&GF8ctxDef, dst, src, len, a);
+}
+
+// Same as GF8mulRegion() but in field ctx created by GF8crtCtx()
+// Only 32 byte tables depend on the field, so the kernels are as fast as
+// GF8mulRegion().
+void
+GF8mulRegionCtx(const GF8ctx *ctx, uint8_t *dst, const uint8_t *src,
+		size_t len, uint8_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[32];
+
+	GF8set4bitRegTbl(ctx, gf_tb, a, 0);
+	GF8lkupRegionBody(gf_tb, src, dst, len, 0);
+}
+
+// Same as GF8divRegion() but in field ctx
+void
+GF8divRegionCtx(const GF8ctx *ctx, uint8_t *dst, const uint8_t *src,
+		size_t len, uint8_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[32];
+
+	GF8set4bitRegTbl(ctx, gf_tb, a, 1);
+	GF8lkupRegionBody(gf_tb, src, dst, len, 0);
+}
+
+// Same as GF8mulAddRegion() but in field ctx
+void
+GF8mulAddRegionCtx(const GF8ctx *ctx, uint8_t *dst, const uint8_t *src,
+		   size_t len, uint8_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[32];
+
+	GF8set4bitRegTbl(ctx, gf_tb, a, 0);
+	GF8lkupRegionBody(gf_tb, src, dst, len, 1);
+}
+
+/******************** Dot product ********************/
+
+// Step and region kernels of dot product for each SIMD instruction set
+// Accumulators stay in SIMD registers while all k sources are streamed,
+// so dst[] is loaded and stored only once.
+// gf_tb is k tables (32 bytes each) and srcs[i] + off is the source i
+// for dst. xor: 0: dst[n] = sum, 1: dst[n] ^= sum
+
+// No SIMD
+static size_t
+GF8dotRegionNone(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		 size_t off, uint8_t *dst, size_t len, int xor)
+{
+	return 0;
+}
+
+#if defined(_GF_X86_)
+// Multiply 16 bytes of input by a and XOR into acc by SSSE3
+GF_TARGET("ssse3") static inline __m128i
+GF8dotStep128(const uint8_t *tb, const uint8_t *input, __m128i acc)
+{
+	__m128i	v_input, tmp;
+
+	// Load input
+	v_input = _mm_loadu_si128((__m128i *)input);
+	tmp = _mm_set1_epi8(0x0f);
+
+	// Lookup low and high 4bit and XOR into acc
+	acc = _mm_xor_si128(acc, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)tb),
+			_mm_and_si128(v_input, tmp)));
+	acc = _mm_xor_si128(acc, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 16)),
+			_mm_and_si128(_mm_srli_epi16(v_input, 4), tmp)));
+
+	return acc;
+}
+
+// Multiply 32 bytes of input by a and XOR into acc by AVX2
+GF_TARGET("avx2") static inline __m256i
+GF8dotStep256(const uint8_t *tb, const uint8_t *input, __m256i acc)
+{
+	__m256i	v_input, tmp;
+
+	// Load input
+	v_input = _mm256_loadu_si256((__m256i *)input);
+	tmp = _mm256_set1_epi8(0x0f);
+
+	// Lookup low and high 4bit and XOR into acc
+	acc = _mm256_xor_si256(acc, _mm256_shuffle_epi8(
+			_mm256_broadcastsi128_si256(
+				_mm_loadu_si128((__m128i *)tb)),
+			_mm256_and_si256(v_input, tmp)));
+	acc = _mm256_xor_si256(acc, _mm256_shuffle_epi8(
+			_mm256_broadcastsi128_si256(
+				_mm_loadu_si128((__m128i *)(tb + 16))),
+			_mm256_and_si256(_mm256_srli_epi16(v_input, 4), tmp)));
+
+	return acc;
+}
+
+// Multiply 64 bytes of input by a and XOR into acc by AVX-512BW
+GF_TARGET("avx512f,avx512bw") static inline __m512i
+GF8dotStep512(const uint8_t *tb, const uint8_t *input, __m512i acc)
+{
+	__m512i	v_input, tmp;
+
+	// Load input
+	v_input = _mm512_loadu_si512((__m512i *)input);
+	tmp = _mm512_set1_epi8(0x0f);
+
+	// Lookup low and high 4bit and XOR into acc
+	acc = _mm512_xor_si512(acc, _mm512_shuffle_epi8(
+			_mm512_broadcast_i32x4(
+				_mm_loadu_si128((__m128i *)tb)),
+			_mm512_and_si512(v_input, tmp)));
+	acc = _mm512_xor_si512(acc, _mm512_shuffle_epi8(
+			_mm512_broadcast_i32x4(
+				_mm_loadu_si128((__m128i *)(tb + 16))),
+			_mm512_and_si512(_mm512_srli_epi16(v_input, 4), tmp)));
+
+	return acc;
+}
+
+// SSSE3 -- every 16 bytes
+GF_TARGET("ssse3") static size_t
+GF8dotRegionSSSE3(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		  size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int	i;
+	size_t	n;
+	__m128i	acc;
+
+	for (n = 0; n + 16 <= len; n += 16) { // Do every 128bit
+		acc = xor ? _mm_loadu_si128((__m128i *)(dst + n)) :
+			    _mm_setzero_si128();
+		for (i = 0; i < k; i++) {
+			acc = GF8dotStep128(gf_tb + (i << 5),
+					    srcs[i] + off + n, acc);
+		}
+		_mm_storeu_si128((__m128i *)(dst + n), acc);
+	}
+
+	return n;
+}
+
+// AVX2 -- every 32 bytes
+GF_TARGET("avx2") static size_t
+GF8dotRegionAVX2(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		 size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int	i;
+	size_t	n;
+	__m256i	acc;
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 256bit
+		acc = xor ? _mm256_loadu_si256((__m256i *)(dst + n)) :
+			    _mm256_setzero_si256();
+		for (i = 0; i < k; i++) {
+			acc = GF8dotStep256(gf_tb + (i << 5),
+					    srcs[i] + off + n, acc);
+		}
+		_mm256_storeu_si256((__m256i *)(dst + n), acc);
+	}
+
+	// Remaining 16 bytes
+	return n + GF8dotRegionSSSE3(gf_tb, srcs, k, off + n, dst + n,
+				     len - n, xor);
+}
+
+// AVX-512BW -- every 64 bytes
+GF_TARGET("avx512f,avx512bw") static size_t
+GF8dotRegionAVX512(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		   size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int	i;
+	size_t	n;
+	__m512i	acc;
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 512bit
+		acc = xor ? _mm512_loadu_si512((__m512i *)(dst + n)) :
+			    _mm512_setzero_si512();
+		for (i = 0; i < k; i++) {
+			acc = GF8dotStep512(gf_tb + (i << 5),
+					    srcs[i] + off + n, acc);
+		}
+		_mm512_storeu_si512((__m512i *)(dst + n), acc);
+	}
+
+	// Remaining 48 bytes
+	return n + GF8dotRegionAVX2(gf_tb, srcs, k, off + n, dst + n,
+				    len - n, xor);
+}
+
+// AVX2 + GFNI -- every 32 bytes
+GF_TARGET("gfni,avx2") static size_t
+GF8dotRegionAffineAVX2(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		       int k, size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	uint64_t	mtx[GF_DOT_MAX];
+	__m256i		acc;
+
+	// Get matrices from 4bit tables
+	for (i = 0; i < k; i++) {
+		mtx[i] = GF8affineMtx4bit(gf_tb + (i << 5));
+	}
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 256bit
+		acc = xor ? _mm256_loadu_si256((__m256i *)(dst + n)) :
+			    _mm256_setzero_si256();
+		for (i = 0; i < k; i++) {
+			acc = _mm256_xor_si256(acc,
+				_mm256_gf2p8affine_epi64_epi8(
+				    _mm256_loadu_si256((__m256i *)
+						       (srcs[i] + off + n)),
+				    _mm256_set1_epi64x((long long)mtx[i]), 0));
+		}
+		_mm256_storeu_si256((__m256i *)(dst + n), acc);
+	}
+
+	// Remaining 16 bytes
+	return n + GF8dotRegionSSSE3(gf_tb, srcs, k, off + n, dst + n,
+				     len - n, xor);
+}
+
+// AVX-512BW + GFNI -- every 64 bytes
+GF_TARGET("gfni,avx512f,avx512bw") static size_t
+GF8dotRegionAffineAVX512(const uint8_t *gf_tb, const uint8_t * const *srcs,
+			 int k, size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	uint64_t	mtx[GF_DOT_MAX];
+	__m512i		acc;
+
+	// Get matrices from 4bit tables
+	for (i = 0; i < k; i++) {
+		mtx[i] = GF8affineMtx4bit(gf_tb + (i << 5));
+	}
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 512bit
+		acc = xor ? _mm512_loadu_si512((__m512i *)(dst + n)) :
+			    _mm512_setzero_si512();
+		for (i = 0; i < k; i++) {
+			acc = _mm512_xor_si512(acc,
+				_mm512_gf2p8affine_epi64_epi8(
+				    _mm512_loadu_si512((__m512i *)
+						       (srcs[i] + off + n)),
+				    _mm512_set1_epi64((long long)mtx[i]), 0));
+		}
+		_mm512_storeu_si512((__m512i *)(dst + n), acc);
+	}
+
+	// Remaining 48 bytes
+	return n + GF8dotRegionAffineAVX2(gf_tb, srcs, k, off + n, dst + n,
+					  len - n, xor);
+}
+#elif defined(_arm64_) // NEON
+// NEON -- every 16 bytes
+static size_t
+GF8dotRegionNEON(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		 size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	const uint8_t	*tb;
+	uint8x16_t	acc, v_input, tmp;
+
+	tmp = vdupq_n_u8(0x0f);
+	for (n = 0; n + 16 <= len; n += 16) { // Do every 128bit
+		acc = xor ? vld1q_u8(dst + n) : vdupq_n_u8(0);
+		for (i = 0; i < k; i++) {
+			tb = gf_tb + (i << 5);
+			v_input = vld1q_u8(srcs[i] + off + n);
+			acc = veorq_u8(acc, vqtbl1q_u8(vld1q_u8(tb),
+					vandq_u8(v_input, tmp)));
+			acc = veorq_u8(acc, vqtbl1q_u8(vld1q_u8(tb + 16),
+					vshrq_n_u8(v_input, 4)));
+		}
+		vst1q_u8(dst + n, acc);
+	}
+
+	return n;
+}
+#endif
+
+// Dot product kernel selected by GFsetSIMD()
+static size_t	(*GF8dotRegionSIMD)(const uint8_t *, const uint8_t * const *,
+				    int, size_t, uint8_t *, size_t, int)
+			= GF8dotRegionNone;
+
+// Process bytes of dot product one by one with 4bit tables
+static inline void
+GF8dotRegionScalar(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		   size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int	i;
+	size_t	n;
+	uint8_t	acc;
+
+	for (n = 0; n < len; n++) {
+		acc = xor ? dst[n] : 0;
+		for (i = 0; i < k; i++) {
+			acc ^= GF8Lkup4bitRT(gf_tb + (i << 5),
+					     srcs[i][off + n]);
+		}
+		dst[n] = acc;
+	}
+}
+
+// Body of GF8dotRegion()
+// k must be GF_DOT_MAX or less.
+static void
+GF8dotRegionBody(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		 uint8_t *dst, size_t len, int xor)
+{
+	size_t	n, off;
+
+	// Align dst for SIMD stores
+	n = (GFalign - ((uintptr_t)dst & (GFalign - 1))) & (GFalign - 1);
+	if (len < GFalign * 4) {
+		n = 0;
+	}
+	GF8dotRegionScalar(gf_tb, srcs, k, 0, dst, n, xor);
+	off = n;
+
+	// SIMD
+	off += GF8dotRegionSIMD(gf_tb, srcs, k, off, dst + off, len - off,
+				xor);
+
+	// Tail
+	GF8dotRegionScalar(gf_tb, srcs, k, off, dst + off, len - off, xor);
+}
+
+// Calculate dot product of k regions and coefficients such as:
+//     dst[n] = coefs[0] * srcs[0][n] + ... + coefs[k - 1] * srcs[k - 1][n]
+// It is one row of Reed-Solomon encoding. dst[] is streamed only once
+// (every GF_DOT_MAX sources) instead of k times with GF8mulAddRegion().
+// Tables are built on stack once per call, so nothing is allocated.
+//
+// Args:
+//     dst: result region
+//     srcs: k source regions
+//     coefs: k coefficients
+//     k: # of sources
+//     len: length of each region in bytes
+//
+// Usage:
+//     const uint8_t *data[10] = { ... };
+//     uint8_t coefs[10] = { ... };
+//     GF8dotRegion(parity, data, coefs, 10, len);
+//
+void
+GF8dotRegion(uint8_t *dst, const uint8_t * const *srcs, const uint8_t *coefs,
+	     int k, size_t len)
+{
+	GF8dotRegionCtx(&GF8ctxDef, dst, srcs, coefs, k, len);
+}
+
+// Same as GF8dotRegion() but in field ctx created by GF8crtCtx()
+void
+GF8dotRegionCtx(const GF8ctx *ctx, uint8_t *dst, const uint8_t * const *srcs,
+		const uint8_t *coefs, int k, size_t len)
+{
+	int			i, j, n;
+	_Alignas(64) uint8_t	gf_tb[GF_DOT_MAX * 32];
+
+	// No source
+	if (k <= 0) {
+		memset(dst, 0, len);
+		return;
+	}
+
+	// Every GF_DOT_MAX sources
+	for (i = 0; i < k; i += n) {
+		n = k - i < GF_DOT_MAX ? k - i : GF_DOT_MAX;
+		for (j = 0; j < n; j++) {
+			GF8set4bitRegTbl(ctx, gf_tb + (j << 5), coefs[i + j],
+					 0);
+		}
+		GF8dotRegionBody(gf_tb, srcs + i, n, dst, len, i > 0);
+	}
+}
+
+// Test GF8
+void
+GF8test(void)
+{
+	int		i, j;
+	uint8_t		a, b, c, d, *tbl_0, *tbl_1;
+
+	for (i = 0; i < 256; i++) {
+		a = (uint8_t)i;
+		for (j = 1; j < 256; j++) {
+			b = (uint8_t)j;
+			c = GF8mul(a, b);
+			d = GF8div(c, b);
+
+			if (d != i) {
+				printf("GF8test: d (%d) != i (%d)\n",
+					d, i);
+				printf("i = %d, j = %d, c = %d, d = %d\n",
+					i, j, c, d);
+				exit(1);
+			}
+		}
+	}
+
+	a = 0;
+	do {
+		// Test one step lookup region multiplication
+		tbl_0 = GF8crtRegTbl(a, 0);
+		for (i = 0; i < 256; i++) {
+			d = tbl_0[i];
+			if (d != GF8mul(a, i)) {
+				printf("GF8test: %d != GF8mul(%d, %d)\n",
+					d, a, i);
+				exit(1);
+			}
+		}
+		free(tbl_0);
+
+		// Test 4bit split table lookup region multiplication
+		tbl_0 = GF8crt4bitRegTbl(a, 0);
+		tbl_1 = tbl_0 + 16;
+		for (i = 0; i < 256; i++) {
+			d = tbl_1[i >> 4] ^ tbl_0[i & 0xf];
+			if (d != GF8mul(a, i)) {
+				printf("GF8test: %d != GF8mul(%d, %d)\n",
+					d, a, i);
+				exit(1);
+			}
+		}
+		free(tbl_0);
+
+		// Division
+		if (a) {
+			// Test one step lookup region division
+			tbl_0 = GF8crtRegTbl(a, 1);
+			for (i = 0; i < 256; i++) {
+				d = tbl_0[i];
+				if (d != GF8div(i, a)) {
+					printf("GF8test: %d != GF8div(%d, %d)"
+					       "\n", d, i, a);
+					exit(1);
+				}
+			}
+			free(tbl_0);
+
+			// Test 4bit split table lookup region division
+			tbl_0 = GF8crt4bitRegTbl(a, 1);
+			tbl_1 = tbl_0 + 16;
+			for (i = 0; i < 256; i++) {
+				d = tbl_1[i >> 4] ^ tbl_0[i & 0xf];
+				if (d != GF8div(i, a)) {
+					printf("GF8test: %d != GF8div(%d, %d)"
+					       "\n", d, i, a);
+					exit(1);
+				}
+			}
+			free(tbl_0);
+		}
+
+		a++;
+	} while (a);
+
+	puts("GF8test: Passed");
+}
+
+/**************************************************************************
+	16bit
+**************************************************************************/
+
+// Definitions for GF16
+// Define GF16_PRIM (e.g. cc -DGF16_PRIM=0x1002d) to use another one.
+#if !defined(GF16_PRIM)
+#define	GF16_PRIM	69643	// Prim poly: 0x1100b = x^16 + x^12 + x^3 + x +1
+#endif
+#define	GF16_SIZE	65536	// = 16bit 
+/*
+	For more primitive polynomials, see:
+	http://web.eecs.utk.edu/~plank/plank/papers/CS-07-593/primitive-polynomial-table.txt
+*/
+#if GF16_PRIM < 0x10000 || GF16_PRIM > 0x1ffff
+#error "GF16_PRIM must be a polynomial of degree 16"
+#endif
+
+#if defined(_GF_STATIC_TABLES_)
+// Tables generated by gf-gen.c in read-only memory (.rodata), so
+// GF16init() costs nothing and processes share them by page cache.
+#include "gf-tables.h"
+#if GF16_TABLES_PRIM != GF16_PRIM
+#error "gf-tables.h was generated for another GF16_PRIM (run gf-gen again)"
+#endif
+#if GF16_TABLES_COMPACT != defined(_GF16_COMPACT_)
+#error "gf-tables.h was generated with different _GF16_COMPACT_"
+#endif
+#endif
+
+// Quotient of x^32 / GF16_PRIM for GF16mulVec() (GF_VEC_CLMUL)
+static uint32_t	GF16clmulMu;
+
+// Default field (GF16memL, GF16memH and GF16memIdx)
+static GF16ctx	GF16ctxDef = { GF16_PRIM, NULL, NULL, NULL };
+
+// Number of entries of GF16memL and GF16memIdx
+#if defined(_GF16_COMPACT_)
+// Two periods of antilog without zero area
+// (+ 2 and + 1 entries for 32bit gathers of GF16mulVec())
+#define GF16_MEML_NUM	((GF16_SIZE - 1) * 2 + 2)
+#define GF16_MEMIDX_NUM	(GF16_SIZE + 1)
+#else
+#define GF16_MEML_NUM	(GF16_SIZE * 4)
+#define GF16_MEMIDX_NUM	GF16_SIZE
+#endif
+
+// Create log and antilog tables of GF(2^16) by prim in the layout of
+// GF16memL (antilogs) and GF16memIdx (logs)
+//
+// Return value:
+//     0 or -1 if prim is not primitive or failed
+//
+static int
+GF16crtLogTbl(uint32_t prim, uint16_t **memL_p, GF16idx **memIdx_p)
+{
+	int		i;
+	uint32_t	n;
+	uint16_t	*memL, *memH;
+	GF16idx		*memIdx;
+
+	// Allocate memory 
+	memL = (uint16_t *)malloc(sizeof(uint16_t) * GF16_MEML_NUM);
+	memIdx = (GF16idx *)malloc(sizeof(GF16idx) * GF16_MEMIDX_NUM);
+	if (memL == NULL || memIdx == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		goto err;
+	}
+	memH = memL + GF16_SIZE - 1; // Second half
+	memL[0] = n = 1;
+
+	// Set memL and memIdx
+	for (i = 0; i < GF16_SIZE - 1;) {
+		n <<= 1;
+		i++;
+		if (n >= GF16_SIZE) {
+			n ^= prim;
+		}
+		memL[i] = (uint16_t)n;
+		memIdx[n] = i;
+
+		// Period of x must be 65535
+		if ((n == 1) != (i == GF16_SIZE - 1) || n == 0) {
+			fprintf(stderr, "Error: %s: 0x%x is not primitive\n",
+				__func__, prim);
+			goto err;
+		}
+	}
+#if defined(_GF16_COMPACT_)
+	memIdx[0] = GF16_LOG0; // Sentinel (0 is checked by branch)
+#else
+	memIdx[0] = (GF16_SIZE << 1) - 1;
+#endif
+	memIdx[1] = 0;
+
+	// Copy first half of memL to second half
+	memcpy(memH, memL, sizeof(uint16_t) * (GF16_SIZE - 1));
+
+#if defined(_GF16_COMPACT_)
+	// Clear padding for gathers
+	memL[(GF16_SIZE - 1) * 2] = memL[(GF16_SIZE - 1) * 2 + 1] = 0;
+	memIdx[GF16_SIZE] = 0;
+#else
+	// Fill remaining space after memH with zero
+	memset(&memL[(GF16_SIZE << 1) - 2], 0,
+		sizeof(uint16_t) * ((GF16_SIZE << 1) + 2));
+#endif
+
+	*memL_p = memL;
+	*memIdx_p = memIdx;
+	return 0;
+
+err:
+	free(memL);
+	free(memIdx);
+	return -1;
+}
+
+// Set up the default field after GF16memL and GF16memIdx are set
+static void
+GF16initDef(void)
+{
+	int		i;
+	uint64_t	r;
+
+	// Quotient of x^32 / GF16_PRIM
+	GF16clmulMu = 0;
+	r = (uint64_t)1 << 32;
+	for (i = 16; i >= 0; i--) {
+		if (r & ((uint64_t)1 << (i + 16))) {
+			GF16clmulMu |= 1 << i;
+			r ^= (uint64_t)GF16_PRIM << i;
+		}
+	}
+
+	GF16memH = GF16memL + GF16_SIZE - 1; // Second half
+	GF16ctxDef.memL = GF16memL;
+	GF16ctxDef.memH = GF16memH;
+	GF16ctxDef.memIdx = GF16memIdx;
+
+	// Select region kernels
+	GFinitSIMD();
+}
+
+// Initialize 16bit GF
+void
+GF16init(void)
+{
+#if defined(_GF_STATIC_TABLES_)
+	// Use generated tables (never written)
+	GF16memL = (uint16_t *)GF16memLtbl;
+	GF16memIdx = (GF16idx *)GF16memIdxTbl;
+#else
+	// Set GF16memL and GF16memIdx
+	GF16crtLogTbl(GF16_PRIM, &GF16memL, &GF16memIdx);
+#endif
+	GF16initDef();
+}
+
+// Create field instance of GF(2^16) with primitive polynomial prim such
+// as 0x1002d (x^16 + x^5 + x^3 + x^2 + 1) independent of GF16_PRIM
+// Tables are as large as the default ones (768kB or 384kB with
+// _GF16_COMPACT_). Region functions with Ctx build their 4bit tables
+// from them and run the same kernels as the default field.
+//
+// Args:
+//     prim: primitive polynomial of degree 16 (0x10000 - 0x1ffff)
+//
+// Return value:
+//     pointer to field or NULL if failed. Free it by GF16freeCtx().
+//
+// Usage:
+//     GF16ctx *gf = GF16crtCtx(0x1002d);
+//     c = GF16mulCtx(gf, a, b);
+//     GF16mulRegionCtx(gf, (uint8_t *)y, (uint8_t *)x, len, a);
+//     GF16freeCtx(gf);
+//
+GF16ctx *
+GF16crtCtx(uint32_t prim)
+{
+	GF16ctx	*ctx;
+
+	// Check prim
+	if (prim < GF16_SIZE || prim >= GF16_SIZE << 1) {
+		fprintf(stderr, "Error: %s: Illegal polynomial: 0x%x "
+			"(degree must be 16)\n", __func__, prim);
+		return NULL;
+	}
+
+	if ((ctx = (GF16ctx *)malloc(sizeof(GF16ctx))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	if (GF16crtLogTbl(prim, &ctx->memL, &ctx->memIdx) < 0) {
+		free(ctx);
+		return NULL;
+	}
+	ctx->memH = ctx->memL + GF16_SIZE - 1;
+	ctx->prim = prim;
+
+	// Select region kernels if GF16init() hasn't
+	GFinitSIMD();
+
+	return ctx;
+}
+
+// Free field instance created by GF16crtCtx()
+void
+GF16freeCtx(GF16ctx *ctx)
+{
+	if (ctx == NULL) {
+		return;
+	}
+	free(ctx->memL);
+	free(ctx->memIdx);
+	free(ctx);
+}
+
+// Copy field instance (NULL: default field of GF16init()) to new memory
+// Same as GF8dupCtx() (the pages are placed on the node of the caller).
+//
+// Return value:
+//     pointer to copy or NULL if failed. Free it by GF16freeCtx().
+//
+GF16ctx *
+GF16dupCtx(const GF16ctx *src)
+{
+	GF16ctx	*ctx;
+
+	if (src == NULL) {
+		src = &GF16ctxDef;
+	}
+	if (src->memL == NULL) {
+		fprintf(stderr, "Error: %s: Field is not initialized\n",
+			__func__);
+		return NULL;
+	}
+
+	if ((ctx = (GF16ctx *)malloc(sizeof(GF16ctx))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	ctx->memL = (uint16_t *)malloc(sizeof(uint16_t) * GF16_MEML_NUM);
+	ctx->memIdx = (GF16idx *)malloc(sizeof(GF16idx) * GF16_MEMIDX_NUM);
+	if (ctx->memL == NULL || ctx->memIdx == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		GF16freeCtx(ctx);
+		return NULL;
+	}
+	memcpy(ctx->memL, src->memL, sizeof(uint16_t) * GF16_MEML_NUM);
+	memcpy(ctx->memIdx, src->memIdx, sizeof(GF16idx) * GF16_MEMIDX_NUM);
+	ctx->memH = ctx->memL + GF16_SIZE - 1;
+	ctx->prim = src->prim;
+
+	return ctx;
+}
+
+/******************** For regional calculation ********************/ 
+
+// a_addr[GF16memIdx[x]] where a_addr is GF16memL + GF16memIdx[a] (a * x)
+// or GF16memH - GF16memIdx[a] (x / a)
+// The compact tables have no zero area, so a, x == 0 are checked.
+// GF16lkupAddrIdx() is the same with logs idx of another field.
+#if defined(_GF16_COMPACT_)
+#define GF16lkupAddrIdx(idx, a_addr, a, x)	\
+		(((a) == 0 || (x) == 0) ? 0 : (a_addr)[(idx)[(x)]])
+#else
+#define GF16lkupAddrIdx(idx, a_addr, a, x)	((a_addr)[(idx)[(x)]])
+#endif
+#define GF16lkupAddr(a_addr, a, x)	\
+		GF16lkupAddrIdx(GF16memIdx, a_addr, a, x)
+
+// Create table for regional calculation such as:
+//     a * x[i]
+//     x[i] / a
+// This method may fit L2 cache and will be fast.
+//
+// Args:
+//     a: static value in regional calculation (or coefficient)
+//     type: 0: a * x[i]
+//           1: x[i] / a
+//
+// Return value:
+//     pointer to table or NULL if failed. Free it later.
+//
+// How to use:
+//    For a * x[i],
+//        uint16_t *gf_a = GF16crtRegTbl(a, 0);
+//        for (i = 0; i < N; i++) {
+//            y[i] = gf_a[x[i]]; // This is equal to GFmul(a, x[i]);
+//            // Or use y[i] = GF16LkupRT(gf_a, x[i]);
+//        }
+//        free(gf_a);
+//
+//    For x[i] / a,
+//        uint16_t *gf_a = GF16crtRegTbl(a, 1);
+//        for (i = 0; i < N; i++) {
+//            y[i] = gf_a[x[i]]; // This is equal to GFdiv(x[i], a);
+//            // Or use y[i] = GF16LkupRT(gf_a, x[i]);
+//        }
+//        free(gf_a);
+//
+uint16_t *
+GF16crtRegTbl(uint16_t a, int type)
+{
+	int		i;
+	uint16_t	*table = NULL, *a_addr;
+
+	// Allocate table
+	if ((table = (uint16_t *)
+			aligned_alloc(64, GF16_SIZE * sizeof(uint16_t)))
+				== NULL) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;	
+	}
+
+	// Input values
+	switch (type) {
+	case 0: // a * x[i]
+		a_addr = GF16memL + GF16memIdx[a];
+
+		// Input values
+		for (i = 0; i < GF16_SIZE; i++) {
+			table[i] = GF16lkupAddr(a_addr, a, i);
+		}
+		break;
+
+	case 1: // x[i] / a
+		a_addr = GF16memH - GF16memIdx[a];
+
+		// Input values
+		for (i = 0; i < GF16_SIZE; i++) {
+			table[i] = GF16lkupAddr(a_addr, a, i);
+		}
+		break;
+
+	default:
+		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
+			"(value must be 0, 1, or 2)\n",
+			__func__, type);
+		free(table);
+		return NULL;
+	}
+
+	return table;
+}
+
+// Create 8bit split tables for regional calculation such as:
+//     a * x[i]
+//     x[i] / a
+// This method may fit L1 cache and will be even faster.
+//
+// Args:
+//     a: static value in regional calculation (or coefficient)
+//     type: 0: a * x[i]
+//           1: x[i] / a
+//
+// Return value:
+//     pointer to lowest byte table or NULL if failed. Free it later.
+//
+// How to use:
+//    For a * x[i],
+//        uint16_t *gf_a_l = GF16crtSpltRegTbl(a, 0);
+//        uint16_t *gf_a_h = gf_a_l + 256;
+//        uint16_t xi;
+//        for (i = 0; i < N; i++) {
+//            xi = x[i];
+//            y[i] = gf_a_h[xi >> 8] ^ gf_a_l[xi & 0xff]; // = GFmul(a, x[i]);
+//            // Or use y[i] = GF16LkupSRT(gf_a_l, gf_a_h, xi);
+//        }
+//        free(gf_a_l);
+//
+//    For x[i] / a,
+//        uint16_t *gf_a_l = GF16crtSpltRegTbl(a, 1);
+//        uint16_t *gf_a_h = gf_a_l + 256;
+//        uint16_t xi;
+//        for (i = 0; i < N; i++) {
+//            xi = x[i];
+//            y[i] = gf_a_h[xi >> 8] ^ gf_a_l[xi & 0xff]; // = GFdiv(x[i], a);
+//            // Or use y[i] = GF16LkupSRT(gf_a_l, gf_a_h, xi);
+//        }
+//        free(gf_a_l);
+//
+uint16_t *
+GF16crtSpltRegTbl(uint16_t a, int type)
+{
+	int		i;
+	uint16_t	*tb_h, *tb_l, *a_addr;
+
+	// Initialize
+	tb_l = NULL;
+
+	// Allocate table
+	if ((tb_l = (uint16_t *)
+			aligned_alloc(64, 256 * sizeof(uint16_t) * 2))
+				== NULL) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	tb_h = tb_l + 256;
+	memset(tb_l, 0, 256 * sizeof(uint16_t) * 2);
+
+	// Input values
+	switch (type) {
+	case 0: // a * x[i]
+		a_addr = GF16memL + GF16memIdx[a];
+
+		// Input values
+		for (i = 0; i < 256; i++) {
+			tb_l[i] = GF16lkupAddr(a_addr, a, i);
+			tb_h[i] = GF16lkupAddr(a_addr, a, i << 8);
+		}
+		break;
+
+	case 1: // x[i] / a
+		a_addr = GF16memH - GF16memIdx[a];
+
+		// Input values
+		for (i = 0; i < 256; i++) {
+			tb_l[i] = GF16lkupAddr(a_addr, a, i);
+			tb_h[i] = GF16lkupAddr(a_addr, a, i << 8);
+		}
+		break;
+
+	default:
+		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
+			"(value must be 0, 1, or 2)\n",
+			__func__, type);
+		free(tb_l);
+		return NULL;
+	}
+
+	return tb_l;
+}
+
+// Builders of 4bit split tables without allocation
+// With SIMD, tables are derived from 16 basis products a * 2^j
+// (j = 0, ..., 15) by XOR, as a * x = XOR of a * 2^j for each bit j of x,
+// so no table lookup is needed (except 1 / a for x[i] / a).
+// Without SIMD, 64 lookups in the 768kB tables are faster than that.
+// Each 16 byte row (tb_n_l or tb_n_h) is written rep times for 128, 256
+// or 512bit SIMD.
+
+// No SIMD: lookups
+static void
+GF16set4bitRowsNone(const GF16ctx *ctx, uint8_t *tb, uint16_t a, int type,
+		    int rep)
+{
+	int		i, n, w;
+	uint16_t	*a_addr, tmp;
+	const GF16idx	*idx = ctx->memIdx;
+
+	// a * x[i] or x[i] / a
+	a_addr = type ? ctx->memH - idx[a] : ctx->memL + idx[a];
+	w = rep << 4; // Width of row
+
+	// Input values
+	for (i = 0; i < 16; i++) {
+		tmp = GF16lkupAddrIdx(idx, a_addr, a, i);
+		for (n = i; n < w; n += 16) {
+			tb[n] = tmp & 0xff;
+			tb[w + n] = tmp >> 8;
+		}
+		tmp = GF16lkupAddrIdx(idx, a_addr, a, i << 4);
+		for (n = i; n < w; n += 16) {
+			tb[w * 2 + n] = tmp & 0xff;
+			tb[w * 3 + n] = tmp >> 8;
+		}
+		tmp = GF16lkupAddrIdx(idx, a_addr, a, i << 8);
+		for (n = i; n < w; n += 16) {
+			tb[w * 4 + n] = tmp & 0xff;
+			tb[w * 5 + n] = tmp >> 8;
+		}
+		tmp = GF16lkupAddrIdx(idx, a_addr, a, i << 12);
+		for (n = i; n < w; n += 16) {
+			tb[w * 6 + n] = tmp & 0xff;
+			tb[w * 7 + n] = tmp >> 8;
+		}
+	}
+}
+
+#if defined(_GF_X86_)
+// SSSE3: entries of a row are the basis broadcast by pshufb and masked
+// by bits of entry number
+GF_TARGET("ssse3") static void
+GF16set4bitRowsSSSE3(uint8_t *tb, const uint8_t *bl, const uint8_t *bh,
+		     int rep)
+{
+	int		j, k, h, n;
+	const __m128i	idx = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+					    8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i		mask[4], src[2], bit, v;
+
+	// mask[j]: 0xff at entries with bit j
+	for (j = 0; j < 4; j++) {
+		bit = _mm_set1_epi8(1 << j);
+		mask[j] = _mm_cmpeq_epi8(_mm_and_si128(idx, bit), bit);
+	}
+	src[0] = _mm_loadu_si128((const __m128i *)bl);
+	src[1] = _mm_loadu_si128((const __m128i *)bh);
+
+	for (k = 0; k < 4; k++) {
+		for (h = 0; h < 2; h++) {
+			v = _mm_setzero_si128();
+			for (j = 0; j < 4; j++) {
+				v = _mm_xor_si128(v, _mm_and_si128(mask[j],
+					_mm_shuffle_epi8(src[h],
+						_mm_set1_epi8((k << 2) + j))));
+			}
+			for (n = 0; n < rep; n++) {
+				_mm_storeu_si128((__m128i *)(tb +
+					(((k << 1) + h) * rep + n) * 16), v);
+			}
+		}
+	}
+}
+#elif defined(_arm64_) // NEON
+// NEON: same as SSSE3 with tbl
+static void
+GF16set4bitRowsNEON(uint8_t *tb, const uint8_t *bl, const uint8_t *bh,
+		    int rep)
+{
+	int		j, k, h, n;
+	static const uint8_t	idx_v[16] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+	};
+	uint8x16_t	idx, mask[4], src[2], v;
+
+	// mask[j]: 0xff at entries with bit j
+	idx = vld1q_u8(idx_v);
+	for (j = 0; j < 4; j++) {
+		mask[j] = vtstq_u8(idx, vdupq_n_u8(1 << j));
+	}
+	src[0] = vld1q_u8(bl);
+	src[1] = vld1q_u8(bh);
+
+	for (k = 0; k < 4; k++) {
+		for (h = 0; h < 2; h++) {
+			v = vdupq_n_u8(0);
+			for (j = 0; j < 4; j++) {
+				v = veorq_u8(v, vandq_u8(mask[j],
+					vqtbl1q_u8(src[h],
+						   vdupq_n_u8((k << 2) + j))));
+			}
+			for (n = 0; n < rep; n++) {
+				vst1q_u8(tb + (((k << 1) + h) * rep + n) * 16,
+					 v);
+			}
+		}
+	}
+}
+#endif
+
+// Fill 4bit split tables of field ctx with each row repeated rep times
+static void
+GF16set4bitRows(const GF16ctx *ctx, uint8_t *tb, uint16_t a, int type,
+		int rep)
+{
+	int		j;
+	uint32_t	n;
+	uint8_t		bl[16], bh[16];
+
+	// No SIMD
+	if (GFsimd <= GF_SIMD_NONE) {
+		GF16set4bitRowsNone(ctx, tb, a, type, rep);
+		return;
+	}
+
+	// Basis a * 2^j (x[i] / a = (1 / a) * x[i])
+	n = type ? GF16divCtx(ctx, 1, a) : a;
+	for (j = 0; j < 16; j++) {
+		bl[j] = n & 0xff;
+		bh[j] = n >> 8;
+		n <<= 1;
+		if (n >= GF16_SIZE) {
+			n ^= ctx->prim;
+		}
+	}
+
+	// Derive tables
+#if defined(_GF_X86_) // All x86 SIMD levels have SSSE3
+	GF16set4bitRowsSSSE3(tb, bl, bh, rep);
+#elif defined(_arm64_)
+	GF16set4bitRowsNEON(tb, bl, bh, rep);
+#endif
+}
+
+// Fill 4bit split tables of GF16crt4bitRegTbl() (128 bytes) into tb
+// without allocation. With SIMD, nothing is looked up in the 768kB
+// tables, so this is fast enough for coefficients changing every packet.
+// The table is copied from the bank if GF16init4bitBank() was called.
+//
+// Args:
+//     tb: 128 bytes (aligned to 16 bytes for SIMD use)
+//     a: static value in regional calculation (or coefficient)
+//     type: 0: a * x[i]
+//           1: x[i] / a
+//
+// Usage:
+//     _Alignas(64) uint8_t gf_tb[128];
+//     GF16set4bitRegTbl(gf_tb, a, 0); // Instead of GF16crt4bitRegTbl()
+//     GF16lkupRegionXor(gf_tb, (uint8_t *)x, (uint8_t *)y, len);
+//
+void
+GF16set4bitRegTbl(uint8_t *tb, uint16_t a, int type)
+{
+	GF16set4bitRegTblCtx(&GF16ctxDef, tb, a, type);
+}
+
+// Same as GF16set4bitRegTbl() but in field ctx created by GF16crtCtx()
+// The tables are used by GF16lkupRegion() etc. as usual.
+void
+GF16set4bitRegTblCtx(const GF16ctx *ctx, uint8_t *tb, uint16_t a, int type)
+{
+	// The bank is of the default field
+	if (ctx == &GF16ctxDef && GF16bank4bit != NULL) {
+		memcpy(tb, GF16get4bitBank(type ? GF16div(1, a) : a), 128);
+		return;
+	}
+	GF16set4bitRows(ctx, tb, a, type, 1);
+}
+
+// Same as GF16set4bitRegTbl() but of GF16crt4bitRegTbl256() (256 bytes)
+void
+GF16set4bitRegTbl256(uint8_t *tb, uint16_t a, int type)
+{
+	GF16set4bitRows(&GF16ctxDef, tb, a, type, 2);
+}
+
+// Same as GF16set4bitRegTbl() but of GF16crt4bitRegTbl512() (512 bytes)
+void
+GF16set4bitRegTbl512(uint8_t *tb, uint16_t a, int type)
+{
+	GF16set4bitRows(&GF16ctxDef, tb, a, type, 4);
+}
+
+// Create 4bit split tables for regional calculation such as:
+//     a * x[i]
+//     x[i] / a
+// This is basically used with SIMD (SSE/NEON).
+//
+// Args:
+//     a: static value in regional calculation (or coefficient)
+//     type: 0: a * x[i]
+//           1: x[i] / a
+//
+// Return value:
+//     pointer to lowest table or NULL if failed. Free it later.
+//
+// Usage:
+//     use with GF16lkupSIMD128x2 in gf.h.
+//     See gf-bench/multiplication/gf-nishida-region-16/gf-bench*.c
+//     for more details.
+//
+uint8_t *
+GF16crt4bitRegTbl(uint16_t a, int type)
+{
+	uint8_t		*tb;
+
+	// Check type
+	if (type != 0 && type != 1) {
+		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
+			"(value must be 0 or 1)\n",
+			__func__, type);
+		return NULL;
+	}
+
+	// Allocate table
+	if ((tb = (uint8_t *)aligned_alloc(64, 128)) == NULL) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+
+	// Input values
+	GF16set4bitRows(&GF16ctxDef, tb, a, type, 1);
+
+	return tb;
+}
+
+// Same as GF16crt4bitRegTbl() but for 256bit SIMD like AVX
+//
+// Args:
+//     a: static value in regional calculation (or coefficient)
+//     type: 0: a * x[i]
+//           1: x[i] / a
+//
+// Return value:
+//     pointer to lowest table or NULL if failed. Free it later.
+//
+// Usage:
+//     use with GF16lkupSIMD256x2 in gf.h.
+//     See gf-bench/multiplication/gf-nishida-region-16/gf-bench*.c
+//     for more details.
+//
+uint8_t *
+GF16crt4bitRegTbl256(uint16_t a, int type)
+{
+	uint8_t		*tb;
+
+	// Check type
+	if (type != 0 && type != 1) {
+		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
+			"(value must be 0 or 1)\n",
+			__func__, type);
+		return NULL;
+	}
+
+	// Allocate table
+	if ((tb = (uint8_t *)aligned_alloc(64, 256)) == NULL) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+
+	// Input values
+	GF16set4bitRegTbl256(tb, a, type);
+
+	return tb;
+}
+
+// Same as GF16crt4bitRegTbl() but for 512bit SIMD like AVX-512
+//
+// Args:
+//     a: static value in regional calculation (or coefficient)
+//     type: 0: a * x[i]
+//           1: x[i] / a
+//
+// Return value:
+//     pointer to lowest table or NULL if failed. Free it later.
+//
+// Usage:
+//     use with GF16lkupSIMD512x2 in gf.h.
+//     See gf-bench/multiplication/gf-nishida-region-16/gf-bench*.c
+//     for more details.
+//
+uint8_t *
+GF16crt4bitRegTbl512(uint16_t a, int type)
+{
+	uint8_t		*tb;
+
+	// Check type
+	if (type != 0 && type != 1) {
+		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
+			"(value must be 0 or 1)\n",
+			__func__, type);
+		return NULL;
+	}
+
+	// Allocate table
+	if ((tb = (uint8_t *)aligned_alloc(64, 512)) == NULL) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+
+	// Input values
+	GF16set4bitRegTbl512(tb, a, type);
+
+	return tb;
+}
+
+/******************** Region drivers ********************/ 
+
+// Get four 8x8 bit matrices of GFNI from 4bit split tables
+// a * 2^j (j = 0, ..., 15) are in tb_n_l and tb_n_h (n = j / 4) at
+// index 1 << (j % 4). mtx[] is ll, lh, hl, hh where mtx_XY maps byte Y
+// (l: low, h: high) of input to byte X of output.
+static void
+GF16affineMtx4bit(const uint8_t *gf_tb, uint64_t *mtx)
+{
+	int	j, idx;
+	uint8_t	col_ll[8], col_lh[8], col_hl[8], col_hh[8];
+
+	for (j = 0; j < 8; j++) {
+		idx = 1 << (j & 3);
+		col_ll[j] = gf_tb[((j >> 2) << 5) + idx];
+		col_hl[j] = gf_tb[((j >> 2) << 5) + 16 + idx];
+		col_lh[j] = gf_tb[(((j >> 2) + 2) << 5) + idx];
+		col_hh[j] = gf_tb[(((j >> 2) + 2) << 5) + 16 + idx];
+	}
+
+	mtx[0] = GF8affineMtx(col_ll);
+	mtx[1] = GF8affineMtx(col_lh);
+	mtx[2] = GF8affineMtx(col_hl);
+	mtx[3] = GF8affineMtx(col_hh);
+}
+
+// Create matrix tables for GFNI (64 * 4 = 256 bytes)
+// Multiplication by a (or 1 / a) in GF(2^16) is split into four 8x8 bit
+// matrices, ll, lh, hl and hh, each repeated 8 times (64 bytes).
+//
+// Args:
+//     a: multiplier or divisor
+//     type: 0: y[i] = a * x[i], 1: y[i] = x[i] / a
+//
+// Return value:
+//     pointer to lowest table or NULL if failed. Free it later.
+//
+// Usage:
+//     use with GF16affineSIMD256x2 or GF16affineSIMD512x2 in gf.h.
+//     See gf-bench/multiplication/gf-nishida-region-16/gf-bench.c
+//     for more details.
+//
+uint64_t *
+GF16crtAffineTbl(uint16_t a, int type)
+{
+	int		i, j;
+	uint8_t		gf_tb[128];
+	uint64_t	*tb, mtx[4];
+
+	// Check type
+	if (type != 0 && type != 1) {
+		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
+			"(value must be 0 or 1)\n",
+			__func__, type);
+		return NULL;
+	}
+
+	// Allocate table
+	if ((tb = (uint64_t *)aligned_alloc(64, 64 * 4)) == NULL) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+
+	// Create matrices from a * 2^j
+	GF16set4bitRegTbl(gf_tb, a, type);
+	GF16affineMtx4bit(gf_tb, mtx);
+
+	// Input values
+	for (i = 0; i < 4; i++) {
+		for (j = 0; j < 8; j++) {
+			tb[(i << 3) + j] = mtx[i];
+		}
+	}
+
+	return tb;
+}
+
+// Process 16bit words of region one by one with 4bit tables
+// Used for unaligned heads and tails of GF16lkupRegionBody().
+static inline void
+GF16lkupRegionScalar(const uint8_t *gf_tb, const uint8_t *input,
+		     uint8_t *output, size_t len, int xor)
+{
+	uint16_t	x;
+
+	for (; len >= 2; len -= 2) {
+		x = input[0] | (input[1] << 8);
+		x = GF16Lkup4bitRT(gf_tb, x);
+		if (xor) {
+			output[0] ^= x & 0xff;
+			output[1] ^= x >> 8;
+		}
+		else {
+			output[0] = x & 0xff;
+			output[1] = x >> 8;
+		}
+		input += 2;
+		output += 2;
+	}
+}
+
+// Region kernels for each SIMD instruction set
+// They process as many bytes as fit SIMD registers and return the number
+// of bytes processed. xor: 0: y[i] = a * x[i], 1: y[i] ^= a * x[i]
+
+// No SIMD
+static size_t
+GF16lkupRegionNone(const uint8_t *gf_tb, const uint8_t *input,
+		   uint8_t *output, size_t len, int xor)
+{
+	return 0;
+}
+
+#if defined(_GF_X86_)
+// SSSE3 -- every 32 bytes
+GF_TARGET("ssse3") static size_t
+GF16lkupRegionSSSE3(const uint8_t *gf_tb, const uint8_t *input,
+		    uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m128i	tb_a_0_l, tb_a_0_h, tb_a_1_l, tb_a_1_h;
+	__m128i	tb_a_2_l, tb_a_2_h, tb_a_3_l, tb_a_3_h;
+
+	// Load tables
+	tb_a_0_l = _mm_loadu_si128((__m128i *)(gf_tb + 0));
+	tb_a_0_h = _mm_loadu_si128((__m128i *)(gf_tb + 16));
+	tb_a_1_l = _mm_loadu_si128((__m128i *)(gf_tb + 32));
+	tb_a_1_h = _mm_loadu_si128((__m128i *)(gf_tb + 48));
+	tb_a_2_l = _mm_loadu_si128((__m128i *)(gf_tb + 64));
+	tb_a_2_h = _mm_loadu_si128((__m128i *)(gf_tb + 80));
+	tb_a_3_l = _mm_loadu_si128((__m128i *)(gf_tb + 96));
+	tb_a_3_h = _mm_loadu_si128((__m128i *)(gf_tb + 112));
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 128 * 2bit
+		if (xor) {
+			GF16lkupSIMD128x2Xor(tb_a_0_l, tb_a_0_h,
+					     tb_a_1_l, tb_a_1_h,
+					     tb_a_2_l, tb_a_2_h,
+					     tb_a_3_l, tb_a_3_h,
+					     input + n, output + n);
+		}
+		else {
+			GF16lkupSIMD128x2(tb_a_0_l, tb_a_0_h,
+					  tb_a_1_l, tb_a_1_h,
+					  tb_a_2_l, tb_a_2_h,
+					  tb_a_3_l, tb_a_3_h,
+					  input + n, output + n);
+		}
+	}
+
+	return n;
+}
+
+// AVX2 -- every 64 bytes
+GF_TARGET("avx2") static size_t
+GF16lkupRegionAVX2(const uint8_t *gf_tb, const uint8_t *input,
+		   uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m256i	tb_a_0_l, tb_a_0_h, tb_a_1_l, tb_a_1_h;
+	__m256i	tb_a_2_l, tb_a_2_h, tb_a_3_l, tb_a_3_h;
+
+	// Broadcast 128bit tables to both lanes
+	tb_a_0_l = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 0)));
+	tb_a_0_h = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 16)));
+	tb_a_1_l = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 32)));
+	tb_a_1_h = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 48)));
+	tb_a_2_l = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 64)));
+	tb_a_2_h = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 80)));
+	tb_a_3_l = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 96)));
+	tb_a_3_h = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(gf_tb + 112)));
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 256 * 2bit
+		if (xor) {
+			GF16lkupSIMD256x2Xor(tb_a_0_l, tb_a_0_h,
+					     tb_a_1_l, tb_a_1_h,
+					     tb_a_2_l, tb_a_2_h,
+					     tb_a_3_l, tb_a_3_h,
+					     input + n, output + n);
+		}
+		else {
+			GF16lkupSIMD256x2(tb_a_0_l, tb_a_0_h,
+					  tb_a_1_l, tb_a_1_h,
+					  tb_a_2_l, tb_a_2_h,
+					  tb_a_3_l, tb_a_3_h,
+					  input + n, output + n);
+		}
+	}
+
+	// Remaining 32 bytes
+	return n + GF16lkupRegionSSSE3(gf_tb, input + n, output + n,
+				       len - n, xor);
+}
+
+// AVX-512BW -- every 128 bytes
+GF_TARGET("avx512f,avx512bw") static size_t
+GF16lkupRegionAVX512(const uint8_t *gf_tb, const uint8_t *input,
+		     uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+	__m512i	tb_a_0_l, tb_a_0_h, tb_a_1_l, tb_a_1_h;
+	__m512i	tb_a_2_l, tb_a_2_h, tb_a_3_l, tb_a_3_h;
+
+	// Broadcast 128bit tables to all lanes
+	tb_a_0_l = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 0)));
+	tb_a_0_h = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 16)));
+	tb_a_1_l = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 32)));
+	tb_a_1_h = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 48)));
+	tb_a_2_l = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 64)));
+	tb_a_2_h = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 80)));
+	tb_a_3_l = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 96)));
+	tb_a_3_h = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(gf_tb + 112)));
+
+	for (n = 0; n + 128 <= len; n += 128) { // Do every 512 * 2bit
+		if (xor) {
+			GF16lkupSIMD512x2Xor(tb_a_0_l, tb_a_0_h,
+					     tb_a_1_l, tb_a_1_h,
+					     tb_a_2_l, tb_a_2_h,
+					     tb_a_3_l, tb_a_3_h,
+					     input + n, output + n);
+		}
+		else {
+			GF16lkupSIMD512x2(tb_a_0_l, tb_a_0_h,
+					  tb_a_1_l, tb_a_1_h,
+					  tb_a_2_l, tb_a_2_h,
+					  tb_a_3_l, tb_a_3_h,
+					  input + n, output + n);
+		}
+	}
+
+	// Remaining 96 bytes
+	return n + GF16lkupRegionAVX2(gf_tb, input + n, output + n,
+				      len - n, xor);
+}
+
+// AVX2 + GFNI -- every 64 bytes
+GF_TARGET("gfni,avx2") static size_t
+GF16affineRegionAVX2(const uint8_t *gf_tb, const uint8_t *input,
+		     uint8_t *output, size_t len, int xor)
+{
+	size_t		n;
+	uint64_t	mtx[4];
+	__m256i		mtx_a_ll, mtx_a_lh, mtx_a_hl, mtx_a_hh;
+
+	// Broadcast matrices to all 64bit
+	GF16affineMtx4bit(gf_tb, mtx);
+	mtx_a_ll = _mm256_set1_epi64x((long long)mtx[0]);
+	mtx_a_lh = _mm256_set1_epi64x((long long)mtx[1]);
+	mtx_a_hl = _mm256_set1_epi64x((long long)mtx[2]);
+	mtx_a_hh = _mm256_set1_epi64x((long long)mtx[3]);
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 256 * 2bit
+		if (xor) {
+			GF16affineSIMD256x2Xor(mtx_a_ll, mtx_a_lh,
+					       mtx_a_hl, mtx_a_hh,
+					       input + n, output + n);
+		}
+		else {
+			GF16affineSIMD256x2(mtx_a_ll, mtx_a_lh,
+					    mtx_a_hl, mtx_a_hh,
+					    input + n, output + n);
+		}
+	}
+
+	// Remaining 32 bytes
+	return n + GF16lkupRegionSSSE3(gf_tb, input + n, output + n,
+				       len - n, xor);
+}
+
+// AVX-512BW + GFNI -- every 128 bytes
+GF_TARGET("gfni,avx512f,avx512bw") static size_t
+GF16affineRegionAVX512(const uint8_t *gf_tb, const uint8_t *input,
+		       uint8_t *output, size_t len, int xor)
+{
+	size_t		n;
+	uint64_t	mtx[4];
+	__m512i		mtx_a_ll, mtx_a_lh, mtx_a_hl, mtx_a_hh;
+
+	// Broadcast matrices to all 64bit
+	GF16affineMtx4bit(gf_tb, mtx);
+	mtx_a_ll = _mm512_set1_epi64((long long)mtx[0]);
+	mtx_a_lh = _mm512_set1_epi64((long long)mtx[1]);
+	mtx_a_hl = _mm512_set1_epi64((long long)mtx[2]);
+	mtx_a_hh = _mm512_set1_epi64((long long)mtx[3]);
+
+	for (n = 0; n + 128 <= len; n += 128) { // Do every 512 * 2bit
+		if (xor) {
+			GF16affineSIMD512x2Xor(mtx_a_ll, mtx_a_lh,
+					       mtx_a_hl, mtx_a_hh,
+					       input + n, output + n);
+		}
+		else {
+			GF16affineSIMD512x2(mtx_a_ll, mtx_a_lh,
+					    mtx_a_hl, mtx_a_hh,
+					    input + n, output + n);
+		}
+	}
+
+	// Remaining 96 bytes
+	return n + GF16affineRegionAVX2(gf_tb, input + n, output + n,
+					len - n, xor);
+}
+#elif defined(_arm64_) // NEON
+// NEON -- every 32 bytes
+static size_t
+GF16lkupRegionNEON(const uint8_t *gf_tb, const uint8_t *input,
+		   uint8_t *output, size_t len, int xor)
+{
+	size_t		n;
+	uint8x16_t	tb_a_0_l, tb_a_0_h, tb_a_1_l, tb_a_1_h;
+	uint8x16_t	tb_a_2_l, tb_a_2_h, tb_a_3_l, tb_a_3_h;
+
+	// Load tables
+	tb_a_0_l = vld1q_u8(gf_tb + 0);
+	tb_a_0_h = vld1q_u8(gf_tb + 16);
+	tb_a_1_l = vld1q_u8(gf_tb + 32);
+	tb_a_1_h = vld1q_u8(gf_tb + 48);
+	tb_a_2_l = vld1q_u8(gf_tb + 64);
+	tb_a_2_h = vld1q_u8(gf_tb + 80);
+	tb_a_3_l = vld1q_u8(gf_tb + 96);
+	tb_a_3_h = vld1q_u8(gf_tb + 112);
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 128 * 2bit
+		if (xor) {
+			GF16lkupSIMD128x2Xor(tb_a_0_l, tb_a_0_h,
+					     tb_a_1_l, tb_a_1_h,
+					     tb_a_2_l, tb_a_2_h,
+					     tb_a_3_l, tb_a_3_h,
+					     input + n, output + n);
+		}
+		else {
+			GF16lkupSIMD128x2(tb_a_0_l, tb_a_0_h,
+					  tb_a_1_l, tb_a_1_h,
+					  tb_a_2_l, tb_a_2_h,
+					  tb_a_3_l, tb_a_3_h,
+					  input + n, output + n);
+		}
+	}
+
+	return n;
+}
+#endif
+
+// Region kernel selected by GFsetSIMD()
+static size_t	(*GF16lkupRegionSIMD)(const uint8_t *, const uint8_t *,
+				      uint8_t *, size_t, int)
+			= GF16lkupRegionNone;
+
+// Body of GF16lkupRegion() and GF16lkupRegionXor()
+// xor is constant and the branches are removed after inlining.
+static inline void
+GF16lkupRegionBody(const uint8_t *gf_tb, const uint8_t *input,
+		   uint8_t *output, size_t len, int xor)
+{
+	size_t	n;
+
+	// Align output for SIMD stores
+	// (impossible if output is at odd address)
+	n = (GFalign - ((uintptr_t)output & (GFalign - 1))) & (GFalign - 1);
+	if (len >= GFalign * 4 && !(n & 1)) {
+		GF16lkupRegionScalar(gf_tb, input, output, n, xor);
+		input += n;
+		output += n;
+		len -= n;
+	}
+
+	// SIMD
+	n = GF16lkupRegionSIMD(gf_tb, input, output, len, xor);
+	input += n;
+	output += n;
+	len -= n;
+
+	// Tail (odd byte at the end, if any, is left untouched)
+	GF16lkupRegionScalar(gf_tb, input, output, len, xor);
+}
+
+// Calculate a * x[i] over a whole region such as:
+//     y[i] = a * x[i]
+// The widest SIMD kernel available is used. Unaligned heads and the tail
+// that does not fill SIMD registers are processed by GF16Lkup4bitRT(),
+// so callers need not pad buffers to a multiple of 64 bytes.
+//
+// Args:
+//     gf_tb: tables created by GF16crt4bitRegTbl() (128 bytes)
+//     input: x[] (little endian uint16_t)
+//     output: y[] (little endian uint16_t)
+//     len: length of region in bytes (must be a multiple of 2)
+//
+// Usage:
+//     uint8_t *gf_tb = GF16crt4bitRegTbl(a, 0);
+//     GF16lkupRegion(gf_tb, (uint8_t *)x, (uint8_t *)y, len);
+//     free(gf_tb);
+//
+void
+GF16lkupRegion(const uint8_t *gf_tb, const uint8_t *input, uint8_t *output,
+	       size_t len)
+{
+	GF16lkupRegionBody(gf_tb, input, output, len, 0);
+}
+
+// Same as GF16lkupRegion() but XOR results into y[i] such as:
+//     y[i] ^= a * x[i]
+// This saves another pass over y[] in erasure coding (parity update).
+void
+GF16lkupRegionXor(const uint8_t *gf_tb, const uint8_t *input, uint8_t *output,
+		  size_t len)
+{
+	GF16lkupRegionBody(gf_tb, input, output, len, 1);
+}
+
+// Calculate dst[i] = a * src[i] over a whole buffer of len bytes
+// Tables are built on stack, so nothing is allocated per call.
+void
+GF16mulRegion(uint8_t *dst, const uint8_t *src, size_t len, uint16_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[128];
+
+	// Use the bank directly if built
+	if (GF16bank4bit != NULL) {
+		GF16lkupRegionBody(GF16get4bitBank(a), src, dst, len, 0);
+		return;
+	}
+
+	GF16set4bitRegTbl(gf_tb, a, 0);
+	GF16lkupRegionBody(gf_tb, src, dst, len, 0);
+}
+
+// Calculate dst[i] = src[i] / a over a whole buffer (a must not be 0)
+void
+GF16divRegion(uint8_t *dst, const uint8_t *src, size_t len, uint16_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[128];
+
+	// Use the bank directly if built
+	if (GF16bank4bit != NULL) {
+		GF16lkupRegionBody(GF16get4bitBank(GF16div(1, a)), src, dst,
+				   len, 0);
+		return;
+	}
+
+	GF16set4bitRegTbl(gf_tb, a, 1);
+	GF16lkupRegionBody(gf_tb, src, dst, len, 0);
+}
+
+// Calculate dst[i] ^= a * src[i] over a whole buffer
+void
+GF16mulAddRegion(uint8_t *dst, const uint8_t *src, size_t len, uint16_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[128];
+
+	// Use the bank directly if built
+	if (GF16bank4bit != NULL) {
+		GF16lkupRegionBody(GF16get4bitBank(a), src, dst, len, 1);
+		return;
+	}
+
+	GF16set4bitRegTbl(gf_tb, a, 0);
+	GF16lkupRegionBody(gf_tb, src, dst, len, 1);
+}
+
+// Same as GF16mulRegion() but in field ctx created by GF16crtCtx()
+// Only 128 byte tables depend on the field, so the kernels are as fast as
+// GF16mulRegion() (without the bank).
+void
+GF16mulRegionCtx(const GF16ctx *ctx, uint8_t *dst, const uint8_t *src,
+		 size_t len, uint16_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[128];
+
+	GF16set4bitRegTblCtx(ctx, gf_tb, a, 0);
+	GF16lkupRegionBody(gf_tb, src, dst, len, 0);
+}
+
+// Same as GF16divRegion() but in field ctx
+void
+GF16divRegionCtx(const GF16ctx *ctx, uint8_t *dst, const uint8_t *src,
+		 size_t len, uint16_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[128];
+
+	GF16set4bitRegTblCtx(ctx, gf_tb, a, 1);
+	GF16lkupRegionBody(gf_tb, src, dst, len, 0);
+}
+
+// Same as GF16mulAddRegion() but in field ctx
+void
+GF16mulAddRegionCtx(const GF16ctx *ctx, uint8_t *dst, const uint8_t *src,
+		    size_t len, uint16_t a)
+{
+	_Alignas(64) uint8_t	gf_tb[128];
+
+	GF16set4bitRegTblCtx(ctx, gf_tb, a, 0);
+	GF16lkupRegionBody(gf_tb, src, dst, len, 1);
+}
+
+/******************** Table bank ********************/
+
+// Build 4bit split tables of all coefficients a (a * x[i]) at once such as:
+//     GF16bank4bit[a * 128]: GF16crt4bitRegTbl(a, 0) (8MB)
+//     GF16bank4bit256[a * 256]: GF16crt4bitRegTbl256(a, 0) (16MB)
+// Tables are got by GF16get4bitBank(a) and GF16get4bitBank256(a) without
+// creation (use 1 / a for x[i] / a). GF16mulRegion(), GF16divRegion(),
+// GF16mulAddRegion(), GF16dotRegion() and GF16encodeRegion() use them too.
+// The banks are aligned to 2MB and advised to be backed by huge pages.
+// Call after GF16init() and before other threads use them.
+//
+// Args:
+//     flags: GF16_BANK_128 and/or GF16_BANK_256
+//
+// Return value:
+//     0 if succeeded, -1 if failed
+//
+int
+GF16init4bitBank(int flags)
+{
+	uint32_t	a;
+	int		i;
+	uint8_t		*bank, *bank256, *tb, *tb256;
+
+	// Check flags
+	if (flags & ~(GF16_BANK_128 | GF16_BANK_256) || flags == 0) {
+		fprintf(stderr, "Error: %s: Illegal flags: %d\n",
+			__func__, flags);
+		return -1;
+	}
+
+	// Free old banks
+	GF16free4bitBank();
+
+	// Allocate banks (128B tables are always built)
+	bank = bank256 = NULL;
+	if ((bank = (uint8_t *)aligned_alloc(GF16_BANK_ALIGN,
+					     GF16_SIZE * 128)) == NULL ||
+	    ((flags & GF16_BANK_256) && (bank256 = (uint8_t *)
+		aligned_alloc(GF16_BANK_ALIGN, GF16_SIZE * 256)) == NULL)) {
+		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+			__func__, strerror(errno));
+		free(bank);
+		return -1;
+	}
+#if defined(MADV_HUGEPAGE)
+	// Fewer TLB misses (failure is not fatal)
+	madvise(bank, GF16_SIZE * 128, MADV_HUGEPAGE);
+	if (bank256 != NULL) {
+		madvise(bank256, GF16_SIZE * 256, MADV_HUGEPAGE);
+	}
+#endif
+
+	// Build tables
+	for (a = 0; a < GF16_SIZE; a++) {
+		tb = bank + ((size_t)a << 7);
+		GF16set4bitRegTbl(tb, (uint16_t)a, 0);
+		if (bank256 == NULL) {
+			continue;
+		}
+
+		// Each 16 byte table twice for both 128bit lanes
+		tb256 = bank256 + ((size_t)a << 8);
+		for (i = 0; i < 8; i++) {
+			memcpy(tb256 + (i << 5), tb + (i << 4), 16);
+			memcpy(tb256 + (i << 5) + 16, tb + (i << 4), 16);
+		}
+	}
+
+	if (flags & GF16_BANK_128) {
+		GF16bank4bit = bank;
+	}
+	else { // Only for building bank256
+		free(bank);
+	}
+	GF16bank4bit256 = bank256;
+
+	return 0;
+}
+
+// Free banks built by GF16init4bitBank()
+void
+GF16free4bitBank(void)
+{
+	free(GF16bank4bit);
+	free(GF16bank4bit256);
+	GF16bank4bit = GF16bank4bit256 = NULL;
+}
+
+/******************** Table cache ********************/
+
+// Region tables are cached by (a, type, layout) so that coefficients
+// used repeatedly (e.g. a fixed coding matrix) don't create and free
+// tables every time. GF16getRegTbl() lends a table and
+// GF16putRegTbl() returns it. Tables not lent are evicted in LRU order
+// when the total size exceeds the budget (GF16setRegTblCache()).
+
+// Entry of table cache
+typedef struct GF16tblEnt {
+	uint16_t		a;	// Coefficient
+	int			type;	// type of GF16crt*Tbl()
+	int			layout;	// GF16_TBL_*
+	int			ref;	// # of borrowers
+	size_t			size;	// Size of tbl
+	void			*tbl;	// Table
+	struct GF16tblEnt	*next_key;	// Hash chain by (a, type, layout)
+	struct GF16tblEnt	*next_ptr;	// Hash chain by tbl
+	struct GF16tblEnt	*prev, *next;	// LRU list (most recent first)
+} GF16tblEnt;
+
+#define GF16_TBL_HASH	1024	// # of hash buckets (power of 2)
+
+static pthread_mutex_t	GF16tblLock = PTHREAD_MUTEX_INITIALIZER;
+static GF16tblEnt	*GF16tblKey[GF16_TBL_HASH];	// Hash by key
+static GF16tblEnt	*GF16tblPtr[GF16_TBL_HASH];	// Hash by pointer
+static GF16tblEnt	*GF16tblHead = NULL, *GF16tblTail = NULL; // LRU
+static size_t		GF16tblSize = 0;	// Total size of tables
+static size_t		GF16tblMax = GF16_TBL_CACHE_DEF;	// Budget
+
+// Sizes of tables (index is GF16_TBL_*)
+static const size_t	GF16tblLayoutSize[] = {
+	GF16_SIZE * sizeof(uint16_t), 256 * sizeof(uint16_t) * 2,
+	128, 256, 512, 64 * 4
+};
+
+// Hash values
+#define GF16tblHashKey(a, type, layout)					\
+	((((uint32_t)(a) << 5 | (uint32_t)(layout) << 2 | (uint32_t)(type)) \
+	  * 2654435761U) >> (32 - 10))
+#define GF16tblHashPtr(p)						\
+	((((uint32_t)((uintptr_t)(p) >> 5)) * 2654435761U) >> (32 - 10))
+
+// Create table of layout
+static void *
+GF16crtTbl(uint16_t a, int type, int layout)
+{
+	switch (layout) {
+	case GF16_TBL_REG:
+		return GF16crtRegTbl(a, type);
+	case GF16_TBL_SPLT:
+		return GF16crtSpltRegTbl(a, type);
+	case GF16_TBL_4BIT:
+		return GF16crt4bitRegTbl(a, type);
+	case GF16_TBL_4BIT256:
+		return GF16crt4bitRegTbl256(a, type);
+	case GF16_TBL_4BIT512:
+		return GF16crt4bitRegTbl512(a, type);
+	case GF16_TBL_AFFINE:
+		return GF16crtAffineTbl(a, type);
+	default:
+		fprintf(stderr, "Error: %s: Illegal layout: %d\n",
+			__func__, layout);
+		return NULL;
+	}
+}
+
+// Unlink entry from LRU list (call with GF16tblLock)
+static void
+GF16tblUnlink(GF16tblEnt *ent)
+{
+	if (ent->prev != NULL) {
+		ent->prev->next = ent->next;
+	}
+	else {
+		GF16tblHead = ent->next;
+	}
+	if (ent->next != NULL) {
+		ent->next->prev = ent->prev;
+	}
+	else {
+		GF16tblTail = ent->prev;
+	}
+}
+
+// Link entry to head of LRU list (call with GF16tblLock)
+static void
+GF16tblLinkHead(GF16tblEnt *ent)
+{
+	ent->prev = NULL;
+	ent->next = GF16tblHead;
+	if (GF16tblHead != NULL) {
+		GF16tblHead->prev = ent;
+	}
+	else {
+		GF16tblTail = ent;
+	}
+	GF16tblHead = ent;
+}
+
+// Evict tables not lent until total size fits max (call with GF16tblLock)
+static void
+GF16tblEvict(size_t max)
+{
+	GF16tblEnt	*ent, *prev, **pp;
+
+	for (ent = GF16tblTail; ent != NULL && GF16tblSize > max; ent = prev) {
+		prev = ent->prev;
+		if (ent->ref > 0) {
+			continue;
+		}
+
+		// Remove from hash chains
+		pp = &GF16tblKey[GF16tblHashKey(ent->a, ent->type,
+						ent->layout)];
+		while (*pp != ent) {
+			pp = &(*pp)->next_key;
+		}
+		*pp = ent->next_key;
+		pp = &GF16tblPtr[GF16tblHashPtr(ent->tbl)];
+		while (*pp != ent) {
+			pp = &(*pp)->next_ptr;
+		}
+		*pp = ent->next_ptr;
+
+		// Remove from LRU list
+		GF16tblUnlink(ent);
+		GF16tblSize -= ent->size;
+		free(ent->tbl);
+		free(ent);
+	}
+}
+
+// Find entry of key (call with GF16tblLock)
+static GF16tblEnt *
+GF16tblFind(uint16_t a, int type, int layout)
+{
+	GF16tblEnt	*ent;
+
+	for (ent = GF16tblKey[GF16tblHashKey(a, type, layout)]; ent != NULL;
+	     ent = ent->next_key) {
+		if (ent->a == a && ent->type == type && ent->layout == layout) {
+			return ent;
+		}
+	}
+
+	return NULL;
+}
+
+// Get a region table from cache (created if not cached)
+// This is thread safe and doesn't allocate memory if the table is cached.
+//
+// Args:
 //     a: static value in regional calculation (or coefficient)
-//     type: 0: a * x[i]
-//           1: x[i] / a
+//     type: type of GF16crt*Tbl() (0: a * x[i], 1: x[i] / a, ...)
+//     layout: GF16_TBL_REG: GF16crtRegTbl()
+//             GF16_TBL_SPLT: GF16crtSpltRegTbl()
+//             GF16_TBL_4BIT: GF16crt4bitRegTbl()
+//             GF16_TBL_4BIT256: GF16crt4bitRegTbl256()
+//             GF16_TBL_4BIT512: GF16crt4bitRegTbl512()
+//             GF16_TBL_AFFINE: GF16crtAffineTbl()
+//
+// Return value:
+//     pointer to table or NULL if failed.
+//     Don't free it but return it by GF16putRegTbl().
+//
+// Usage:
+//     uint8_t *gf_tb = GF16getRegTbl(a, 0, GF16_TBL_4BIT);
+//     GF16lkupRegionXor(gf_tb, (uint8_t *)x, (uint8_t *)y, len);
+//     GF16putRegTbl(gf_tb);
+//
+void *
+GF16getRegTbl(uint16_t a, int type, int layout)
+{
+	GF16tblEnt	*ent, *new;
+	void		*tbl;
+	size_t		h;
+
+	// Check layout
+	if (layout < 0 || layout >= GF16_TBL_NUM) {
+		fprintf(stderr, "Error: %s: Illegal layout: %d\n",
+			__func__, layout);
+		return NULL;
+	}
+
+	// Look up cache
+	pthread_mutex_lock(&GF16tblLock);
+	if ((ent = GF16tblFind(a, type, layout)) != NULL) {
+		ent->ref++;
+		if (ent != GF16tblHead) {
+			GF16tblUnlink(ent);
+			GF16tblLinkHead(ent);
+		}
+		tbl = ent->tbl;
+		pthread_mutex_unlock(&GF16tblLock);
+		return tbl;
+	}
+	pthread_mutex_unlock(&GF16tblLock);
+
+	// Create table without lock
+	if ((tbl = GF16crtTbl(a, type, layout)) == NULL) {
+		return NULL;
+	}
+	if ((new = (GF16tblEnt *)malloc(sizeof(GF16tblEnt))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		free(tbl);
+		return NULL;
+	}
+	new->a = a;
+	new->type = type;
+	new->layout = layout;
+	new->ref = 1;
+	new->size = GF16tblLayoutSize[layout];
+	new->tbl = tbl;
+
+	pthread_mutex_lock(&GF16tblLock);
+
+	// Another thread may have cached it meanwhile
+	if ((ent = GF16tblFind(a, type, layout)) != NULL) {
+		ent->ref++;
+		if (ent != GF16tblHead) {
+			GF16tblUnlink(ent);
+			GF16tblLinkHead(ent);
+		}
+		tbl = ent->tbl;
+		pthread_mutex_unlock(&GF16tblLock);
+		free(new->tbl);
+		free(new);
+		return tbl;
+	}
+
+	// Insert
+	h = GF16tblHashKey(a, type, layout);
+	new->next_key = GF16tblKey[h];
+	GF16tblKey[h] = new;
+	h = GF16tblHashPtr(tbl);
+	new->next_ptr = GF16tblPtr[h];
+	GF16tblPtr[h] = new;
+	GF16tblLinkHead(new);
+	GF16tblSize += new->size;
+
+	// Keep budget
+	GF16tblEvict(GF16tblMax);
+	pthread_mutex_unlock(&GF16tblLock);
+
+	return tbl;
+}
+
+// Return a table got by GF16getRegTbl()
+// The table may be evicted after this, so don't use it any more.
+void
+GF16putRegTbl(const void *tbl)
+{
+	GF16tblEnt	*ent;
+
+	if (tbl == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&GF16tblLock);
+	for (ent = GF16tblPtr[GF16tblHashPtr(tbl)]; ent != NULL;
+	     ent = ent->next_ptr) {
+		if (ent->tbl == tbl) {
+			break;
+		}
+	}
+	if (ent == NULL || ent->ref <= 0) {
+		pthread_mutex_unlock(&GF16tblLock);
+		fprintf(stderr, "Error: %s: %p is not lent by GF16getRegTbl()\n",
+			__func__, tbl);
+		return;
+	}
+	ent->ref--;
+
+	// Evict if over budget (all were lent at insertion)
+	if (ent->ref == 0 && GF16tblSize > GF16tblMax) {
+		GF16tblEvict(GF16tblMax);
+	}
+	pthread_mutex_unlock(&GF16tblLock);
+}
+
+// Set budget of table cache in bytes (default GF16_TBL_CACHE_DEF)
+// Tables not lent are evicted immediately if over it, so
+// GF16setRegTblCache(0) frees all of them.
+void
+GF16setRegTblCache(size_t max)
+{
+	pthread_mutex_lock(&GF16tblLock);
+	GF16tblMax = max;
+	GF16tblEvict(max);
+	pthread_mutex_unlock(&GF16tblLock);
+}
+
+/******************** Dot product ********************/
+
+// Step and region kernels of dot product and encoding for each SIMD
+// instruction set
+// Accumulators of low and high bytes stay in SIMD registers while all k
+// sources are streamed, so dst[] is loaded and stored only once.
+// gf_tb is k tables (128 bytes each) and srcs[i] + off is the source i
+// for dst. xor: 0: dst[n] = sum, 1: dst[n] ^= sum
+// Encoding kernels calculate t rows (dsts[r] + off) at once with
+// t * k tables (table of row r and source i is at (r * k + i) * 128)
+// so that each source is loaded once for t rows.
+
+// No SIMD
+static size_t
+GF16dotRegionNone(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		  size_t off, uint8_t *dst, size_t len, int xor)
+{
+	return 0;
+}
+
+static size_t
+GF16encRegionNone(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		  size_t off, uint8_t * const *dsts, int t, size_t len,
+		  int xor)
+{
+	return 0;
+}
+
+#if defined(_GF_X86_)
+// Load 32 bytes of input and pack low bytes to input_l and high
+// bytes to input_h by SSSE3
+GF_TARGET("ssse3") static inline void
+GF16dotSplit128(const uint8_t *input, __m128i *input_l, __m128i *input_h)
+{
+	__m128i	v_0, v_1, input_0, input_1, tmp;
+
+	// Pack low bytes of inputs to input_l
+	input_0 = _mm_loadu_si128((__m128i *)input);
+	input_1 = _mm_loadu_si128((__m128i *)(input + 16));
+	tmp = _mm_set1_epi16(0x00ff);
+	v_0 = _mm_and_si128(input_0, tmp);
+	v_1 = _mm_and_si128(input_1, tmp);
+	*input_l = _mm_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm_srli_epi16(input_0, 8);
+	v_1 = _mm_srli_epi16(input_1, 8);
+	*input_h = _mm_packus_epi16(v_0, v_1);
+}
+
+// Multiply packed input (nib: 4bit of input_l and input_h) by a and XOR
+// into acc_l (low bytes) and acc_h (high bytes) by SSSE3
+GF_TARGET("ssse3") static inline void
+GF16dotAcc128(const uint8_t *tb, const __m128i *nib, __m128i *acc_l,
+	      __m128i *acc_h)
+{
+	// Get GF calc results for low bytes
+	*acc_l = _mm_xor_si128(*acc_l, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 0)), nib[0]));
+	*acc_l = _mm_xor_si128(*acc_l, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 32)), nib[1]));
+	*acc_l = _mm_xor_si128(*acc_l, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 64)), nib[2]));
+	*acc_l = _mm_xor_si128(*acc_l, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 96)), nib[3]));
+
+	// Get GF calc results for high bytes
+	*acc_h = _mm_xor_si128(*acc_h, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 16)), nib[0]));
+	*acc_h = _mm_xor_si128(*acc_h, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 48)), nib[1]));
+	*acc_h = _mm_xor_si128(*acc_h, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 80)), nib[2]));
+	*acc_h = _mm_xor_si128(*acc_h, _mm_shuffle_epi8(
+			_mm_loadu_si128((__m128i *)(tb + 112)), nib[3]));
+}
+
+// Load 32 bytes of input and split it into 4bit of low bytes
+// (nib[0], nib[1]) and high bytes (nib[2], nib[3]) for GF16dotAcc128()
+GF_TARGET("ssse3") static inline void
+GF16dotNibble128(const uint8_t *input, __m128i *nib)
+{
+	__m128i	input_l, input_h, tmp;
+
+	GF16dotSplit128(input, &input_l, &input_h);
+
+	// Retrieve 4bit of each byte
+	tmp = _mm_set1_epi8(0x0f);
+	nib[0] = _mm_and_si128(input_l, tmp);
+	nib[1] = _mm_and_si128(_mm_srli_epi16(input_l, 4), tmp);
+	nib[2] = _mm_and_si128(input_h, tmp);
+	nib[3] = _mm_and_si128(_mm_srli_epi16(input_h, 4), tmp);
+}
+
+// Load 64 bytes of input and pack low bytes to input_l and high
+// bytes to input_h by AVX2
+GF_TARGET("avx2") static inline void
+GF16dotSplit256(const uint8_t *input, __m256i *input_l, __m256i *input_h)
+{
+	__m256i	v_0, v_1, input_0, input_1, tmp;
+
+	// Pack low bytes of inputs to input_l
+	input_0 = _mm256_loadu_si256((__m256i *)input);
+	input_1 = _mm256_loadu_si256((__m256i *)(input + 32));
+	tmp = _mm256_set1_epi16(0x00ff);
+	v_0 = _mm256_and_si256(input_0, tmp);
+	v_1 = _mm256_and_si256(input_1, tmp);
+	*input_l = _mm256_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm256_srli_epi16(input_0, 8);
+	v_1 = _mm256_srli_epi16(input_1, 8);
+	*input_h = _mm256_packus_epi16(v_0, v_1);
+}
+
+// Multiply packed input (nib: 4bit of input_l and input_h) by a and XOR
+// into acc_l (low bytes) and acc_h (high bytes) by AVX2
+GF_TARGET("avx2") static inline void
+GF16dotAcc256(const uint8_t *tb, const __m256i *nib, __m256i *acc_l,
+	      __m256i *acc_h)
+{
+	__m256i	tb_x;
+
+	// Get GF calc results for low bytes
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 0)));
+	*acc_l = _mm256_xor_si256(*acc_l, _mm256_shuffle_epi8(tb_x, nib[0]));
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 32)));
+	*acc_l = _mm256_xor_si256(*acc_l, _mm256_shuffle_epi8(tb_x, nib[1]));
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 64)));
+	*acc_l = _mm256_xor_si256(*acc_l, _mm256_shuffle_epi8(tb_x, nib[2]));
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 96)));
+	*acc_l = _mm256_xor_si256(*acc_l, _mm256_shuffle_epi8(tb_x, nib[3]));
+
+	// Get GF calc results for high bytes
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 16)));
+	*acc_h = _mm256_xor_si256(*acc_h, _mm256_shuffle_epi8(tb_x, nib[0]));
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 48)));
+	*acc_h = _mm256_xor_si256(*acc_h, _mm256_shuffle_epi8(tb_x, nib[1]));
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 80)));
+	*acc_h = _mm256_xor_si256(*acc_h, _mm256_shuffle_epi8(tb_x, nib[2]));
+	tb_x = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((__m128i *)(tb + 112)));
+	*acc_h = _mm256_xor_si256(*acc_h, _mm256_shuffle_epi8(tb_x, nib[3]));
+}
+
+// Load 64 bytes of input and split it into 4bit of low bytes
+// (nib[0], nib[1]) and high bytes (nib[2], nib[3]) for GF16dotAcc256()
+GF_TARGET("avx2") static inline void
+GF16dotNibble256(const uint8_t *input, __m256i *nib)
+{
+	__m256i	input_l, input_h, tmp;
+
+	GF16dotSplit256(input, &input_l, &input_h);
+
+	// Retrieve 4bit of each byte
+	tmp = _mm256_set1_epi8(0x0f);
+	nib[0] = _mm256_and_si256(input_l, tmp);
+	nib[1] = _mm256_and_si256(_mm256_srli_epi16(input_l, 4), tmp);
+	nib[2] = _mm256_and_si256(input_h, tmp);
+	nib[3] = _mm256_and_si256(_mm256_srli_epi16(input_h, 4), tmp);
+}
+
+// Load 128 bytes of input and pack low bytes to input_l and high
+// bytes to input_h by AVX-512BW
+GF_TARGET("avx512f,avx512bw") static inline void
+GF16dotSplit512(const uint8_t *input, __m512i *input_l, __m512i *input_h)
+{
+	__m512i	v_0, v_1, input_0, input_1, tmp;
+
+	// Pack low bytes of inputs to input_l
+	input_0 = _mm512_loadu_si512((__m512i *)input);
+	input_1 = _mm512_loadu_si512((__m512i *)(input + 64));
+	tmp = _mm512_set1_epi16(0x00ff);
+	v_0 = _mm512_and_si512(input_0, tmp);
+	v_1 = _mm512_and_si512(input_1, tmp);
+	*input_l = _mm512_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm512_srli_epi16(input_0, 8);
+	v_1 = _mm512_srli_epi16(input_1, 8);
+	*input_h = _mm512_packus_epi16(v_0, v_1);
+}
+
+// Multiply packed input (nib: 4bit of input_l and input_h) by a and XOR
+// into acc_l (low bytes) and acc_h (high bytes) by AVX-512BW
+GF_TARGET("avx512f,avx512bw") static inline void
+GF16dotAcc512(const uint8_t *tb, const __m512i *nib, __m512i *acc_l,
+	      __m512i *acc_h)
+{
+	__m512i	tb_x;
+
+	// Get GF calc results for low bytes
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 0)));
+	*acc_l = _mm512_xor_si512(*acc_l, _mm512_shuffle_epi8(tb_x, nib[0]));
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 32)));
+	*acc_l = _mm512_xor_si512(*acc_l, _mm512_shuffle_epi8(tb_x, nib[1]));
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 64)));
+	*acc_l = _mm512_xor_si512(*acc_l, _mm512_shuffle_epi8(tb_x, nib[2]));
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 96)));
+	*acc_l = _mm512_xor_si512(*acc_l, _mm512_shuffle_epi8(tb_x, nib[3]));
+
+	// Get GF calc results for high bytes
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 16)));
+	*acc_h = _mm512_xor_si512(*acc_h, _mm512_shuffle_epi8(tb_x, nib[0]));
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 48)));
+	*acc_h = _mm512_xor_si512(*acc_h, _mm512_shuffle_epi8(tb_x, nib[1]));
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 80)));
+	*acc_h = _mm512_xor_si512(*acc_h, _mm512_shuffle_epi8(tb_x, nib[2]));
+	tb_x = _mm512_broadcast_i32x4(
+			_mm_loadu_si128((__m128i *)(tb + 112)));
+	*acc_h = _mm512_xor_si512(*acc_h, _mm512_shuffle_epi8(tb_x, nib[3]));
+}
+
+// Load 128 bytes of input and split it into 4bit of low bytes
+// (nib[0], nib[1]) and high bytes (nib[2], nib[3]) for GF16dotAcc512()
+GF_TARGET("avx512f,avx512bw") static inline void
+GF16dotNibble512(const uint8_t *input, __m512i *nib)
+{
+	__m512i	input_l, input_h, tmp;
+
+	GF16dotSplit512(input, &input_l, &input_h);
+
+	// Retrieve 4bit of each byte
+	tmp = _mm512_set1_epi8(0x0f);
+	nib[0] = _mm512_and_si512(input_l, tmp);
+	nib[1] = _mm512_and_si512(_mm512_srli_epi16(input_l, 4), tmp);
+	nib[2] = _mm512_and_si512(input_h, tmp);
+	nib[3] = _mm512_and_si512(_mm512_srli_epi16(input_h, 4), tmp);
+}
+
+// Same as GF16dotAcc256() but by GFNI with packed input (in[0]: low
+// bytes, in[1]: high bytes) and matrices mtx[4] of GF16crtAffineTbl()
+GF_TARGET("gfni,avx2") static inline void
+GF16dotAccAffine256(const uint64_t *mtx, const __m256i *in, __m256i *acc_l,
+		    __m256i *acc_h)
+{
+	// Get GF calc results for low bytes
+	*acc_l = _mm256_xor_si256(*acc_l, _mm256_gf2p8affine_epi64_epi8(in[0],
+			_mm256_set1_epi64x((long long)mtx[0]), 0));
+	*acc_l = _mm256_xor_si256(*acc_l, _mm256_gf2p8affine_epi64_epi8(in[1],
+			_mm256_set1_epi64x((long long)mtx[1]), 0));
+
+	// Get GF calc results for high bytes
+	*acc_h = _mm256_xor_si256(*acc_h, _mm256_gf2p8affine_epi64_epi8(in[0],
+			_mm256_set1_epi64x((long long)mtx[2]), 0));
+	*acc_h = _mm256_xor_si256(*acc_h, _mm256_gf2p8affine_epi64_epi8(in[1],
+			_mm256_set1_epi64x((long long)mtx[3]), 0));
+}
+
+// Same as GF16dotAcc512() but by GFNI with packed input (in[0]: low
+// bytes, in[1]: high bytes) and matrices mtx[4] of GF16crtAffineTbl()
+GF_TARGET("gfni,avx512f,avx512bw") static inline void
+GF16dotAccAffine512(const uint64_t *mtx, const __m512i *in, __m512i *acc_l,
+		    __m512i *acc_h)
+{
+	// Get GF calc results for low bytes
+	*acc_l = _mm512_xor_si512(*acc_l, _mm512_gf2p8affine_epi64_epi8(in[0],
+			_mm512_set1_epi64((long long)mtx[0]), 0));
+	*acc_l = _mm512_xor_si512(*acc_l, _mm512_gf2p8affine_epi64_epi8(in[1],
+			_mm512_set1_epi64((long long)mtx[1]), 0));
+
+	// Get GF calc results for high bytes
+	*acc_h = _mm512_xor_si512(*acc_h, _mm512_gf2p8affine_epi64_epi8(in[0],
+			_mm512_set1_epi64((long long)mtx[2]), 0));
+	*acc_h = _mm512_xor_si512(*acc_h, _mm512_gf2p8affine_epi64_epi8(in[1],
+			_mm512_set1_epi64((long long)mtx[3]), 0));
+}
+
+// Interleave acc_l (low bytes) and acc_h (high bytes) and save them
+// into 32 bytes of output (XOR into output if xor) by SSSE3
+GF_TARGET("ssse3") static inline void
+GF16dotStore128(uint8_t *output, __m128i acc_l, __m128i acc_h, int xor)
+{
+	__m128i	output_l, output_h;
+
+	// Unpack low and high bytes
+	output_l = _mm_unpacklo_epi8(acc_l, acc_h);
+	output_h = _mm_unpackhi_epi8(acc_l, acc_h);
+
+	// XOR into output if xor and save
+	if (xor) {
+		output_l = _mm_xor_si128(output_l,
+				_mm_loadu_si128((__m128i *)output));
+		output_h = _mm_xor_si128(output_h,
+				_mm_loadu_si128((__m128i *)(output + 16)));
+	}
+	_mm_storeu_si128((__m128i *)output, output_l);
+	_mm_storeu_si128((__m128i *)(output + 16), output_h);
+}
+
+// Interleave acc_l (low bytes) and acc_h (high bytes) and save them
+// into 64 bytes of output (XOR into output if xor) by AVX2
+GF_TARGET("avx2") static inline void
+GF16dotStore256(uint8_t *output, __m256i acc_l, __m256i acc_h, int xor)
+{
+	__m256i	output_l, output_h;
+
+	// Unpack low and high bytes
+	output_l = _mm256_unpacklo_epi8(acc_l, acc_h);
+	output_h = _mm256_unpackhi_epi8(acc_l, acc_h);
+
+	// XOR into output if xor and save
+	if (xor) {
+		output_l = _mm256_xor_si256(output_l,
+				_mm256_loadu_si256((__m256i *)output));
+		output_h = _mm256_xor_si256(output_h,
+				_mm256_loadu_si256((__m256i *)(output + 32)));
+	}
+	_mm256_storeu_si256((__m256i *)output, output_l);
+	_mm256_storeu_si256((__m256i *)(output + 32), output_h);
+}
+
+// Interleave acc_l (low bytes) and acc_h (high bytes) and save them
+// into 128 bytes of output (XOR into output if xor) by AVX-512BW
+GF_TARGET("avx512f,avx512bw") static inline void
+GF16dotStore512(uint8_t *output, __m512i acc_l, __m512i acc_h, int xor)
+{
+	__m512i	output_l, output_h;
+
+	// Unpack low and high bytes
+	output_l = _mm512_unpacklo_epi8(acc_l, acc_h);
+	output_h = _mm512_unpackhi_epi8(acc_l, acc_h);
+
+	// XOR into output if xor and save
+	if (xor) {
+		output_l = _mm512_xor_si512(output_l,
+				_mm512_loadu_si512((__m512i *)output));
+		output_h = _mm512_xor_si512(output_h,
+				_mm512_loadu_si512((__m512i *)(output + 64)));
+	}
+	_mm512_storeu_si512((__m512i *)output, output_l);
+	_mm512_storeu_si512((__m512i *)(output + 64), output_h);
+}
+
+// SSSE3 -- every 32 bytes
+GF_TARGET("ssse3") static size_t
+GF16dotRegionSSSE3(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		   int k, size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m128i		nib[4], acc_l, acc_h;
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 128 * 2bit
+		acc_l = acc_h = _mm_setzero_si128();
+		for (i = 0; i < k; i++) {
+			GF16dotNibble128(srcs[i] + off + n, nib);
+			GF16dotAcc128(gf_tb + (i << 7), nib, &acc_l, &acc_h);
+		}
+		GF16dotStore128(dst + n, acc_l, acc_h, xor);
+	}
+
+	return n;
+}
+
+// AVX2 -- every 64 bytes
+GF_TARGET("avx2") static size_t
+GF16dotRegionAVX2(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		  int k, size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m256i		nib[4], acc_l, acc_h;
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 256 * 2bit
+		acc_l = acc_h = _mm256_setzero_si256();
+		for (i = 0; i < k; i++) {
+			GF16dotNibble256(srcs[i] + off + n, nib);
+			GF16dotAcc256(gf_tb + (i << 7), nib, &acc_l, &acc_h);
+		}
+		GF16dotStore256(dst + n, acc_l, acc_h, xor);
+	}
+
+	// Remaining 32 bytes
+	return n + GF16dotRegionSSSE3(gf_tb, srcs, k, off + n, dst + n,
+				      len - n, xor);
+}
+
+// AVX-512BW -- every 128 bytes
+GF_TARGET("avx512f,avx512bw") static size_t
+GF16dotRegionAVX512(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		    int k, size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m512i		nib[4], acc_l, acc_h;
+
+	for (n = 0; n + 128 <= len; n += 128) { // Do every 512 * 2bit
+		acc_l = acc_h = _mm512_setzero_si512();
+		for (i = 0; i < k; i++) {
+			GF16dotNibble512(srcs[i] + off + n, nib);
+			GF16dotAcc512(gf_tb + (i << 7), nib, &acc_l, &acc_h);
+		}
+		GF16dotStore512(dst + n, acc_l, acc_h, xor);
+	}
+
+	// Remaining 96 bytes
+	return n + GF16dotRegionAVX2(gf_tb, srcs, k, off + n, dst + n,
+				     len - n, xor);
+}
+
+// AVX2 + GFNI -- every 64 bytes
+GF_TARGET("gfni,avx2") static size_t
+GF16dotRegionAffineAVX2(const uint8_t *gf_tb, const uint8_t * const *srcs,
+			int k, size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	uint64_t	mtx[GF_DOT_MAX * 4];
+	__m256i		in[2], acc_l, acc_h;
+
+	// Get matrices from 4bit tables
+	for (i = 0; i < k; i++) {
+		GF16affineMtx4bit(gf_tb + (i << 7), mtx + (i << 2));
+	}
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 256 * 2bit
+		acc_l = acc_h = _mm256_setzero_si256();
+		for (i = 0; i < k; i++) {
+			GF16dotSplit256(srcs[i] + off + n, &in[0], &in[1]);
+			GF16dotAccAffine256(mtx + (i << 2), in, &acc_l, &acc_h);
+		}
+		GF16dotStore256(dst + n, acc_l, acc_h, xor);
+	}
+
+	// Remaining 32 bytes
+	return n + GF16dotRegionSSSE3(gf_tb, srcs, k, off + n, dst + n,
+				      len - n, xor);
+}
+
+// AVX-512BW + GFNI -- every 128 bytes
+GF_TARGET("gfni,avx512f,avx512bw") static size_t
+GF16dotRegionAffineAVX512(const uint8_t *gf_tb, const uint8_t * const *srcs,
+			  int k, size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	uint64_t	mtx[GF_DOT_MAX * 4];
+	__m512i		in[2], acc_l, acc_h;
+
+	// Get matrices from 4bit tables
+	for (i = 0; i < k; i++) {
+		GF16affineMtx4bit(gf_tb + (i << 7), mtx + (i << 2));
+	}
+
+	for (n = 0; n + 128 <= len; n += 128) { // Do every 512 * 2bit
+		acc_l = acc_h = _mm512_setzero_si512();
+		for (i = 0; i < k; i++) {
+			GF16dotSplit512(srcs[i] + off + n, &in[0], &in[1]);
+			GF16dotAccAffine512(mtx + (i << 2), in, &acc_l, &acc_h);
+		}
+		GF16dotStore512(dst + n, acc_l, acc_h, xor);
+	}
+
+	// Remaining 96 bytes
+	return n + GF16dotRegionAffineAVX2(gf_tb, srcs, k, off + n, dst + n,
+					   len - n, xor);
+}
+
+// SSSE3 -- every 32 bytes for t rows
+// t must be constant (1 to GF_ENC_TILE) so that unused accumulators are
+// removed and the rest are kept in registers.
+GF_TARGET("ssse3") static GF_INLINE size_t
+GF16encTileSSSE3(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		 int k, size_t off, uint8_t * const *dsts, const int t,
+		 size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m128i		nib[4];
+	__m128i		acc_0_l, acc_0_h, acc_1_l, acc_1_h;
+	__m128i		acc_2_l, acc_2_h, acc_3_l, acc_3_h;
+
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 128 * 2bit
+		acc_0_l = acc_0_h = acc_1_l = acc_1_h = _mm_setzero_si128();
+		acc_2_l = acc_2_h = acc_3_l = acc_3_h = _mm_setzero_si128();
+		for (i = 0; i < k; i++) {
+			// Load input once for all rows
+			GF16dotNibble128(srcs[i] + off + n, nib);
+			GF16dotAcc128(gf_tb + (i << 7), nib,
+				      &acc_0_l, &acc_0_h);
+			if (t > 1) {
+				GF16dotAcc128(gf_tb + ((1 * k + i) << 7), nib,
+					      &acc_1_l, &acc_1_h);
+			}
+			if (t > 2) {
+				GF16dotAcc128(gf_tb + ((2 * k + i) << 7), nib,
+					      &acc_2_l, &acc_2_h);
+			}
+			if (t > 3) {
+				GF16dotAcc128(gf_tb + ((3 * k + i) << 7), nib,
+					      &acc_3_l, &acc_3_h);
+			}
+		}
+
+		GF16dotStore128(dsts[0] + off + n, acc_0_l, acc_0_h, xor);
+		if (t > 1) {
+			GF16dotStore128(dsts[1] + off + n, acc_1_l, acc_1_h,
+					xor);
+		}
+		if (t > 2) {
+			GF16dotStore128(dsts[2] + off + n, acc_2_l, acc_2_h,
+					xor);
+		}
+		if (t > 3) {
+			GF16dotStore128(dsts[3] + off + n, acc_3_l, acc_3_h,
+					xor);
+		}
+	}
+
+	return n;
+}
+
+// Calculate t (GF_ENC_TILE or less) rows of encoding at once
+GF_TARGET("ssse3") static size_t
+GF16encRegionSSSE3(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		   int k, size_t off, uint8_t * const *dsts, int t,
+		   size_t len, int xor)
+{
+	size_t		n;
+
+	// Make t constant
+	switch (t) {
+	case 1:
+		n = GF16encTileSSSE3(gf_tb, srcs, k, off, dsts, 1, len, xor);
+		break;
+	case 2:
+		n = GF16encTileSSSE3(gf_tb, srcs, k, off, dsts, 2, len, xor);
+		break;
+	case 3:
+		n = GF16encTileSSSE3(gf_tb, srcs, k, off, dsts, 3, len, xor);
+		break;
+	default:
+		n = GF16encTileSSSE3(gf_tb, srcs, k, off, dsts, 4, len, xor);
+		break;
+	}
+
+	return n;
+}
+
+// AVX2 -- every 64 bytes for t rows
+// t must be constant (1 to GF_ENC_TILE) so that unused accumulators are
+// removed and the rest are kept in registers.
+GF_TARGET("avx2") static GF_INLINE size_t
+GF16encTileAVX2(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		int k, size_t off, uint8_t * const *dsts, const int t,
+		size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m256i		nib[4];
+	__m256i		acc_0_l, acc_0_h, acc_1_l, acc_1_h;
+	__m256i		acc_2_l, acc_2_h, acc_3_l, acc_3_h;
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 256 * 2bit
+		acc_0_l = acc_0_h = acc_1_l = acc_1_h = _mm256_setzero_si256();
+		acc_2_l = acc_2_h = acc_3_l = acc_3_h = _mm256_setzero_si256();
+		for (i = 0; i < k; i++) {
+			// Load input once for all rows
+			GF16dotNibble256(srcs[i] + off + n, nib);
+			GF16dotAcc256(gf_tb + (i << 7), nib,
+				      &acc_0_l, &acc_0_h);
+			if (t > 1) {
+				GF16dotAcc256(gf_tb + ((1 * k + i) << 7), nib,
+					      &acc_1_l, &acc_1_h);
+			}
+			if (t > 2) {
+				GF16dotAcc256(gf_tb + ((2 * k + i) << 7), nib,
+					      &acc_2_l, &acc_2_h);
+			}
+			if (t > 3) {
+				GF16dotAcc256(gf_tb + ((3 * k + i) << 7), nib,
+					      &acc_3_l, &acc_3_h);
+			}
+		}
+
+		GF16dotStore256(dsts[0] + off + n, acc_0_l, acc_0_h, xor);
+		if (t > 1) {
+			GF16dotStore256(dsts[1] + off + n, acc_1_l, acc_1_h,
+					xor);
+		}
+		if (t > 2) {
+			GF16dotStore256(dsts[2] + off + n, acc_2_l, acc_2_h,
+					xor);
+		}
+		if (t > 3) {
+			GF16dotStore256(dsts[3] + off + n, acc_3_l, acc_3_h,
+					xor);
+		}
+	}
+
+	return n;
+}
+
+// Calculate t (GF_ENC_TILE or less) rows of encoding at once
+GF_TARGET("avx2") static size_t
+GF16encRegionAVX2(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		  int k, size_t off, uint8_t * const *dsts, int t,
+		  size_t len, int xor)
+{
+	size_t		n;
+
+	// Make t constant
+	switch (t) {
+	case 1:
+		n = GF16encTileAVX2(gf_tb, srcs, k, off, dsts, 1, len, xor);
+		break;
+	case 2:
+		n = GF16encTileAVX2(gf_tb, srcs, k, off, dsts, 2, len, xor);
+		break;
+	case 3:
+		n = GF16encTileAVX2(gf_tb, srcs, k, off, dsts, 3, len, xor);
+		break;
+	default:
+		n = GF16encTileAVX2(gf_tb, srcs, k, off, dsts, 4, len, xor);
+		break;
+	}
+
+	// Remaining 32 bytes
+	return n + GF16encRegionSSSE3(gf_tb, srcs, k, off + n, dsts,
+				      t, len - n, xor);
+}
+
+// AVX-512BW -- every 128 bytes for t rows
+// t must be constant (1 to GF_ENC_TILE) so that unused accumulators are
+// removed and the rest are kept in registers.
+GF_TARGET("avx512f,avx512bw") static GF_INLINE size_t
+GF16encTileAVX512(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		  int k, size_t off, uint8_t * const *dsts, const int t,
+		  size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m512i		nib[4];
+	__m512i		acc_0_l, acc_0_h, acc_1_l, acc_1_h;
+	__m512i		acc_2_l, acc_2_h, acc_3_l, acc_3_h;
+
+	for (n = 0; n + 128 <= len; n += 128) { // Do every 512 * 2bit
+		acc_0_l = acc_0_h = acc_1_l = acc_1_h = _mm512_setzero_si512();
+		acc_2_l = acc_2_h = acc_3_l = acc_3_h = _mm512_setzero_si512();
+		for (i = 0; i < k; i++) {
+			// Load input once for all rows
+			GF16dotNibble512(srcs[i] + off + n, nib);
+			GF16dotAcc512(gf_tb + (i << 7), nib,
+				      &acc_0_l, &acc_0_h);
+			if (t > 1) {
+				GF16dotAcc512(gf_tb + ((1 * k + i) << 7), nib,
+					      &acc_1_l, &acc_1_h);
+			}
+			if (t > 2) {
+				GF16dotAcc512(gf_tb + ((2 * k + i) << 7), nib,
+					      &acc_2_l, &acc_2_h);
+			}
+			if (t > 3) {
+				GF16dotAcc512(gf_tb + ((3 * k + i) << 7), nib,
+					      &acc_3_l, &acc_3_h);
+			}
+		}
+
+		GF16dotStore512(dsts[0] + off + n, acc_0_l, acc_0_h, xor);
+		if (t > 1) {
+			GF16dotStore512(dsts[1] + off + n, acc_1_l, acc_1_h,
+					xor);
+		}
+		if (t > 2) {
+			GF16dotStore512(dsts[2] + off + n, acc_2_l, acc_2_h,
+					xor);
+		}
+		if (t > 3) {
+			GF16dotStore512(dsts[3] + off + n, acc_3_l, acc_3_h,
+					xor);
+		}
+	}
+
+	return n;
+}
+
+// Calculate t (GF_ENC_TILE or less) rows of encoding at once
+GF_TARGET("avx512f,avx512bw") static size_t
+GF16encRegionAVX512(const uint8_t *gf_tb, const uint8_t * const *srcs,
+		    int k, size_t off, uint8_t * const *dsts, int t,
+		    size_t len, int xor)
+{
+	size_t		n;
+
+	// Make t constant
+	switch (t) {
+	case 1:
+		n = GF16encTileAVX512(gf_tb, srcs, k, off, dsts, 1, len, xor);
+		break;
+	case 2:
+		n = GF16encTileAVX512(gf_tb, srcs, k, off, dsts, 2, len, xor);
+		break;
+	case 3:
+		n = GF16encTileAVX512(gf_tb, srcs, k, off, dsts, 3, len, xor);
+		break;
+	default:
+		n = GF16encTileAVX512(gf_tb, srcs, k, off, dsts, 4, len, xor);
+		break;
+	}
+
+	// Remaining 96 bytes
+	return n + GF16encRegionAVX2(gf_tb, srcs, k, off + n, dsts,
+				     t, len - n, xor);
+}
+
+// AVX2 + GFNI -- every 64 bytes for t rows
+// t must be constant (1 to GF_ENC_TILE) so that unused accumulators are
+// removed and the rest are kept in registers.
+GF_TARGET("gfni,avx2") static GF_INLINE size_t
+GF16encTileAffineAVX2(const uint64_t *mtx, const uint8_t * const *srcs,
+		      int k, size_t off, uint8_t * const *dsts, const int t,
+		      size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m256i		in[2];
+	__m256i		acc_0_l, acc_0_h, acc_1_l, acc_1_h;
+	__m256i		acc_2_l, acc_2_h, acc_3_l, acc_3_h;
+
+	for (n = 0; n + 64 <= len; n += 64) { // Do every 256 * 2bit
+		acc_0_l = acc_0_h = acc_1_l = acc_1_h = _mm256_setzero_si256();
+		acc_2_l = acc_2_h = acc_3_l = acc_3_h = _mm256_setzero_si256();
+		for (i = 0; i < k; i++) {
+			// Load input once for all rows
+			GF16dotSplit256(srcs[i] + off + n, &in[0], &in[1]);
+			GF16dotAccAffine256(mtx + (i << 2),
+					    in, &acc_0_l, &acc_0_h);
+			if (t > 1) {
+				GF16dotAccAffine256(mtx + ((1 * k + i) << 2),
+						    in, &acc_1_l, &acc_1_h);
+			}
+			if (t > 2) {
+				GF16dotAccAffine256(mtx + ((2 * k + i) << 2),
+						    in, &acc_2_l, &acc_2_h);
+			}
+			if (t > 3) {
+				GF16dotAccAffine256(mtx + ((3 * k + i) << 2),
+						    in, &acc_3_l, &acc_3_h);
+			}
+		}
+
+		GF16dotStore256(dsts[0] + off + n, acc_0_l, acc_0_h, xor);
+		if (t > 1) {
+			GF16dotStore256(dsts[1] + off + n, acc_1_l, acc_1_h,
+					xor);
+		}
+		if (t > 2) {
+			GF16dotStore256(dsts[2] + off + n, acc_2_l, acc_2_h,
+					xor);
+		}
+		if (t > 3) {
+			GF16dotStore256(dsts[3] + off + n, acc_3_l, acc_3_h,
+					xor);
+		}
+	}
+
+	return n;
+}
+
+// Calculate t (GF_ENC_TILE or less) rows of encoding at once
+GF_TARGET("gfni,avx2") static size_t
+GF16encRegionAffineAVX2(const uint8_t *gf_tb, const uint8_t * const *srcs,
+			int k, size_t off, uint8_t * const *dsts, int t,
+			size_t len, int xor)
+{
+	size_t		n;
+	int		i, r;
+	uint64_t	mtx[GF_ENC_TILE * GF_DOT_MAX * 4];
+
+	// Get matrices from 4bit tables
+	for (r = 0; r < t; r++) {
+		for (i = 0; i < k; i++) {
+			GF16affineMtx4bit(gf_tb + ((r * k + i) << 7),
+					  mtx + ((r * k + i) << 2));
+		}
+	}
+
+	// Make t constant
+	switch (t) {
+	case 1:
+		n = GF16encTileAffineAVX2(mtx, srcs, k, off, dsts, 1, len, xor);
+		break;
+	case 2:
+		n = GF16encTileAffineAVX2(mtx, srcs, k, off, dsts, 2, len, xor);
+		break;
+	case 3:
+		n = GF16encTileAffineAVX2(mtx, srcs, k, off, dsts, 3, len, xor);
+		break;
+	default:
+		n = GF16encTileAffineAVX2(mtx, srcs, k, off, dsts, 4, len, xor);
+		break;
+	}
+
+	// Remaining 32 bytes
+	return n + GF16encRegionSSSE3(gf_tb, srcs, k, off + n, dsts,
+				      t, len - n, xor);
+}
+
+// AVX-512BW + GFNI -- every 128 bytes for t rows
+// t must be constant (1 to GF_ENC_TILE) so that unused accumulators are
+// removed and the rest are kept in registers.
+GF_TARGET("gfni,avx512f,avx512bw") static GF_INLINE size_t
+GF16encTileAffineAVX512(const uint64_t *mtx, const uint8_t * const *srcs,
+			int k, size_t off, uint8_t * const *dsts, const int t,
+			size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	__m512i		in[2];
+	__m512i		acc_0_l, acc_0_h, acc_1_l, acc_1_h;
+	__m512i		acc_2_l, acc_2_h, acc_3_l, acc_3_h;
+
+	for (n = 0; n + 128 <= len; n += 128) { // Do every 512 * 2bit
+		acc_0_l = acc_0_h = acc_1_l = acc_1_h = _mm512_setzero_si512();
+		acc_2_l = acc_2_h = acc_3_l = acc_3_h = _mm512_setzero_si512();
+		for (i = 0; i < k; i++) {
+			// Load input once for all rows
+			GF16dotSplit512(srcs[i] + off + n, &in[0], &in[1]);
+			GF16dotAccAffine512(mtx + (i << 2),
+					    in, &acc_0_l, &acc_0_h);
+			if (t > 1) {
+				GF16dotAccAffine512(mtx + ((1 * k + i) << 2),
+						    in, &acc_1_l, &acc_1_h);
+			}
+			if (t > 2) {
+				GF16dotAccAffine512(mtx + ((2 * k + i) << 2),
+						    in, &acc_2_l, &acc_2_h);
+			}
+			if (t > 3) {
+				GF16dotAccAffine512(mtx + ((3 * k + i) << 2),
+						    in, &acc_3_l, &acc_3_h);
+			}
+		}
+
+		GF16dotStore512(dsts[0] + off + n, acc_0_l, acc_0_h, xor);
+		if (t > 1) {
+			GF16dotStore512(dsts[1] + off + n, acc_1_l, acc_1_h,
+					xor);
+		}
+		if (t > 2) {
+			GF16dotStore512(dsts[2] + off + n, acc_2_l, acc_2_h,
+					xor);
+		}
+		if (t > 3) {
+			GF16dotStore512(dsts[3] + off + n, acc_3_l, acc_3_h,
+					xor);
+		}
+	}
+
+	return n;
+}
+
+// Calculate t (GF_ENC_TILE or less) rows of encoding at once
+GF_TARGET("gfni,avx512f,avx512bw") static size_t
+GF16encRegionAffineAVX512(const uint8_t *gf_tb, const uint8_t * const *srcs,
+			  int k, size_t off, uint8_t * const *dsts, int t,
+			  size_t len, int xor)
+{
+	size_t		n;
+	int		i, r;
+	uint64_t	mtx[GF_ENC_TILE * GF_DOT_MAX * 4];
+
+	// Get matrices from 4bit tables
+	for (r = 0; r < t; r++) {
+		for (i = 0; i < k; i++) {
+			GF16affineMtx4bit(gf_tb + ((r * k + i) << 7),
+					  mtx + ((r * k + i) << 2));
+		}
+	}
+
+	// Make t constant
+	switch (t) {
+	case 1:
+		n = GF16encTileAffineAVX512(mtx, srcs, k, off, dsts,
+					    1, len, xor);
+		break;
+	case 2:
+		n = GF16encTileAffineAVX512(mtx, srcs, k, off, dsts,
+					    2, len, xor);
+		break;
+	case 3:
+		n = GF16encTileAffineAVX512(mtx, srcs, k, off, dsts,
+					    3, len, xor);
+		break;
+	default:
+		n = GF16encTileAffineAVX512(mtx, srcs, k, off, dsts,
+					    4, len, xor);
+		break;
+	}
+
+	// Remaining 96 bytes
+	return n + GF16encRegionAffineAVX2(gf_tb, srcs, k, off + n, dsts,
+					   t, len - n, xor);
+}
+#elif defined(_arm64_) // NEON
+// NEON -- every 32 bytes
+static size_t
+GF16dotRegionNEON(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		  size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	const uint8_t	*tb;
+	uint8x16x2_t	input_v, output_v;
+	uint8x16_t	acc_l, acc_h, input_l_l, input_l_h, input_h_l, input_h_h;
+	uint8x16_t	tmp;
+
+	tmp = vdupq_n_u8(0x0f);
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 128 * 2bit
+		acc_l = acc_h = vdupq_n_u8(0);
+		for (i = 0; i < k; i++) {
+			tb = gf_tb + (i << 7);
+
+			// Load interleaved inputs and retrieve 4bit
+			input_v = vld2q_u8(srcs[i] + off + n);
+			input_l_l = vandq_u8(input_v.val[0], tmp);
+			input_l_h = vshrq_n_u8(input_v.val[0], 4);
+			input_h_l = vandq_u8(input_v.val[1], tmp);
+			input_h_h = vshrq_n_u8(input_v.val[1], 4);
+
+			// Get GF calc results for low bytes
+			acc_l = veorq_u8(acc_l,
+					 vqtbl1q_u8(vld1q_u8(tb), input_l_l));
+			acc_l = veorq_u8(acc_l,
+				 vqtbl1q_u8(vld1q_u8(tb + 32), input_l_h));
+			acc_l = veorq_u8(acc_l,
+				 vqtbl1q_u8(vld1q_u8(tb + 64), input_h_l));
+			acc_l = veorq_u8(acc_l,
+				 vqtbl1q_u8(vld1q_u8(tb + 96), input_h_h));
+
+			// Get GF calc results for high bytes
+			acc_h = veorq_u8(acc_h,
+				 vqtbl1q_u8(vld1q_u8(tb + 16), input_l_l));
+			acc_h = veorq_u8(acc_h,
+				 vqtbl1q_u8(vld1q_u8(tb + 48), input_l_h));
+			acc_h = veorq_u8(acc_h,
+				 vqtbl1q_u8(vld1q_u8(tb + 80), input_h_l));
+			acc_h = veorq_u8(acc_h,
+				 vqtbl1q_u8(vld1q_u8(tb + 112), input_h_h));
+		}
+
+		// XOR into dst if xor and save interleaved results
+		if (xor) {
+			output_v = vld2q_u8(dst + n);
+			acc_l = veorq_u8(acc_l, output_v.val[0]);
+			acc_h = veorq_u8(acc_h, output_v.val[1]);
+		}
+		output_v.val[0] = acc_l;
+		output_v.val[1] = acc_h;
+		vst2q_u8(dst + n, output_v);
+	}
+
+	return n;
+}
+
+// Multiply 32 bytes of input (nib: 4bit of low and high bytes) by a and
+// XOR into acc_l (low bytes) and acc_h (high bytes) by NEON
+static inline void
+GF16dotAccNEON(const uint8_t *tb, const uint8x16_t *nib, uint8x16_t *acc_l,
+	       uint8x16_t *acc_h)
+{
+	// Get GF calc results for low bytes
+	*acc_l = veorq_u8(*acc_l, vqtbl1q_u8(vld1q_u8(tb), nib[0]));
+	*acc_l = veorq_u8(*acc_l, vqtbl1q_u8(vld1q_u8(tb + 32), nib[1]));
+	*acc_l = veorq_u8(*acc_l, vqtbl1q_u8(vld1q_u8(tb + 64), nib[2]));
+	*acc_l = veorq_u8(*acc_l, vqtbl1q_u8(vld1q_u8(tb + 96), nib[3]));
+
+	// Get GF calc results for high bytes
+	*acc_h = veorq_u8(*acc_h, vqtbl1q_u8(vld1q_u8(tb + 16), nib[0]));
+	*acc_h = veorq_u8(*acc_h, vqtbl1q_u8(vld1q_u8(tb + 48), nib[1]));
+	*acc_h = veorq_u8(*acc_h, vqtbl1q_u8(vld1q_u8(tb + 80), nib[2]));
+	*acc_h = veorq_u8(*acc_h, vqtbl1q_u8(vld1q_u8(tb + 112), nib[3]));
+}
+
+// NEON -- every 32 bytes for t rows
+static GF_INLINE size_t
+GF16encTileNEON(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		size_t off, uint8_t * const *dsts, const int t, size_t len,
+		int xor)
+{
+	int		i, r;
+	size_t		n;
+	uint8x16x2_t	input_v, output_v;
+	uint8x16_t	nib[4], tmp;
+	uint8x16_t	acc_l[GF_ENC_TILE], acc_h[GF_ENC_TILE];
+
+	tmp = vdupq_n_u8(0x0f);
+	for (n = 0; n + 32 <= len; n += 32) { // Do every 128 * 2bit
+		for (r = 0; r < t; r++) {
+			acc_l[r] = acc_h[r] = vdupq_n_u8(0);
+		}
+		for (i = 0; i < k; i++) {
+			// Load interleaved inputs once for all rows
+			input_v = vld2q_u8(srcs[i] + off + n);
+			nib[0] = vandq_u8(input_v.val[0], tmp);
+			nib[1] = vshrq_n_u8(input_v.val[0], 4);
+			nib[2] = vandq_u8(input_v.val[1], tmp);
+			nib[3] = vshrq_n_u8(input_v.val[1], 4);
+			for (r = 0; r < t; r++) {
+				GF16dotAccNEON(gf_tb + ((r * k + i) << 7), nib,
+					       &acc_l[r], &acc_h[r]);
+			}
+		}
+
+		// XOR into dsts[r] if xor and save interleaved results
+		for (r = 0; r < t; r++) {
+			if (xor) {
+				output_v = vld2q_u8(dsts[r] + off + n);
+				acc_l[r] = veorq_u8(acc_l[r], output_v.val[0]);
+				acc_h[r] = veorq_u8(acc_h[r], output_v.val[1]);
+			}
+			output_v.val[0] = acc_l[r];
+			output_v.val[1] = acc_h[r];
+			vst2q_u8(dsts[r] + off + n, output_v);
+		}
+	}
+
+	return n;
+}
+
+// Calculate t (GF_ENC_TILE or less) rows of encoding at once
+static size_t
+GF16encRegionNEON(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		  size_t off, uint8_t * const *dsts, int t, size_t len,
+		  int xor)
+{
+	// Make t constant so that accumulators are kept in registers
+	switch (t) {
+	case 1:
+		return GF16encTileNEON(gf_tb, srcs, k, off, dsts, 1, len, xor);
+	case 2:
+		return GF16encTileNEON(gf_tb, srcs, k, off, dsts, 2, len, xor);
+	case 3:
+		return GF16encTileNEON(gf_tb, srcs, k, off, dsts, 3, len, xor);
+	default:
+		return GF16encTileNEON(gf_tb, srcs, k, off, dsts, 4, len, xor);
+	}
+}
+#endif
+
+// Dot product kernel selected by GFsetSIMD()
+static size_t	(*GF16dotRegionSIMD)(const uint8_t *, const uint8_t * const *,
+				     int, size_t, uint8_t *, size_t, int)
+			= GF16dotRegionNone;
+
+// Encoding kernel selected by GFsetSIMD()
+static size_t	(*GF16encRegionSIMD)(const uint8_t *, const uint8_t * const *,
+				     int, size_t, uint8_t * const *, int,
+				     size_t, int)
+			= GF16encRegionNone;
+
+// Process 16bit words of dot product one by one with 4bit tables
+static inline void
+GF16dotRegionScalar(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		    size_t off, uint8_t *dst, size_t len, int xor)
+{
+	int		i;
+	size_t		n;
+	uint16_t	acc, x;
+
+	for (n = 0; n + 2 <= len; n += 2) {
+		acc = xor ? dst[n] | (dst[n + 1] << 8) : 0;
+		for (i = 0; i < k; i++) {
+			x = srcs[i][off + n] | (srcs[i][off + n + 1] << 8);
+			acc ^= GF16Lkup4bitRT(gf_tb + (i << 7), x);
+		}
+		dst[n] = acc & 0xff;
+		dst[n + 1] = acc >> 8;
+	}
+}
+
+// Body of GF16dotRegion()
+// k must be GF_DOT_MAX or less.
+static void
+GF16dotRegionBody(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		  uint8_t *dst, size_t len, int xor)
+{
+	size_t	n, off;
+
+	// Align dst for SIMD stores
+	// (impossible if dst is at odd address)
+	n = (GFalign - ((uintptr_t)dst & (GFalign - 1))) & (GFalign - 1);
+	if (len < GFalign * 4 || (n & 1)) {
+		n = 0;
+	}
+	GF16dotRegionScalar(gf_tb, srcs, k, 0, dst, n, xor);
+	off = n;
+
+	// SIMD
+	off += GF16dotRegionSIMD(gf_tb, srcs, k, off, dst + off, len - off,
+				 xor);
+
+	// Tail (odd byte at the end, if any, is left untouched)
+	GF16dotRegionScalar(gf_tb, srcs, k, off, dst + off, len - off, xor);
+}
+
+// Calculate dot product of k regions and coefficients such as:
+//     dst[n] = coefs[0] * srcs[0][n] + ... + coefs[k - 1] * srcs[k - 1][n]
+// It is one row of Reed-Solomon encoding. dst[] is streamed only once
+// (every GF_DOT_MAX sources) instead of k times with GF16mulAddRegion(),
+// e.g. 4 times instead of 14 for 10 + 4 code.
+// Tables are built on stack once per call, so nothing is allocated.
+//
+// Args:
+//     dst: result region (little endian uint16_t)
+//     srcs: k source regions (little endian uint16_t)
+//     coefs: k coefficients
+//     k: # of sources
+//     len: length of each region in bytes (must be a multiple of 2)
+//
+// Usage:
+//     const uint8_t *data[10] = { ... };
+//     uint16_t coefs[10] = { ... };
+//     GF16dotRegion(parity, data, coefs, 10, len);
+//
+void
+GF16dotRegion(uint8_t *dst, const uint8_t * const *srcs,
+	      const uint16_t *coefs, int k, size_t len)
+{
+	GF16dotRegionCtx(&GF16ctxDef, dst, srcs, coefs, k, len);
+}
+
+// Same as GF16dotRegion() but in field ctx created by GF16crtCtx()
+void
+GF16dotRegionCtx(const GF16ctx *ctx, uint8_t *dst, const uint8_t * const *srcs,
+		 const uint16_t *coefs, int k, size_t len)
+{
+	int			i, j, n;
+	_Alignas(64) uint8_t	gf_tb[GF_DOT_MAX * 128];
+
+	// No source
+	if (k <= 0) {
+		memset(dst, 0, len & ~(size_t)1);
+		return;
+	}
+
+	// Every GF_DOT_MAX sources
+	for (i = 0; i < k; i += n) {
+		n = k - i < GF_DOT_MAX ? k - i : GF_DOT_MAX;
+		for (j = 0; j < n; j++) {
+			GF16set4bitRegTblCtx(ctx, gf_tb + (j << 7),
+					     coefs[i + j], 0);
+		}
+		GF16dotRegionBody(gf_tb, srcs + i, n, dst, len, i > 0);
+	}
+}
+
+// Body of GF16encodeRegion()
+// t must be GF_ENC_TILE or less and k must be GF_DOT_MAX or less.
+static void
+GF16encRegionBody(const uint8_t *gf_tb, const uint8_t * const *srcs, int k,
+		  uint8_t * const *dsts, int t, size_t len, int xor)
+{
+	int	r;
+	size_t	n, off;
+
+	// Align first row for SIMD stores
+	// (impossible if it is at odd address)
+	n = (GFalign - ((uintptr_t)dsts[0] & (GFalign - 1))) & (GFalign - 1);
+	if (len < GFalign * 4 || (n & 1)) {
+		n = 0;
+	}
+	for (r = 0; r < t; r++) {
+		GF16dotRegionScalar(gf_tb + ((r * k) << 7), srcs, k, 0,
+				    dsts[r], n, xor);
+	}
+	off = n;
+
+	// SIMD
+	off += GF16encRegionSIMD(gf_tb, srcs, k, off, dsts, t, len - off,
+				 xor);
+
+	// Tail (odd byte at the end, if any, is left untouched)
+	for (r = 0; r < t; r++) {
+		GF16dotRegionScalar(gf_tb + ((r * k) << 7), srcs, k, off,
+				    dsts[r] + off, len - off, xor);
+	}
+}
+
+// Encode m parity regions from k data regions such as:
+//     parity[r][n] = matrix[r][0] * data[0][n] + ... +
+//                    matrix[r][k - 1] * data[k - 1][n]
+// This is GF16dotRegion() of m rows at once. Data are loaded once for
+// every GF_ENC_TILE (4) rows instead of m times, so input memory
+// bandwidth is cut by up to 4 (e.g. 12 + 4 code).
+// Tables are built on stack, so nothing is allocated.
+//
+// Args:
+//     parity: m parity regions (little endian uint16_t)
+//     data: k data regions (little endian uint16_t)
+//     matrix: m * k coefficients (row major, matrix[r * k + i])
+//     m: # of parity regions
+//     k: # of data regions
+//     len: length of each region in bytes (must be a multiple of 2)
+//
+// Usage:
+//     uint8_t *parity[4] = { ... };
+//     const uint8_t *data[12] = { ... };
+//     uint16_t matrix[4 * 12] = { ... };
+//     GF16encodeRegion(parity, data, matrix, 4, 12, len);
+//
+void
+GF16encodeRegion(uint8_t * const *parity, const uint8_t * const *data,
+		 const uint16_t *matrix, int m, int k, size_t len)
+{
+	GF16encodeRegionCtx(&GF16ctxDef, parity, data, matrix, m, k, len);
+}
+
+// Same as GF16encodeRegion() but in field ctx created by GF16crtCtx()
+void
+GF16encodeRegionCtx(const GF16ctx *ctx, uint8_t * const *parity,
+		    const uint8_t * const *data, const uint16_t *matrix,
+		    int m, int k, size_t len)
+{
+	int			i, n, r, t, x;
+	_Alignas(64) uint8_t	gf_tb[GF_ENC_TILE * GF_DOT_MAX * 128];
+
+	// Every GF_ENC_TILE rows
+	for (r = 0; r < m; r += t) {
+		t = m - r < GF_ENC_TILE ? m - r : GF_ENC_TILE;
+
+		// No data
+		if (k <= 0) {
+			for (x = 0; x < t; x++) {
+				memset(parity[r + x], 0, len & ~(size_t)1);
+			}
+			continue;
+		}
+
+		// Every GF_DOT_MAX data
+		for (i = 0; i < k; i += n) {
+			n = k - i < GF_DOT_MAX ? k - i : GF_DOT_MAX;
+			for (x = 0; x < t * n; x++) {
+				GF16set4bitRegTblCtx(ctx, gf_tb + (x << 7),
+					matrix[(r + x / n) * k + i + x % n], 0);
+			}
+			GF16encRegionBody(gf_tb, data + i, n, parity + r, t,
+					  len, i > 0);
+		}
+	}
+}
+
+/******************** Vector ********************/
+
+// Element-wise multiplication and division of two arrays such as:
+//     c[i] = a[i] * b[i] or c[i] = a[i] / b[i]
+// Region tables don't apply as both operands vary, so logs and antilogs
+// of GF16mul() are looked up by SIMD gathers (8 or 16 at once).
+// Kernels return the # of elements processed and the rest is done by
+// GF16mul() or GF16div().
+
+// Scale of gathers from GF16memIdx (logs are masked if uint16_t)
+#if defined(_GF16_COMPACT_)
+#define GF16_IDX_SCALE	2
+#else
+#define GF16_IDX_SCALE	4
+#endif
+
+// No SIMD
+static size_t
+GF16vecNone(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n,
+	    int div)
+{
+	return 0;
+}
+
+#if defined(_GF_X86_)
+// AVX2: 16 elements (2 x 8 lanes of 32bit) per loop
+GF_TARGET("avx2") static size_t
+GF16vecAVX2(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n,
+	    int div)
+{
+	size_t		i;
+	int		h;
+	const int	*idx = (const int *)GF16memIdx;
+	const int	*tbl = (const int *)(div ? GF16memH : GF16memL);
+	const __m256i	mask = _mm256_set1_epi32(0xffff);
+	__m256i		x_a, x_b, l_a, l_b, v[2];
+#if defined(_GF16_COMPACT_)
+	const __m256i	zero = _mm256_setzero_si256();
+	__m256i		z;
+#endif
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		for (h = 0; h < 2; h++) {
+			// Zero extend 8 elements to 32bit
+			x_a = _mm256_cvtepu16_epi32(_mm_loadu_si128(
+					(const __m128i *)(a + i + (h << 3))));
+			x_b = _mm256_cvtepu16_epi32(_mm_loadu_si128(
+					(const __m128i *)(b + i + (h << 3))));
+
+			// Logs
+			l_a = _mm256_i32gather_epi32(idx, x_a, GF16_IDX_SCALE);
+			l_b = _mm256_i32gather_epi32(idx, x_b, GF16_IDX_SCALE);
+#if defined(_GF16_COMPACT_)
+			l_a = _mm256_and_si256(l_a, mask);
+			l_b = _mm256_and_si256(l_b, mask);
+#endif
+
+			// Antilog of sum (or difference)
+			l_a = div ? _mm256_sub_epi32(l_a, l_b) :
+				    _mm256_add_epi32(l_a, l_b);
+			v[h] = _mm256_and_si256(
+				_mm256_i32gather_epi32(tbl, l_a, 2), mask);
+#if defined(_GF16_COMPACT_)
+			// No zero area: 0 * b, a * 0 and 0 / b are 0
+			z = _mm256_cmpeq_epi32(x_a, zero);
+			if (!div) {
+				z = _mm256_or_si256(z,
+					_mm256_cmpeq_epi32(x_b, zero));
+			}
+			v[h] = _mm256_andnot_si256(z, v[h]);
+#endif
+		}
+
+		// Pack to 16bit (packus works in each 128bit lane)
+		v[0] = _mm256_permute4x64_epi64(
+				_mm256_packus_epi32(v[0], v[1]), 0xd8);
+		_mm256_storeu_si256((__m256i *)(c + i), v[0]);
+	}
+
+	return i;
+}
+
+// AVX-512: 16 elements (16 lanes of 32bit) per loop
+GF_TARGET("avx512f,avx512bw") static size_t
+GF16vecAVX512(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n,
+	      int div)
+{
+	size_t		i;
+	const int	*idx = (const int *)GF16memIdx;
+	const int	*tbl = (const int *)(div ? GF16memH : GF16memL);
+	const __m512i	mask = _mm512_set1_epi32(0xffff);
+	__m512i		x_a, x_b, l_a, l_b, v;
+#if defined(_GF16_COMPACT_)
+	const __m512i	zero = _mm512_setzero_si512();
+	__mmask16	z;
+#endif
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		// Zero extend 16 elements to 32bit
+		x_a = _mm512_cvtepu16_epi32(_mm256_loadu_si256(
+				(const __m256i *)(a + i)));
+		x_b = _mm512_cvtepu16_epi32(_mm256_loadu_si256(
+				(const __m256i *)(b + i)));
+
+		// Logs
+		l_a = _mm512_i32gather_epi32(x_a, idx, GF16_IDX_SCALE);
+		l_b = _mm512_i32gather_epi32(x_b, idx, GF16_IDX_SCALE);
+#if defined(_GF16_COMPACT_)
+		l_a = _mm512_and_si512(l_a, mask);
+		l_b = _mm512_and_si512(l_b, mask);
+#endif
+
+		// Antilog of sum (or difference)
+		l_a = div ? _mm512_sub_epi32(l_a, l_b) :
+			    _mm512_add_epi32(l_a, l_b);
+		v = _mm512_and_si512(_mm512_i32gather_epi32(l_a, tbl, 2), mask);
+#if defined(_GF16_COMPACT_)
+		// No zero area: 0 * b, a * 0 and 0 / b are 0
+		z = _mm512_cmpeq_epi32_mask(x_a, zero);
+		if (!div) {
+			z |= _mm512_cmpeq_epi32_mask(x_b, zero);
+		}
+		v = _mm512_maskz_mov_epi32(~z, v);
+#endif
+
+		// Narrow to 16bit
+		_mm256_storeu_si256((__m256i *)(c + i),
+				    _mm512_cvtepi32_epi16(v));
+	}
+
+	return i;
+}
+#endif // _GF_X86_
+
+// Carry-less multiplication (GF_VEC_CLMUL, multiplication only)
+// a[i] * b[i] is computed without tables as a 31bit polynomial
+// product p and reduced by Barrett reduction with mu = x^32 / GF16_PRIM
+// (GF16clmulMu):
+//     q = ((p >> 16) * mu) >> 16, c = (p ^ q * GF16_PRIM) & 0xffff
+// where * is carry-less. Operands are zero extended to 32bit lanes,
+// so one 64x64 carry-less multiplication calculates two products
+// (a_0 + a_1 x^32) * (b_0 + b_1 x^32) with the cross terms in bit 32-62.
+
+#if defined(_GF_X86_)
+// Multiply 4 pairs in 32bit lanes of x and y (in each 128bit lane)
+// Products of lane 0-1 (imm 0x00) and 2-3 (0x11) are in dword 0 and 2,
+// and combined by unpacklo after moving dword 2 next to dword 0.
+#define GF16_CLMUL_X4(clmul, shuffle, unpacklo, x, y)			\
+	unpacklo(shuffle(clmul(x, y, 0x00), 0x08),			\
+		 shuffle(clmul(x, y, 0x11), 0x08))
+
+// Multiply 4 elements in 32bit lanes of x by constant k (< 2^17)
+// Products of lane 0-1 (imm 0x00) and 2-3 (0x01) are in dword 0 and 1.
+#define GF16_CLMUL_K4(clmul, unpacklo, x, k)				\
+	unpacklo(clmul(x, k, 0x00), clmul(x, k, 0x01))
+
+// PCLMULQDQ: 8 elements per loop
+GF_TARGET("pclmul,sse4.1") static size_t
+GF16vecPCLMUL(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n)
+{
+	size_t		i;
+	int		h;
+	const __m128i	mu = _mm_set_epi64x(0, GF16clmulMu);
+	const __m128i	poly = _mm_set_epi64x(0, GF16_PRIM & 0xffff);
+	const __m128i	mask = _mm_set1_epi32(0xffff);
+	__m128i		x, y, p, q, v[2];
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		for (h = 0; h < 2; h++) {
+			// Zero extend 4 elements to 32bit
+			x = _mm_cvtepu16_epi32(_mm_loadl_epi64(
+					(const __m128i *)(a + i + (h << 2))));
+			y = _mm_cvtepu16_epi32(_mm_loadl_epi64(
+					(const __m128i *)(b + i + (h << 2))));
+
+			// p = x * y
+			p = GF16_CLMUL_X4(_mm_clmulepi64_si128, _mm_shuffle_epi32,
+					  _mm_unpacklo_epi64, x, y);
+
+			// q = ((p >> 16) * mu) >> 16
+			q = _mm_srli_epi32(p, 16);
+			q = _mm_srli_epi32(GF16_CLMUL_K4(_mm_clmulepi64_si128,
+					_mm_unpacklo_epi64, q, mu), 16);
+
+			// p ^ q * GF16_PRIM (x^16 of GF16_PRIM is masked out)
+			q = GF16_CLMUL_K4(_mm_clmulepi64_si128,
+					  _mm_unpacklo_epi64, q, poly);
+			v[h] = _mm_and_si128(_mm_xor_si128(p, q), mask);
+		}
+		_mm_storeu_si128((__m128i *)(c + i),
+				 _mm_packus_epi32(v[0], v[1]));
+	}
+
+	return i;
+}
+
+// VPCLMULQDQ + AVX-512: 16 elements per loop (4 in each 128bit lane)
+GF_TARGET("vpclmulqdq,avx512f,avx512bw") static size_t
+GF16vecVPCLMUL(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n)
+{
+	size_t		i;
+	const __m512i	mu = _mm512_set4_epi32(0, 0, 0, GF16clmulMu);
+	const __m512i	poly = _mm512_set4_epi32(0, 0, 0, GF16_PRIM & 0xffff);
+	const __m512i	mask = _mm512_set1_epi32(0xffff);
+	__m512i		x, y, p, q;
+
+	for (i = 0; i + 16 <= n; i += 16) {
+		// Zero extend 16 elements to 32bit
+		x = _mm512_cvtepu16_epi32(_mm256_loadu_si256(
+				(const __m256i *)(a + i)));
+		y = _mm512_cvtepu16_epi32(_mm256_loadu_si256(
+				(const __m256i *)(b + i)));
+
+		// p = x * y
+		p = GF16_CLMUL_X4(_mm512_clmulepi64_epi128, _mm512_shuffle_epi32,
+				  _mm512_unpacklo_epi64, x, y);
+
+		// q = ((p >> 16) * mu) >> 16
+		q = _mm512_srli_epi32(p, 16);
+		q = _mm512_srli_epi32(GF16_CLMUL_K4(_mm512_clmulepi64_epi128,
+				_mm512_unpacklo_epi64, q, mu), 16);
+
+		// p ^ q * GF16_PRIM
+		q = GF16_CLMUL_K4(_mm512_clmulepi64_epi128,
+				  _mm512_unpacklo_epi64, q, poly);
+		p = _mm512_and_si512(_mm512_xor_si512(p, q), mask);
+
+		// Narrow to 16bit
+		_mm256_storeu_si256((__m256i *)(c + i),
+				    _mm512_cvtepi32_epi16(p));
+	}
+
+	return i;
+}
+#elif defined(_arm64_) && \
+      (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#define _GF16_PMULL_
+// Multiply 2 pairs in 32bit lanes 0-1 of x and y by PMULL
+// The result has the products in 32bit lanes 0 and 2.
+static inline uint32x4_t
+GF16pmull2(uint32x4_t x, uint32x4_t y)
+{
+	return vreinterpretq_u32_p128(vmull_p64(
+		(poly64_t)vgetq_lane_u64(vreinterpretq_u64_u32(x), 0),
+		(poly64_t)vgetq_lane_u64(vreinterpretq_u64_u32(y), 0)));
+}
+
+// Multiply 4 pairs in 32bit lanes of x and y
+static inline uint32x4_t
+GF16pmull4(uint32x4_t x, uint32x4_t y)
+{
+	uint32x4_t	lo, hi;
+
+	lo = GF16pmull2(x, y);
+	hi = GF16pmull2(vextq_u32(x, x, 2), vextq_u32(y, y, 2));
+
+	// Lanes 0 and 2 of lo and hi
+	return vuzp1q_u32(lo, hi);
+}
+
+// Multiply 4 elements in 32bit lanes of x by constant k (< 2^17)
+// Products of lane 0-1 are in lanes 0 and 1.
+static inline uint32x4_t
+GF16pmullK4(uint32x4_t x, uint32x4_t k)
+{
+	uint32x4_t	lo, hi;
+
+	lo = GF16pmull2(x, k);
+	hi = GF16pmull2(vextq_u32(x, x, 2), k);
+
+	// Lanes 0 and 1 of lo and hi
+	return vcombine_u32(vget_low_u32(lo), vget_low_u32(hi));
+}
+
+// PMULL: 8 elements per loop
+static size_t
+GF16vecPMULL(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n)
+{
+	size_t		i;
+	int		h;
+	const uint32x4_t	mu = vcombine_u32(vcreate_u32(GF16clmulMu),
+					      vcreate_u32(0));
+	const uint32x4_t	poly = vcombine_u32(vcreate_u32(GF16_PRIM & 0xffff),
+						vcreate_u32(0));
+	uint16x8_t	x8, y8;
+	uint32x4_t	x, y, p, q;
+	uint16x4_t	v[2];
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		x8 = vld1q_u16(a + i);
+		y8 = vld1q_u16(b + i);
+		for (h = 0; h < 2; h++) {
+			// Zero extend 4 elements to 32bit
+			x = h ? vmovl_high_u16(x8) : vmovl_u16(vget_low_u16(x8));
+			y = h ? vmovl_high_u16(y8) : vmovl_u16(vget_low_u16(y8));
+
+			// p = x * y
+			p = GF16pmull4(x, y);
+
+			// q = ((p >> 16) * mu) >> 16
+			q = vshrq_n_u32(GF16pmullK4(vshrq_n_u32(p, 16), mu), 16);
+
+			// p ^ q * GF16_PRIM (low 16bit only)
+			v[h] = vmovn_u32(veorq_u32(p, GF16pmullK4(q, poly)));
+		}
+		vst1q_u16(c + i, vcombine_u16(v[0], v[1]));
+	}
+
+	return i;
+}
+#endif // _GF_X86_ || _GF16_PMULL_
+
+// Vector kernel selected by GFsetSIMD()
+static size_t	(*GF16vecSIMD)(uint16_t *, const uint16_t *, const uint16_t *,
+			       size_t, int)
+			= GF16vecNone;
+
+// Carry-less multiplication kernel selected by GFsetSIMD() (NULL if none)
+static size_t	(*GF16vecCLMUL)(uint16_t *, const uint16_t *, const uint16_t *,
+				size_t) = NULL;
+static int	GF16vec = GF_VEC_TABLE;	// Backend of GF16mulVec()
+
+// Select backend of GF16mulVec()
+// GF_VEC_CLMUL doesn't use tables (except for the last n % 16 elements),
+// so it avoids cache misses when the 768kB tables are evicted by others.
+// Call after GF16init(). Environment variable GF_VEC ("table" or "clmul")
+// does the same in GF16init().
+//
+// Args:
+//     vec: GF_VEC_TABLE or GF_VEC_CLMUL
 //
 // Return value:
-//     pointer to lowest byte table or NULL if failed. Free it later.
+//     0 if succeeded, -1 if not supported by CPU
+//
+int
+GF16setVec(int vec)
+{
+	switch (vec) {
+	case GF_VEC_TABLE:
+		break;
+	case GF_VEC_CLMUL:
+		if (GF16vecCLMUL == NULL) {
+			fprintf(stderr, "Error: %s: Carry-less multiplication "
+				"is not supported by CPU or %s\n",
+				__func__, GFnameSIMD(GFsimd));
+			return -1;
+		}
+		break;
+	default:
+		fprintf(stderr, "Error: %s: Illegal backend: %d\n",
+			__func__, vec);
+		return -1;
+	}
+	GF16vec = vec;
+
+	return 0;
+}
+
+// Get backend of GF16mulVec()
+int
+GF16getVec(void)
+{
+	return GF16vec;
+}
+
+// Calculate c[i] = a[i] * b[i] (i = 0, ..., n - 1)
 //
-// How to use:
-//    For a * x[i],
-//        uint16_t *gf_a_l = GF16crtSpltRegTbl(a, 0);
-//        uint16_t *gf_a_h = gf_a_l + 256;
-//        uint16_t xi;
-//        for (i = 0; i < N; i++) {
-//            xi = x[i];
-//            y[i] = gf_a_h[xi >> 8] ^ gf_a_l[xi & 0xff]; // = GFmul(a, x[i]);
-//            // Or use y[i] = GF16LkupSRT(gf_a_l, gf_a_h, xi);
-//        }
-//        free(gf_a_l);
+// Args:
+//     c: results (may be a or b)
+//     a, b: operands
+//     n: # of elements
 //
-//    For x[i] / a,
-//        uint16_t *gf_a_l = GF16crtSpltRegTbl(a, 1);
-//        uint16_t *gf_a_h = gf_a_l + 256;
-//        uint16_t xi;
-//        for (i = 0; i < N; i++) {
-//            xi = x[i];
-//            y[i] = gf_a_h[xi >> 8] ^ gf_a_l[xi & 0xff]; // = GFdiv(x[i], a);
-//            // Or use y[i] = GF16LkupSRT(gf_a_l, gf_a_h, xi);
-//        }
-//        free(gf_a_l);
+// Usage:
+//     uint16_t a[N], b[N], c[N];
+//     GF16mulVec(c, a, b, N); // Same as c[i] = GF16mul(a[i], b[i])
 //
-uint16_t *
-GF16crtSpltRegTbl(uint16_t a, int type)
+void
+GF16mulVec(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n)
 {
-	int		i;
-	uint16_t	*tb_h, *tb_l, *a_addr;
+	size_t	i;
 
-	// Initialize
-	tb_l = NULL;
+	i = (GF16vec == GF_VEC_CLMUL && GF16vecCLMUL != NULL) ?
+		GF16vecCLMUL(c, a, b, n) : GF16vecSIMD(c, a, b, n, 0);
+	for (; i < n; i++) {
+		c[i] = GF16mul(a[i], b[i]);
+	}
+}
 
-	// Allocate table
-	if ((tb_l = (uint16_t *)
-			aligned_alloc(64, 256 * sizeof(uint16_t) * 2))
-				== NULL) {
-		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
-			__func__, strerror(errno));
-		return NULL;
+// Calculate c[i] = a[i] / b[i] (i = 0, ..., n - 1; b[i] must not be 0)
+void
+GF16divVec(uint16_t *c, const uint16_t *a, const uint16_t *b, size_t n)
+{
+	size_t	i;
+
+	for (i = GF16vecSIMD(c, a, b, n, 1); i < n; i++) {
+		c[i] = GF16div(a[i], b[i]);
 	}
-	tb_h = tb_l + 256;
-	memset(tb_l, 0, 256 * sizeof(uint16_t) * 2);
+}
 
-	// Input values
-	switch (type) {
-	case 0: // a * x[i]
-		a_addr = GF16memL + GF16memIdx[a];
+/**************************************************************************
+	Common
+**************************************************************************/
 
-		// Input values
-		for (i = 0; i < 256; i++) {
-			tb_l[i] = a_addr[GF16memIdx[i]];
-			tb_h[i] = a_addr[GF16memIdx[i << 8]];
-		}
-		break;
+// Names of SIMD instruction sets (index is GF_SIMD_*)
+static const char	*GFsimdName[] = {
+	"none", "ssse3", "avx2", "avx512", "neon", "avx2-gfni", "avx512-gfni"
+};
+#define GF_SIMD_NUM	(int)(sizeof(GFsimdName) / sizeof(GFsimdName[0]))
 
-	case 1: // x[i] / a
-		a_addr = GF16memH - GF16memIdx[a];
+// Get name of SIMD instruction set
+const char *
+GFnameSIMD(int simd)
+{
+	if (simd < 0 || simd >= GF_SIMD_NUM) {
+		return "unknown";
+	}
 
-		// Input values
-		for (i = 0; i < 256; i++) {
-			tb_l[i] = a_addr[GF16memIdx[i]];
-			tb_h[i] = a_addr[GF16memIdx[i << 8]];
-		}
-		break;
+	return GFsimdName[simd];
+}
 
+// Check if CPU supports SIMD instruction set
+static int
+GFsupportSIMD(int simd)
+{
+#if defined(_GF_X86_) && (defined(__GNUC__) || defined(__clang__))
+	// Probe CPUID (this also checks if OS saves AVX registers)
+	__builtin_cpu_init();
+	switch (simd) {
+	case GF_SIMD_NONE:
+		return 1;
+	case GF_SIMD_SSSE3:
+		return __builtin_cpu_supports("ssse3");
+	case GF_SIMD_AVX2:
+		return __builtin_cpu_supports("avx2");
+	case GF_SIMD_AVX512:
+		return __builtin_cpu_supports("avx512bw");
+	case GF_SIMD_AVX2_GFNI:
+		return __builtin_cpu_supports("avx2") &&
+		       __builtin_cpu_supports("gfni");
+	case GF_SIMD_AVX512_GFNI:
+		return __builtin_cpu_supports("avx512bw") &&
+		       __builtin_cpu_supports("gfni");
 	default:
-		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
-			"(value must be 0, 1, or 2)\n",
-			__func__, type);
-		free(tb_l);
-		return NULL;
+		return 0;
+	}
+#elif defined(_arm64_)
+	return simd == GF_SIMD_NONE || simd == GF_SIMD_NEON;
+#else
+	return simd == GF_SIMD_NONE;
+#endif
+}
+
+// Detect the best SIMD instruction set supported by CPU
+int
+GFdetectSIMD(void)
+{
+	static const int	pref[] = { // In order of preference
+		GF_SIMD_AVX512_GFNI, GF_SIMD_AVX512, GF_SIMD_AVX2_GFNI,
+		GF_SIMD_AVX2, GF_SIMD_SSSE3, GF_SIMD_NEON
+	};
+	int			i;
+
+	for (i = 0; i < (int)(sizeof(pref) / sizeof(pref[0])); i++) {
+		if (GFsupportSIMD(pref[i])) {
+			return pref[i];
+		}
 	}
 
-	return tb_l;
+	return GF_SIMD_NONE;
 }
 
-// Create 4bit split tables for regional calculation such as:
-//     a * x[i]
-//     x[i] / a
-// This is basically used with SIMD (SSE/NEON).
+// Select SIMD instruction set for region calculation
+// GF8init() and GF16init() call this with the best one, so call this
+// only when you want to pin one (e.g. for benchmarking).
 //
 // Args:
-//     a: static value in regional calculation (or coefficient)
-//     type: 0: a * x[i]
-//           1: x[i] / a
+//     simd: GF_SIMD_*
 //
 // Return value:
-//     pointer to lowest table or NULL if failed. Free it later.
+//     0 if succeeded, -1 if not supported by CPU
 //
-// Usage:
-//     use with GF16lkupSIMD128x2 in gf.h.
-//     See gf-bench/multiplication/gf-nishida-region-16/gf-bench*.c
-//     for more details.
-//
-uint8_t *
-GF16crt4bitRegTbl(uint16_t a, int type)
+int
+GFsetSIMD(int simd)
 {
-	int		i;
-	uint8_t		*tb_0_l, *tb_0_h, *tb_1_l, *tb_1_h;
-	uint8_t		*tb_2_l, *tb_2_h, *tb_3_l, *tb_3_h;
-	uint16_t	 *a_addr, tmp;
+	// Check if CPU supports simd
+	if (!GFsupportSIMD(simd)) {
+		fprintf(stderr, "Error: %s: %s is not supported by CPU\n",
+			__func__, GFnameSIMD(simd));
+		return -1;
+	}
 
-	// Initialize
-	tb_0_l = NULL;
+	// Bind region kernels
+	switch (simd) {
+#if defined(_GF_X86_)
+	case GF_SIMD_SSSE3:
+		GF8lkupRegionSIMD = GF8lkupRegionSSSE3;
+		GF16lkupRegionSIMD = GF16lkupRegionSSSE3;
+		GF8dotRegionSIMD = GF8dotRegionSSSE3;
+		GF16dotRegionSIMD = GF16dotRegionSSSE3;
+		GF16encRegionSIMD = GF16encRegionSSSE3;
+		GF16vecSIMD = GF16vecNone;
+		GFalign = 16;
+		break;
 
-	// Allocate table
-	if ((tb_0_l = (uint8_t *)aligned_alloc(64, 16 * 8)) == NULL) {
-		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
-			__func__, strerror(errno));
-		return NULL;
+	case GF_SIMD_AVX2:
+		GF8lkupRegionSIMD = GF8lkupRegionAVX2;
+		GF16lkupRegionSIMD = GF16lkupRegionAVX2;
+		GF8dotRegionSIMD = GF8dotRegionAVX2;
+		GF16dotRegionSIMD = GF16dotRegionAVX2;
+		GF16encRegionSIMD = GF16encRegionAVX2;
+		GF16vecSIMD = GF16vecAVX2;
+		GFalign = 32;
+		break;
+
+	case GF_SIMD_AVX512:
+		GF8lkupRegionSIMD = GF8lkupRegionAVX512;
+		GF16lkupRegionSIMD = GF16lkupRegionAVX512;
+		GF8dotRegionSIMD = GF8dotRegionAVX512;
+		GF16dotRegionSIMD = GF16dotRegionAVX512;
+		GF16encRegionSIMD = GF16encRegionAVX512;
+		GF16vecSIMD = GF16vecAVX512;
+		GFalign = 64;
+		break;
+
+	case GF_SIMD_AVX2_GFNI:
+		GF8lkupRegionSIMD = GF8affineRegionAVX2;
+		GF16lkupRegionSIMD = GF16affineRegionAVX2;
+		GF8dotRegionSIMD = GF8dotRegionAffineAVX2;
+		GF16dotRegionSIMD = GF16dotRegionAffineAVX2;
+		GF16encRegionSIMD = GF16encRegionAffineAVX2;
+		GF16vecSIMD = GF16vecAVX2;
+		GFalign = 32;
+		break;
+
+	case GF_SIMD_AVX512_GFNI:
+		GF8lkupRegionSIMD = GF8affineRegionAVX512;
+		GF16lkupRegionSIMD = GF16affineRegionAVX512;
+		GF8dotRegionSIMD = GF8dotRegionAffineAVX512;
+		GF16dotRegionSIMD = GF16dotRegionAffineAVX512;
+		GF16encRegionSIMD = GF16encRegionAffineAVX512;
+		GF16vecSIMD = GF16vecAVX512;
+		GFalign = 64;
+		break;
+#elif defined(_arm64_) // NEON
+	case GF_SIMD_NEON:
+		GF8lkupRegionSIMD = GF8lkupRegionNEON;
+		GF16lkupRegionSIMD = GF16lkupRegionNEON;
+		GF8dotRegionSIMD = GF8dotRegionNEON;
+		GF16dotRegionSIMD = GF16dotRegionNEON;
+		GF16encRegionSIMD = GF16encRegionNEON;
+		GF16vecSIMD = GF16vecNone;
+		GFalign = 16;
+		break;
+#endif
+
+	default: // No SIMD
+		GF8lkupRegionSIMD = GF8lkupRegionNone;
+		GF16lkupRegionSIMD = GF16lkupRegionNone;
+		GF8dotRegionSIMD = GF8dotRegionNone;
+		GF16dotRegionSIMD = GF16dotRegionNone;
+		GF16encRegionSIMD = GF16encRegionNone;
+		GF16vecSIMD = GF16vecNone;
+		GFalign = 1;
+		break;
 	}
-	tb_0_h = tb_0_l + 16;
-	tb_1_l = tb_0_h + 16;
-	tb_1_h = tb_1_l + 16;
-	tb_2_l = tb_1_h + 16;
-	tb_2_h = tb_2_l + 16;
-	tb_3_l = tb_2_h + 16;
-	tb_3_h = tb_3_l + 16;
+	GFsimd = simd;
 
-	// Input values
-	switch (type) {
-	case 0: // a * x[i]
-		a_addr = GF16memL + GF16memIdx[a];
+	// Bind carry-less multiplication kernel for GF16mulVec()
+	GF16vecCLMUL = NULL;
+#if defined(_GF_X86_) && (defined(__GNUC__) || defined(__clang__))
+	if (simd != GF_SIMD_NONE && __builtin_cpu_supports("pclmul") &&
+	    __builtin_cpu_supports("sse4.1")) {
+		GF16vecCLMUL = GF16vecPCLMUL;
+		if ((simd == GF_SIMD_AVX512 || simd == GF_SIMD_AVX512_GFNI) &&
+		    __builtin_cpu_supports("vpclmulqdq")) {
+			GF16vecCLMUL = GF16vecVPCLMUL;
+		}
+	}
+#elif defined(_GF16_PMULL_)
+	if (simd == GF_SIMD_NEON) {
+		GF16vecCLMUL = GF16vecPMULL;
+	}
+#endif
 
-		// Input values
-		for (i = 0; i < 16; i++) {
-			tmp = a_addr[GF16memIdx[i]];
-			tb_0_l[i] = tmp & 0xff;
-			tb_0_h[i] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 4]];
-			tb_1_l[i] = tmp & 0xff;
-			tb_1_h[i] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 8]];
-			tb_2_l[i] = tmp & 0xff;
-			tb_2_h[i] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 12]];
-			tb_3_l[i] = tmp & 0xff;
-			tb_3_h[i] = tmp >> 8;
+	return 0;
+}
+
+// Get SIMD instruction set selected
+int
+GFgetSIMD(void)
+{
+	return GFsimd;
+}
+
+// Select the best SIMD instruction set once
+// Environment variable GF_SIMD overrides it.
+static void
+GFinitSIMD(void)
+{
+	int		simd;
+	const char	*env;
+
+	// Already selected
+	if (GFsimd >= 0) {
+		return;
+	}
+
+	// Check GF_SIMD
+	if ((env = getenv("GF_SIMD")) != NULL && *env != '\0') {
+		for (simd = 0; simd < GF_SIMD_NUM; simd++) {
+			if (strcasecmp(env, GFsimdName[simd]) == 0) {
+				break;
+			}
 		}
-		break;
+		if (simd >= GF_SIMD_NUM) {
+			fprintf(stderr, "Error: %s: Illegal GF_SIMD value: %s "
+				"(value must be none, ssse3, avx2, avx512, "
+				"neon, avx2-gfni or avx512-gfni)\n",
+				__func__, env);
+		}
+		else {
+			GFsetSIMD(simd);
+		}
+	}
 
-	case 1: // x[i] / a
-		a_addr = GF16memH - GF16memIdx[a];
+	// Select the best one
+	if (GFsimd < 0) {
+		GFsetSIMD(GFdetectSIMD());
+	}
 
-		// Input values
-		for (i = 0; i < 16; i++) {
-			tmp = a_addr[GF16memIdx[i]];
-			tb_0_l[i] = tmp & 0xff;
-			tb_0_h[i] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 4]];
-			tb_1_l[i] = tmp & 0xff;
-			tb_1_h[i] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 8]];
-			tb_2_l[i] = tmp & 0xff;
-			tb_2_h[i] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 12]];
-			tb_3_l[i] = tmp & 0xff;
-			tb_3_h[i] = tmp >> 8;
+	// Check GF_VEC (backend of GF16mulVec())
+	if ((env = getenv("GF_VEC")) != NULL && *env != '\0') {
+		if (strcasecmp(env, "table") == 0) {
+			GF16setVec(GF_VEC_TABLE);
 		}
-		break;
+		else if (strcasecmp(env, "clmul") == 0) {
+			GF16setVec(GF_VEC_CLMUL);
+		}
+		else {
+			fprintf(stderr, "Error: %s: Illegal GF_VEC value: %s "
+				"(value must be table or clmul)\n",
+				__func__, env);
+		}
+	}
+}
 
-	default:
-		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
-			"(value must be 0, 1, or 2)\n",
-			__func__, type);
-		free(tb_0_l);
-		return NULL;
+/******************** Table file ********************/
+
+// File of tables written by GFsaveTbl()
+// The header is followed by sections aligned to pages, which are mapped
+// read-only by GF8initFromFile() and GF16initFromFile().
+#define GF_TBL_MAGIC	"GFTABLE"	// 8 bytes with '\0'
+#define GF_TBL_ENDIAN	0x01020304	// Byte order check
+#define GF_TBL_ALIGN	4096		// Alignment of sections
+#define GF_TBL_GF8	0		// GF8memMul and GF8memDiv (128kB)
+#define GF_TBL_GF16L	1		// GF16memL
+#define GF_TBL_GF16IDX	2		// GF16memIdx
+#define GF_TBL_SEC_NUM	3
+
+typedef struct {
+	char		magic[8];	// GF_TBL_MAGIC
+	uint32_t	version;	// GF_TBL_VERSION
+	uint32_t	endian;		// GF_TBL_ENDIAN
+	uint32_t	gf8_prim;	// GF8_PRIM
+	uint32_t	gf16_prim;	// GF16_PRIM
+	uint32_t	gf16_compact;	// 1 with _GF16_COMPACT_
+	uint32_t	gf16_idx_size;	// sizeof(GF16idx)
+	uint64_t	off[GF_TBL_SEC_NUM];	// Offsets of sections
+	uint64_t	len[GF_TBL_SEC_NUM];	// Lengths of sections
+	uint64_t	sum[GF_TBL_SEC_NUM];	// Checksums of sections
+} GFtblHdr;
+
+// Checksum of section (FNV-1a over 64bit words)
+static uint64_t
+GFtblSum(const uint8_t *p, size_t len)
+{
+	size_t		i;
+	uint64_t	sum, w;
+
+	sum = 0xcbf29ce484222325ULL;
+	for (i = 0; i + 8 <= len; i += 8) {
+		memcpy(&w, p + i, 8);
+		sum = (sum ^ w) * 0x100000001b3ULL;
+	}
+	for (; i < len; i++) {
+		sum = (sum ^ p[i]) * 0x100000001b3ULL;
 	}
 
-	return tb_0_l;
+	return sum;
 }
 
-// Same as GF16crt4bitRegTbl() but for 256bit SIMD like AVX
+// Fill header except offsets and checksums
+static void
+GFtblSetHdr(GFtblHdr *hdr)
+{
+	memset(hdr, 0, sizeof(GFtblHdr));
+	memcpy(hdr->magic, GF_TBL_MAGIC, sizeof(hdr->magic));
+	hdr->version = GF_TBL_VERSION;
+	hdr->endian = GF_TBL_ENDIAN;
+	hdr->gf8_prim = GF8_PRIM;
+	hdr->gf16_prim = GF16_PRIM;
+#if defined(_GF16_COMPACT_)
+	hdr->gf16_compact = 1;
+#endif
+	hdr->gf16_idx_size = sizeof(GF16idx);
+	hdr->len[GF_TBL_GF8] = sizeof(uint8_t) * GF8_SIZE * GF8_SIZE * 2;
+	hdr->len[GF_TBL_GF16L] = sizeof(uint16_t) * GF16_MEML_NUM;
+	hdr->len[GF_TBL_GF16IDX] = sizeof(GF16idx) * GF16_MEMIDX_NUM;
+}
+
+// Write all of buf at off
+static int
+GFtblWrite(int fd, const void *buf, size_t len, off_t off)
+{
+	ssize_t	n;
+
+	while (len > 0) {
+		if ((n = pwrite(fd, buf, len, off)) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		buf = (const uint8_t *)buf + n;
+		len -= n;
+		off += n;
+	}
+
+	return 0;
+}
+
+// Save tables of GF8init() and GF16init() to file for GF8initFromFile()
+// and GF16initFromFile()
+// The header records GF_TBL_VERSION, GF8_PRIM, GF16_PRIM, the layout
+// (_GF16_COMPACT_, byte order) and checksums of tables. The file is
+// replaced atomically, so processes never map a partial one.
 //
 // Args:
-//     a: static value in regional calculation (or coefficient)
-//     type: 0: a * x[i]
-//           1: x[i] / a
+//     path: file name
 //
 // Return value:
-//     pointer to lowest table or NULL if failed. Free it later.
+//     0 or -1 if failed
 //
 // Usage:
-//     use with GF16lkupSIMD256x2 in gf.h.
-//     See gf-bench/multiplication/gf-nishida-region-16/gf-bench*.c
-//     for more details.
+//     GF8init();
+//     GF16init();
+//     GFsaveTbl("/var/lib/app/gf.tbl");
 //
-uint8_t *
-GF16crt4bitRegTbl256(uint16_t a, int type)
+int
+GFsaveTbl(const char *path)
 {
-	int		i, i_16;
-	uint8_t		*tb_0_l, *tb_0_h, *tb_1_l, *tb_1_h;
-	uint8_t		*tb_2_l, *tb_2_h, *tb_3_l, *tb_3_h;
-	uint16_t	 *a_addr, tmp;
+	int		i, fd;
+	const void	*sec[GF_TBL_SEC_NUM];
+	char		*tmp;
+	uint64_t	off;
+	GFtblHdr	hdr;
 
-	// Initialize
-	tb_0_l = NULL;
+	// Check tables
+	if (GF8memMul == NULL || GF16memL == NULL) {
+		fprintf(stderr, "Error: %s: Call GF8init() and GF16init() "
+			"first\n", __func__);
+		return -1;
+	}
 
-	// Allocate table
-	if ((tb_0_l = (uint8_t *)aligned_alloc(64, 256)) == NULL) {
-		fprintf(stderr, "Error: %s: aligned_alloc: %s\n",
+	// Set header
+	GFtblSetHdr(&hdr);
+	sec[GF_TBL_GF8] = GF8memMul; // GF8memDiv follows
+	sec[GF_TBL_GF16L] = GF16memL;
+	sec[GF_TBL_GF16IDX] = GF16memIdx;
+	off = GF_TBL_ALIGN;
+	for (i = 0; i < GF_TBL_SEC_NUM; i++) {
+		hdr.off[i] = off;
+		hdr.sum[i] = GFtblSum(sec[i], hdr.len[i]);
+		off += (hdr.len[i] + GF_TBL_ALIGN - 1) &
+		       ~(uint64_t)(GF_TBL_ALIGN - 1);
+	}
+
+	// Write to temporary file and rename it
+	if ((tmp = (char *)malloc(strlen(path) + 8)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
 			__func__, strerror(errno));
+		return -1;
+	}
+	sprintf(tmp, "%s.XXXXXX", path);
+	if ((fd = mkstemp(tmp)) < 0) {
+		fprintf(stderr, "Error: %s: mkstemp: %s: %s\n",
+			__func__, tmp, strerror(errno));
+		free(tmp);
+		return -1;
+	}
+	if (GFtblWrite(fd, &hdr, sizeof(hdr), 0) < 0) {
+		goto err;
+	}
+	for (i = 0; i < GF_TBL_SEC_NUM; i++) {
+		if (GFtblWrite(fd, sec[i], hdr.len[i], hdr.off[i]) < 0) {
+			goto err;
+		}
+	}
+	if (fchmod(fd, 0644) < 0 || fsync(fd) < 0) {
+		goto err;
+	}
+	if (close(fd) < 0) {
+		fd = -1;
+		goto err;
+	}
+	if (rename(tmp, path) < 0) {
+		fprintf(stderr, "Error: %s: rename: %s: %s\n",
+			__func__, path, strerror(errno));
+		unlink(tmp);
+		free(tmp);
+		return -1;
+	}
+	free(tmp);
+
+	return 0;
+
+err:
+	fprintf(stderr, "Error: %s: Failed to write %s: %s\n",
+		__func__, tmp, strerror(errno));
+	if (fd >= 0) {
+		close(fd);
+	}
+	unlink(tmp);
+	free(tmp);
+	return -1;
+}
+
+// Map file of GFsaveTbl() read-only and check header and checksums of
+// sections first to last
+//
+// Return value:
+//     pointer to header (beginning of file) or NULL if failed
+//
+static const GFtblHdr *
+GFmapTbl(const char *path, int first, int last)
+{
+	int		i, fd;
+	struct stat	st;
+	const GFtblHdr	*hdr;
+	const uint8_t	*p;
+	GFtblHdr	exp;
+
+	// Map file
+	if ((fd = open(path, O_RDONLY)) < 0) {
+		fprintf(stderr, "Error: %s: open: %s: %s\n",
+			__func__, path, strerror(errno));
+		return NULL;
+	}
+	if (fstat(fd, &st) < 0) {
+		fprintf(stderr, "Error: %s: fstat: %s: %s\n",
+			__func__, path, strerror(errno));
+		close(fd);
+		return NULL;
+	}
+	if ((size_t)st.st_size < sizeof(GFtblHdr)) {
+		fprintf(stderr, "Error: %s: %s is not table file\n",
+			__func__, path);
+		close(fd);
+		return NULL;
+	}
+	p = (const uint8_t *)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED,
+				  fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		fprintf(stderr, "Error: %s: mmap: %s: %s\n",
+			__func__, path, strerror(errno));
 		return NULL;
 	}
-	tb_0_h = tb_0_l + 32;
-	tb_1_l = tb_0_h + 32;
-	tb_1_h = tb_1_l + 32;
-	tb_2_l = tb_1_h + 32;
-	tb_2_h = tb_2_l + 32;
-	tb_3_l = tb_2_h + 32;
-	tb_3_h = tb_3_l + 32;
+	hdr = (const GFtblHdr *)p;
 
-	// Input values
-	switch (type) {
-	case 0: // a * x[i]
-		a_addr = GF16memL + GF16memIdx[a];
+	// Check header
+	GFtblSetHdr(&exp);
+	if (memcmp(hdr->magic, exp.magic, sizeof(exp.magic)) != 0) {
+		fprintf(stderr, "Error: %s: %s is not table file\n",
+			__func__, path);
+		goto err;
+	}
+	if (hdr->version != exp.version || hdr->endian != exp.endian ||
+	    hdr->gf8_prim != exp.gf8_prim ||
+	    hdr->gf16_prim != exp.gf16_prim ||
+	    hdr->gf16_compact != exp.gf16_compact ||
+	    hdr->gf16_idx_size != exp.gf16_idx_size) {
+		fprintf(stderr, "Error: %s: %s was saved by another build "
+			"(version %u, GF8_PRIM 0x%x, GF16_PRIM 0x%x, "
+			"compact %u)\n", __func__, path, hdr->version,
+			hdr->gf8_prim, hdr->gf16_prim, hdr->gf16_compact);
+		goto err;
+	}
 
-		// Input values
-		for (i = 0, i_16 = 16; i < 16; i++, i_16++) {
-			tmp = a_addr[GF16memIdx[i]];
-			tb_0_l[i] = tb_0_l[i_16] = tmp & 0xff;
-			tb_0_h[i] = tb_0_h[i_16] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 4]];
-			tb_1_l[i] = tb_1_l[i_16] = tmp & 0xff;
-			tb_1_h[i] = tb_1_h[i_16] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 8]];
-			tb_2_l[i] = tb_2_l[i_16] = tmp & 0xff;
-			tb_2_h[i] = tb_2_h[i_16] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 12]];
-			tb_3_l[i] = tb_3_l[i_16] = tmp & 0xff;
-			tb_3_h[i] = tb_3_h[i_16] = tmp >> 8;
+	// Check sections
+	for (i = first; i <= last; i++) {
+		if (hdr->len[i] != exp.len[i] ||
+		    hdr->off[i] % GF_TBL_ALIGN != 0 ||
+		    hdr->off[i] > (uint64_t)st.st_size ||
+		    hdr->len[i] > (uint64_t)st.st_size - hdr->off[i]) {
+			fprintf(stderr, "Error: %s: %s is truncated or "
+				"broken\n", __func__, path);
+			goto err;
 		}
-		break;
+		if (GFtblSum(p + hdr->off[i], hdr->len[i]) != hdr->sum[i]) {
+			fprintf(stderr, "Error: %s: Checksum error in %s\n",
+				__func__, path);
+			goto err;
+		}
+	}
 
-	case 1: // x[i] / a
-		a_addr = GF16memH - GF16memIdx[a];
+	return hdr;
 
-		// Input values
-		for (i = 0, i_16 = 16; i < 16; i++, i_16++) {
-			tmp = a_addr[GF16memIdx[i]];
-			tb_0_l[i] = tb_0_l[i_16] = tmp & 0xff;
-			tb_0_h[i] = tb_0_h[i_16] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 4]];
-			tb_1_l[i] = tb_1_l[i_16] = tmp & 0xff;
-			tb_1_h[i] = tb_1_h[i_16] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 8]];
-			tb_2_l[i] = tb_2_l[i_16] = tmp & 0xff;
-			tb_2_h[i] = tb_2_h[i_16] = tmp >> 8;
-			tmp = a_addr[GF16memIdx[i << 12]];
-			tb_3_l[i] = tb_3_l[i_16] = tmp & 0xff;
-			tb_3_h[i] = tb_3_h[i_16] = tmp >> 8;
-		}
-		break;
+err:
+	munmap((void *)p, st.st_size);
+	return NULL;
+}
 
-	default:
-		fprintf(stderr, "Error: %s: Illegal second argument value: %d "
-			"(value must be 0, 1, or 2)\n",
-			__func__, type);
-		free(tb_0_l);
-		return NULL;
+// Initialize 8bit GF by tables in file of GFsaveTbl() instead of
+// GF8init()
+// The tables (128kB) are mapped read-only and shared by all processes
+// that map the same file.
+//
+// Args:
+//     path: file name
+//
+// Return value:
+//     0 or -1 if failed (file of another build, broken, etc.)
+//
+int
+GF8initFromFile(const char *path)
+{
+	const GFtblHdr	*hdr;
+
+	// Map file
+	if ((hdr = GFmapTbl(path, GF_TBL_GF8, GF_TBL_GF8)) == NULL) {
+		return -1;
+	}
+
+	GF8memMul = (uint8_t (*)[GF8_SIZE])
+		((uint8_t *)hdr + hdr->off[GF_TBL_GF8]);
+	GF8initDef();
+
+	return 0;
+}
+
+// Initialize 16bit GF by tables in file of GFsaveTbl() instead of
+// GF16init()
+// The tables (768kB or 384kB with _GF16_COMPACT_) are mapped read-only
+// and shared by all processes that map the same file. Startup costs only
+// page faults (and a checksum pass) instead of building the tables.
+//
+// Args:
+//     path: file name
+//
+// Return value:
+//     0 or -1 if failed (file of another build, broken, etc.)
+//
+// Usage:
+//     if (GF16initFromFile("/var/lib/app/gf.tbl") < 0) {
+//             GF16init();
+//     }
+//
+int
+GF16initFromFile(const char *path)
+{
+	const GFtblHdr	*hdr;
+
+	// Map file
+	if ((hdr = GFmapTbl(path, GF_TBL_GF16L, GF_TBL_GF16IDX)) == NULL) {
+		return -1;
 	}
 
-	return tb_0_l;
+	GF16memL = (uint16_t *)((uint8_t *)hdr + hdr->off[GF_TBL_GF16L]);
+	GF16memIdx = (GF16idx *)((uint8_t *)hdr + hdr->off[GF_TBL_GF16IDX]);
+	GF16initDef();
+
+	return 0;
 }
@@ -0,0 +1,223 @@
+#ifndef _POOL_H_
+#define _POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "gf.h"
+
+/****************************************************************************
+
+	Thread pool for the region functions of gf.c.
+	A region is split into chunks (GF_POOL_CHUNK = 256kB, which fit
+	L2 cache) and the threads of the pool including the caller take
+	chunks one by one, so large buffers are processed by all cores
+	at the bandwidth of memory instead of one core.
+	Each chunk is processed by the usual region function, so tables
+	are built on the stack of each thread and never shared.
+	Regions shorter than GF_POOL_MIN are processed inline by the
+	caller without waking threads.
+	Call GF16init() (or GF8init()) before using these functions.
+
+	GFpoolCrtNuma() creates a pool for NUMA systems (Linux only).
+	Workers are pinned to the CPUs of nodes, each node has its own
+	copy of the field tables and each chunk is processed first by
+	the threads of the node where its pages are.
+
+	GFpoolBatch() runs a batch of independent jobs of any sizes, each
+	with its own coefficient. Jobs are grouped by coefficient, split
+	into chunks and dealt to work-stealing deques (Chase-Lev) of the
+	threads, and the end of each job is reported to a completion ring.
+	The slots of ring for the jobs are kept while a batch runs, and
+	GFpoolRingPut() of the caller does not use them.
+	GFpoolSubmit() gives a batch to the workers without waiting; the
+	completion ring has an eventfd for epoll, GFpoolPoll() and
+	GFpoolWait(). A ring must outlive the batches put to it;
+	GFpoolRingFree() waits for the workers to leave the ring after the
+	last completions, so it may be called as soon as they are got.
+
+****************************************************************************/
+
+// Definitions
+#define GF_POOL_CHUNK	(256 * 1024)	// Default bytes per chunk
+#define GF_POOL_MIN	(1024 * 1024)	// Default min bytes to use threads
+#define GF_POOL_MAX	1024		// Max # of threads
+#define GF_POOL_NODE_MAX	64	// Max # of NUMA nodes (node IDs)
+#define GF_POOL_CPU_MAX		4096	// Max # of CPUs (CPU IDs)
+#ifndef GF_POOL_NODE_DIR
+#define GF_POOL_NODE_DIR	"/sys/devices/system/node"
+#endif
+
+// Operations of job
+#define GF_POOL_MUL16		0	// GF16mulRegion()
+#define GF_POOL_DIV16		1	// GF16divRegion()
+#define GF_POOL_MULADD16	2	// GF16mulAddRegion()
+#define GF_POOL_DOT16		3	// GF16dotRegion()
+#define GF_POOL_ENC16		4	// GF16encodeRegion()
+#define GF_POOL_MUL8		5	// GF8mulRegion()
+#define GF_POOL_DIV8		6	// GF8divRegion()
+#define GF_POOL_MULADD8		7	// GF8mulAddRegion()
+#define GF_POOL_DOT8		8	// GF8dotRegion()
+#define GF_POOL_BATCH		9	// GFpoolBatch()
+
+// Chunks of job on one NUMA node
+typedef struct {
+	atomic_size_t	next;	// Next to take
+	size_t		n;	// # of chunks
+	size_t		*idx;	// Indices of chunks
+} GFpoolQue;
+
+// Job of batch (GFpoolBatch())
+typedef struct {
+	int		op;	// GF_POOL_MUL16, DIV16, MULADD16, MUL8, DIV8
+				// or MULADD8
+	uint16_t	a;	// Coefficient (0 - 255 for GF(2^8))
+	uint8_t		*dst;	// Output
+	const uint8_t	*src;	// Input
+	size_t		len;	// Length of region in bytes
+	uint64_t	id;	// Returned in completion
+} GFpoolDesc;
+
+// Completion of job of batch
+typedef struct {
+	uint64_t	id;	// id of GFpoolDesc
+	int		err;	// 0 or -1 if descriptor is illegal
+} GFpoolCmpl;
+
+// Slot of completion ring
+typedef struct {
+	atomic_size_t	seq;	// Sequence # of slot
+	GFpoolCmpl	cmpl;
+} GFpoolSlot;
+
+// Completion ring (bounded lock-free MPMC queue)
+typedef struct {
+	_Alignas(64) atomic_size_t	head;	// Next to put
+	_Alignas(64) atomic_size_t	tail;	// Next to get
+	size_t				mask;	// # of slots - 1
+	GFpoolSlot			*slot;
+	int				fd[2];	// eventfd (pipe if not Linux)
+	atomic_int			armed;	// Notify by fd if 1
+	atomic_size_t			resv;	// Slots kept for batches
+} GFpoolRing;
+
+// Chunk of job of batch
+typedef struct {
+	size_t		desc;	// Index of descriptor
+	size_t		off;	// Offset in region
+	size_t		len;	// Length in bytes
+} GFpoolTask;
+
+// Work-stealing deque of tasks (Chase-Lev)
+typedef struct {
+	_Alignas(64) atomic_long	top;	// Thieves steal from
+	_Alignas(64) atomic_long	bottom;	// Owner pushes and pops
+	size_t				mask;	// Size of buf - 1
+	atomic_size_t			*buf;	// Indices of tasks
+} GFpoolDeque;
+
+// Job (one call of region function)
+typedef struct GFpoolJob {
+	int			op;	// GF_POOL_*
+	uint8_t			*dst;	// Output (mul, div, dot)
+	const uint8_t		*src;	// Input (mul, div)
+	uint8_t * const		*dsts;	// Outputs (encode)
+	const uint8_t * const	*srcs;	// Inputs (dot, encode)
+	const void		*coefs;	// Coefficients (dot, encode)
+	int			m;	// # of outputs (encode)
+	int			k;	// # of inputs (dot, encode)
+	uint16_t		a;	// Coefficient (mul, div)
+	size_t			len;	// Length of region in bytes
+	size_t			chunk;	// Bytes per chunk
+	size_t			n_chunk;	// # of chunks
+	atomic_size_t		next;	// Next chunk to take
+	uint8_t			**ptr;	// Pointers with offset (dot, encode)
+	GFpoolQue		*que;	// Chunks per node (NULL: not NUMA)
+	int			n_que;	// # of que
+	const GFpoolDesc	*desc;	// Descriptors (batch)
+	GFpoolTask		*task;	// Tasks (batch)
+	atomic_uint		*left;	// # of tasks left per descriptor
+	GFpoolDeque		*deq;	// Deque per thread (batch)
+	int			n_deq;	// # of deq
+	GFpoolRing		*ring;	// Completion ring (batch)
+	struct GFpoolJob	*aq_next;	// Next submitted batch
+	int			n_ref;	// # of workers running it (submitted)
+} GFpoolJob;
+
+// NUMA node
+typedef struct {
+	int		id;	// Node ID of OS
+	int		n_cpu;	// # of CPUs
+	int		*cpu;	// CPU IDs
+	GF16ctx		*gf16;	// Copy of GF(2^16) tables on node
+	GF8ctx		*gf8;	// Copy of GF(2^8) tables on node
+} GFpoolNode;
+
+// Thread pool
+typedef struct {
+	int		n;	// # of threads including caller
+	size_t		chunk;	// Bytes per chunk
+	size_t		min;	// Min bytes to use threads
+	pthread_t	*tid;	// Worker threads (n - 1)
+	int		n_tid;	// # of started worker threads
+	pthread_mutex_t	run;	// Held by caller while running job
+	pthread_mutex_t	lock;	// Lock of members below
+	pthread_cond_t	cv_start;	// Signaled when job is posted
+	pthread_cond_t	cv_done;	// Signaled when workers finish job
+	uint64_t	gen;	// Generation of job (posted count)
+	int		busy;	// # of workers running job
+	int		quit;	// Workers quit if 1
+	GFpoolJob	*job;	// Current job
+	GFpoolJob	*aq_head;	// Submitted batches (GFpoolSubmit())
+	GFpoolJob	*aq_tail;	// Last submitted batch
+	int		n_node;	// # of NUMA nodes (0: not NUMA)
+	GFpoolNode	*node;	// NUMA nodes
+	int		*w_node;	// Node index of each thread
+	int		node_idx[GF_POOL_NODE_MAX];	// Node ID to index
+	int		n_cpu_node;	// # of cpu_node
+	int		*cpu_node;	// CPU ID to node index
+} GFpool;
+
+// Functions
+GFpool		*GFpoolCrt(int);
+GFpool		*GFpoolCrtNuma(int);
+void		GFpoolFree(GFpool *);
+int		GFpoolGetThreads(const GFpool *);
+void		GFpoolSetChunk(GFpool *, size_t, size_t);
+int		GFpoolGetNodes(const GFpool *);
+void		*GFpoolAllocNode(const GFpool *, size_t, int);
+void		GFpoolFreeNode(void *, size_t);
+GFpoolRing	*GFpoolRingCrt(size_t);
+void		GFpoolRingFree(GFpoolRing *);
+int		GFpoolRingPut(GFpoolRing *, const GFpoolCmpl *);
+int		GFpoolRingGet(GFpoolRing *, GFpoolCmpl *);
+int		GFpoolRingGetFd(const GFpoolRing *);
+int		GFpoolBatch(GFpool *, const GFpoolDesc *, size_t,
+			    GFpoolRing *);
+int		GFpoolSubmit(GFpool *, const GFpoolDesc *, size_t,
+			     GFpoolRing *);
+size_t		GFpoolPoll(GFpoolRing *, GFpoolCmpl *, size_t);
+size_t		GFpoolWait(GFpoolRing *, GFpoolCmpl *, size_t, int);
+void		GF16mulRegionPool(GFpool *, uint8_t *, const uint8_t *, size_t,
+				  uint16_t);
+void		GF16divRegionPool(GFpool *, uint8_t *, const uint8_t *, size_t,
+				  uint16_t);
+void		GF16mulAddRegionPool(GFpool *, uint8_t *, const uint8_t *,
+				     size_t, uint16_t);
+void		GF16dotRegionPool(GFpool *, uint8_t *,
+				  const uint8_t * const *, const uint16_t *,
+				  int, size_t);
+void		GF16encodeRegionPool(GFpool *, uint8_t * const *,
+				     const uint8_t * const *, const uint16_t *,
+				     int, int, size_t);
+void		GF8mulRegionPool(GFpool *, uint8_t *, const uint8_t *, size_t,
+				 uint8_t);
+void		GF8divRegionPool(GFpool *, uint8_t *, const uint8_t *, size_t,
+				 uint8_t);
+void		GF8mulAddRegionPool(GFpool *, uint8_t *, const uint8_t *,
+				    size_t, uint8_t);
+void		GF8dotRegionPool(GFpool *, uint8_t *, const uint8_t * const *,
+				 const uint8_t *, int, size_t);
+
+#endif // _POOL_H_
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "mt64.h"
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, j;
+	struct timeval	start, end;
+	uint16_t	a, *b, *c;
+	uint64_t	*r;
+
+	// Initialize GF
+	GF16init(); // 16bit
+
+	// Allocate b and c
+	if ((b = (uint16_t *)malloc(SPACE * 2)) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	c = b + (SPACE / sizeof(uint16_t));
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to a, b
+	a = (uint16_t)(genrand64_int64() & 0xffff);
+	r = (uint64_t *)b;
+	for (i = 0; i < SPACE / sizeof(uint64_t); i++) {
+		r[i] = genrand64_int64();
+	}
+
+	// Start measuring elapsed time
+	gettimeofday(&start, NULL); // Get start time
+
+	// Use GF16mul to calculate b[j] / a
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < SPACE / sizeof(uint16_t); j++) {
+			// Calculate in GF
+			// To avoid elimination by cc's -O2 option,
+			// input result into c[j]
+			c[j] = GF16div(b[j], a);
+		}
+	}
+
+	// Get end time
+	gettimeofday(&end, NULL);
+
+	// Print result
+	printf("%ld\n", ((end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec)));
+
+	exit(0);
+}
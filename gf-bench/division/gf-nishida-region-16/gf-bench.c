@@ -365,6 +365,197 @@ main(int argc, char **argv)
 		exit(1);
 	}
 }
+#if defined(__AVX512BW__)
+{
+	/*** 4bit multi table region technique by AVX-512 ***/
+
+	uint8_t	*_b, *_d;
+	__m512i	tb_a_0_l, tb_a_0_h, tb_a_1_l, tb_a_1_h;
+	__m512i	tb_a_2_l, tb_a_2_h, tb_a_3_l, tb_a_3_h;
+
+	// Reset d
+	memset(d, 0, SPACE); 
+
+#if defined(_REAL_USE_) // For real use, do this here, not inside loop
+	// Create 8 * 64 byte region tables for a
+	if ((gf_tb = GF16crt4bitRegTbl512(a, 1)) == NULL) {
+		exit(1);
+	}
+#endif
+
+	// Start measuring elapsed time
+	gettimeofday(&start, NULL); // Get start time
+
+	for (i = 0; i < REPEAT; i++) {
+		_b = (uint8_t *)b;
+		_d = (uint8_t *)d;
+
+#if !defined(_REAL_USE_) // For real use, do this outside loop, not here
+		// This is only for benchmarking purpose
+		// Create 8 * 64 byte region tables for a
+		if ((gf_tb = GF16crt4bitRegTbl512(a, 1)) == NULL) {
+			exit(1);
+		}
+#endif
+
+		// Load tables
+		tb_a_0_l = _mm512_loadu_si512((__m512i *)(gf_tb + 0));
+		tb_a_0_h = _mm512_loadu_si512((__m512i *)(gf_tb + 64));
+		tb_a_1_l = _mm512_loadu_si512((__m512i *)(gf_tb + 128));
+		tb_a_1_h = _mm512_loadu_si512((__m512i *)(gf_tb + 192));
+		tb_a_2_l = _mm512_loadu_si512((__m512i *)(gf_tb + 256));
+		tb_a_2_h = _mm512_loadu_si512((__m512i *)(gf_tb + 320));
+		tb_a_3_l = _mm512_loadu_si512((__m512i *)(gf_tb + 384));
+		tb_a_3_h = _mm512_loadu_si512((__m512i *)(gf_tb + 448));
+
+		for (j = 0; j < SPACE; j += 128) { // Do every 512 * 2bit
+			// Use SIMD lookup
+			GF16lkupSIMD512x2(tb_a_0_l, tb_a_0_h,
+					  tb_a_1_l, tb_a_1_h,
+					  tb_a_2_l, tb_a_2_h,
+					  tb_a_3_l, tb_a_3_h,
+					  _b, _d);
+			_b += 128;
+			_d += 128;
+		}
+
+#if !defined(_REAL_USE_) // For real use, do this outside loop, not here
+		// Don't forget this if you called GF16crt4bitRegTbl512()
+		free(gf_tb);
+#endif
+	}
+
+	// Get end time
+	gettimeofday(&end, NULL);
+
+	// Print result
+	printf("One step lookup by AVX-512   : %ld\n",
+		((end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec)));
+
+#if defined(_REAL_USE_) // For real use, do this here, not inside loop
+	// Don't forget this if you called GF16crt4bitRegTbl512()
+	free(gf_tb);
+#endif
+
+	// Compare c and d, they are supposed to be same
+	if (memcmp(c, d, SPACE)) {
+		fprintf(stderr, "Error at AVX-512: E-mail me "
+			"(nishida at asusa.net) if this happened.\n");
+		for (i = 0; i < 16; i++) {
+			printf("%04x ", c[i]);
+		}
+		putchar('\n');
+		for (i = 0; i < 16; i++) {
+			printf("%04x ", d[i]);
+		}
+		putchar('\n');
+		exit(1);
+	}
+}
+#endif // __AVX512BW__
+#if defined(__GFNI__)
+{
+	/*** Affine transformation by GFNI ***/
+
+	uint8_t		*_b, *_d;
+	uint64_t	*mtx_tb;
+#if defined(__AVX512BW__)
+	__m512i		mtx_a_ll, mtx_a_lh, mtx_a_hl, mtx_a_hh;
+#else
+	__m256i		mtx_a_ll, mtx_a_lh, mtx_a_hl, mtx_a_hh;
+#endif
+
+	// Reset d
+	memset(d, 0, SPACE); 
+
+#if defined(_REAL_USE_) // For real use, do this here, not inside loop
+	// Create 4 * 64 byte matrix tables for a
+	if ((mtx_tb = GF16crtAffineTbl(a, 1)) == NULL) {
+		exit(1);
+	}
+#endif
+
+	// Start measuring elapsed time
+	gettimeofday(&start, NULL); // Get start time
+
+	for (i = 0; i < REPEAT; i++) {
+		_b = (uint8_t *)b;
+		_d = (uint8_t *)d;
+
+#if !defined(_REAL_USE_) // For real use, do this outside loop, not here
+		// This is only for benchmarking purpose
+		// Create 4 * 64 byte matrix tables for a
+		if ((mtx_tb = GF16crtAffineTbl(a, 1)) == NULL) {
+			exit(1);
+		}
+#endif
+
+#if defined(__AVX512BW__)
+		// Load matrices
+		mtx_a_ll = _mm512_load_si512((__m512i *)(mtx_tb + 0));
+		mtx_a_lh = _mm512_load_si512((__m512i *)(mtx_tb + 8));
+		mtx_a_hl = _mm512_load_si512((__m512i *)(mtx_tb + 16));
+		mtx_a_hh = _mm512_load_si512((__m512i *)(mtx_tb + 24));
+
+		for (j = 0; j < SPACE; j += 128) { // Do every 512 * 2bit
+			// Use GFNI
+			GF16affineSIMD512x2(mtx_a_ll, mtx_a_lh,
+					    mtx_a_hl, mtx_a_hh, _b, _d);
+			_b += 128;
+			_d += 128;
+		}
+#else
+		// Load matrices
+		mtx_a_ll = _mm256_load_si256((__m256i *)(mtx_tb + 0));
+		mtx_a_lh = _mm256_load_si256((__m256i *)(mtx_tb + 8));
+		mtx_a_hl = _mm256_load_si256((__m256i *)(mtx_tb + 16));
+		mtx_a_hh = _mm256_load_si256((__m256i *)(mtx_tb + 24));
+
+		for (j = 0; j < SPACE; j += 64) { // Do every 256 * 2bit
+			// Use GFNI
+			GF16affineSIMD256x2(mtx_a_ll, mtx_a_lh,
+					    mtx_a_hl, mtx_a_hh, _b, _d);
+			_b += 64;
+			_d += 64;
+		}
+#endif
+
+#if !defined(_REAL_USE_) // For real use, do this outside loop, not here
+		// Don't forget this if you called GF16crtAffineTbl()
+		free(mtx_tb);
+#endif
+	}
+
+	// Get end time
+	gettimeofday(&end, NULL);
+
+	// Print result
+	printf("One step affine by GFNI      : %ld\n",
+		((end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec)));
+
+#if defined(_REAL_USE_) // For real use, do this here, not inside loop
+	// Don't forget this if you called GF16crtAffineTbl()
+	free(mtx_tb);
+#endif
+
+	// Compare c and d, they are supposed to be same
+	if (memcmp(c, d, SPACE)) {
+		fprintf(stderr, "Error at GFNI: E-mail me "
+			"(nishida at asusa.net) if this happened.\n");
+		for (i = 0; i < 16; i++) {
+			printf("%04x ", c[i]);
+		}
+		putchar('\n');
+		for (i = 0; i < 16; i++) {
+			printf("%04x ", d[i]);
+		}
+		putchar('\n');
+		exit(1);
+	}
+}
+#endif // __GFNI__
 #elif defined(_arm64_) // NEON
 {
 	/*** 4bit multi table region technique by NEON ***/
@@ -8,6 +8,14 @@
 #include "gf.h"
 #include "mt64.h"
 
+// Elapsed time in us
+static long
+Elapsed(const struct timeval *start, const struct timeval *end)
+{
+	return (end->tv_sec * 1000000 + end->tv_usec) -
+	       (start->tv_sec * 1000000 + start->tv_usec);
+}
+
 // Main
 int
 main(int argc, char **argv)
@@ -15,7 +23,7 @@ main(int argc, char **argv)
 	// Variables
 	int		i, j;
 	struct timeval	start, end;
-	uint8_t	a, *b, *c;
+	uint8_t	a, *b, *c, x, *rows[256];
 	uint64_t	*r;
 
 	// Initialize GF
@@ -54,9 +62,36 @@ main(int argc, char **argv)
 	// Get end time
 	gettimeofday(&end, NULL);
 
-	// Print result
-	printf("%ld\n", ((end.tv_sec * 1000000 + end.tv_usec) -
-		(start.tv_sec * 1000000 + start.tv_usec)));
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", Elapsed(&start, &end));
+
+	// Latency (1 / 10 of REPEAT): every GF8mul() depends on the previous result as in
+	// scalar-heavy code (b[j] | 1 keeps x from being 0)
+	x = a | 1;
+	gettimeofday(&start, NULL);
+	for (i = 0; i < REPEAT / 10; i++) {
+		for (j = 0; j < SPACE / sizeof(uint8_t); j++) {
+			x = GF8mul(x, b[j] | 1);
+		}
+	}
+	gettimeofday(&end, NULL);
+	printf("GF8mul() chain (flat table)  : %ld (%02x)\n",
+		Elapsed(&start, &end), x);
+
+	// Same with pointers to rows (layout before flat table)
+	for (i = 0; i < 256; i++) {
+		rows[i] = GF8memMul[i];
+	}
+	x = a | 1;
+	gettimeofday(&start, NULL);
+	for (i = 0; i < REPEAT / 10; i++) {
+		for (j = 0; j < SPACE / sizeof(uint8_t); j++) {
+			x = rows[x][b[j] | 1];
+		}
+	}
+	gettimeofday(&end, NULL);
+	printf("GF8mul() chain (row pointers): %ld (%02x)\n",
+		Elapsed(&start, &end), x);
 
 	exit(0);
 }
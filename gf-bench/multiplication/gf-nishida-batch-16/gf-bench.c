@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "pool.h"
+#include "mt64.h"
+
+// Batch of jobs of mixed sizes (MIN_LEN - MAX_LEN, log uniform) filling
+// OUT_SPACE bytes of outputs, each with one of N_COEF coefficients, run by
+// GFpoolBatch() and by GF16mulAddRegionPool() job by job
+#define OUT_SPACE	(64 * 1024 * 1024)	// Outputs of batch
+#define MIN_LEN		(4 * 1024)		// Min bytes of job
+#define MAX_LEN		(4 * 1024 * 1024)	// Max bytes of job
+#define N_COEF		16			// # of coefficients
+#define N_DESC		(OUT_SPACE / MIN_LEN)	// Max # of jobs
+#define N_RUN		(REPEAT / 10)		// # of batches
+
+// Elapsed time in us
+static long
+Elapsed(const struct timeval *start, const struct timeval *end)
+{
+	return (end->tv_sec * 1000000 + end->tv_usec) -
+	       (start->tv_sec * 1000000 + start->tv_usec);
+}
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, n_cpu;
+	size_t		j, n, off, len;
+	struct timeval	start, end;
+	uint16_t	coef[N_COEF];
+	uint8_t		*b, *p;
+	GFpoolDesc	*desc;
+	GFpoolCmpl	cmpl;
+	GFpoolRing	*ring;
+	GFpool		*pool;
+	long		t;
+
+	// Initialize GF
+	GF16init(); // 16bit
+
+	// Allocate data b (SPACE), outputs p (OUT_SPACE) and jobs
+	if ((b = (uint8_t *)malloc(SPACE + MAX_LEN)) == NULL ||
+	    (p = (uint8_t *)malloc(OUT_SPACE)) == NULL ||
+	    (desc = (GFpoolDesc *)malloc(sizeof(GFpoolDesc) *
+					 N_DESC)) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to b and coef
+	for (i = 0; i < (SPACE + MAX_LEN) / sizeof(uint64_t); i++) {
+		((uint64_t *)b)[i] = genrand64_int64();
+	}
+	for (i = 0; i < N_COEF; i++) {
+		coef[i] = (uint16_t)genrand64_int64();
+	}
+	memset(p, 0, OUT_SPACE);
+
+	// Jobs: outputs don't overlap, inputs are anywhere in b
+	for (n = off = 0; off < OUT_SPACE; n++) {
+		len = (size_t)(MIN_LEN * exp(log((double)MAX_LEN / MIN_LEN) *
+			       genrand64_real2())) & ~(size_t)63;
+		if (len > OUT_SPACE - off) {
+			len = OUT_SPACE - off;
+		}
+		desc[n].op = GF_POOL_MULADD16;
+		desc[n].a = coef[genrand64_int64() % N_COEF];
+		desc[n].dst = p + off;
+		desc[n].src = b + (genrand64_int64() % SPACE & ~(uint64_t)63);
+		desc[n].len = len;
+		desc[n].id = n;
+		off += len;
+	}
+
+	// Pool of all CPUs and ring
+	if ((n_cpu = (int)sysconf(_SC_NPROCESSORS_ONLN)) < 1) {
+		n_cpu = 1;
+	}
+	if ((pool = GFpoolCrt(n_cpu)) == NULL ||
+	    (ring = GFpoolRingCrt(n)) == NULL) {
+		exit(1);
+	}
+
+	// GFpoolBatch()
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < N_RUN; i++) {
+		GFpoolBatch(pool, desc, n, ring);
+		for (j = 0; GFpoolRingGet(ring, &cmpl); j++);
+		if (j != n) {
+			fprintf(stderr, "Error: %zu of %zu jobs done\n", j, n);
+			exit(1);
+		}
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t);
+
+	// Job by job
+	gettimeofday(&start, NULL);
+	for (i = 0; i < N_RUN; i++) {
+		for (j = 0; j < n; j++) {
+			GF16mulAddRegionPool(pool, desc[j].dst, desc[j].src,
+					     desc[j].len, desc[j].a);
+		}
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+	printf("GF16mulAddRegionPool() job by job (%zu jobs, %d threads): "
+	       "%ld\n", n, n_cpu, t);
+
+	GFpoolRingFree(ring);
+
+	// GFpoolSubmit() and GFpoolWait() (caller is free while workers run)
+	// A ring per batch is freed as soon as its completions are got.
+	gettimeofday(&start, NULL);
+	for (i = 0; i < N_RUN; i++) {
+		if ((ring = GFpoolRingCrt(n)) == NULL ||
+		    GFpoolSubmit(pool, desc, n, ring) < 0) {
+			exit(1);
+		}
+		for (j = 0; j < n; j += GFpoolWait(ring, &cmpl, 1, -1));
+		GFpoolRingFree(ring);
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+	printf("GFpoolSubmit() + GFpoolWait() (%d workers): %ld\n",
+	       n_cpu - 1, t);
+
+	GFpoolFree(pool);
+
+	exit(0);
+}
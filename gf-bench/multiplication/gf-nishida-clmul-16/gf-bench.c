@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "mt64.h"
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i;
+	struct timeval	start, end;
+	uint16_t	*a, *b, *c;
+	uint64_t	*r;
+	long		t_vec, t_tbl;
+
+	// Initialize GF
+	GF16init(); // 16bit
+	if (GF16setVec(GF_VEC_CLMUL) < 0) { // Carry-less multiplication
+		exit(1);
+	}
+
+	// Allocate a, b and c
+	if ((a = (uint16_t *)malloc(SPACE * 3)) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	b = a + (SPACE / sizeof(uint16_t));
+	c = b + (SPACE / sizeof(uint16_t));
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to a, b
+	r = (uint64_t *)a;
+	for (i = 0; i < SPACE * 2 / sizeof(uint64_t); i++) {
+		r[i] = genrand64_int64();
+	}
+
+	// Use GF16mulVec (GF_VEC_CLMUL) to calculate a[j] * b[j]
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		GF16mulVec(c, a, b, SPACE / sizeof(uint16_t));
+	}
+	gettimeofday(&end, NULL);
+	t_vec = (end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec);
+
+	// Same by GF16mulVec (GF_VEC_TABLE)
+	GF16setVec(GF_VEC_TABLE);
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		GF16mulVec(c, a, b, SPACE / sizeof(uint16_t));
+	}
+	gettimeofday(&end, NULL);
+	t_tbl = (end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec);
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t_vec);
+	printf("GF_VEC_TABLE (%s): %ld\n", GFnameSIMD(GFgetSIMD()), t_tbl);
+
+	exit(0);
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "mt64.h"
+
+// Two on-disk formats in one process: packets of PKT bytes are encoded in
+// the field of 0x1002d (GF16crtCtx()) and in the default field (GF16_PRIM)
+#define PKT	1024	// Bytes per packet
+#define N_COEF	65536	// # of random coefficients
+#define PRIM	0x1002d	// Primitive polynomial of another field
+
+// Elapsed time in us
+static long
+Elapsed(const struct timeval *start, const struct timeval *end)
+{
+	return (end->tv_sec * 1000000 + end->tv_usec) -
+	       (start->tv_sec * 1000000 + start->tv_usec);
+}
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, j;
+	struct timeval	start, end;
+	uint16_t	*coef;
+	uint8_t		*b, *p;
+	GF16ctx		*gf;
+	long		t_ctx, t;
+
+	// Initialize GF
+	GF16init(); // 16bit
+	if ((gf = GF16crtCtx(PRIM)) == NULL) {
+		exit(1);
+	}
+
+	// Allocate data b (SPACE), parity p (PKT) and coefficients
+	if ((b = (uint8_t *)malloc(SPACE + PKT)) == NULL ||
+	    (coef = (uint16_t *)malloc(N_COEF * sizeof(uint16_t))) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	p = b + SPACE;
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to b and coef
+	for (i = 0; i < SPACE / sizeof(uint64_t); i++) {
+		((uint64_t *)b)[i] = genrand64_int64();
+	}
+	for (i = 0; i < N_COEF; i++) {
+		coef[i] = (uint16_t)genrand64_int64();
+	}
+
+	// Field of PRIM
+	memset(p, 0, PKT);
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < SPACE / PKT; j++) {
+			GF16mulAddRegionCtx(gf, p, b + j * PKT, PKT,
+					    coef[j & (N_COEF - 1)]);
+		}
+	}
+	gettimeofday(&end, NULL);
+	t_ctx = Elapsed(&start, &end);
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t_ctx);
+
+	// Default field
+	gettimeofday(&start, NULL);
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < SPACE / PKT; j++) {
+			GF16mulAddRegion(p, b + j * PKT, PKT,
+					 coef[j & (N_COEF - 1)]);
+		}
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+	printf("GF16mulAddRegion() (default field): %ld (%02x)\n", t, p[0]);
+
+	GF16freeCtx(gf);
+
+	exit(0);
+}
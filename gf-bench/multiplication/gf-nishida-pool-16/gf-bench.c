@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "pool.h"
+#include "mt64.h"
+
+// GF16mulAddRegionPool() over the whole buffer of SPACE bytes split into
+// chunks of GF_POOL_CHUNK bytes by the threads of a pool
+#define N_COEF	65536	// # of random coefficients
+
+// Elapsed time in us
+static long
+Elapsed(const struct timeval *start, const struct timeval *end)
+{
+	return (end->tv_sec * 1000000 + end->tv_usec) -
+	       (start->tv_sec * 1000000 + start->tv_usec);
+}
+
+// Run GF16mulAddRegionPool() REPEAT times and return elapsed time in us
+// Coefficients continue from the previous call, so p never cancels.
+static long
+Run(GFpool *pool, uint8_t *p, const uint8_t *b, const uint16_t *coef)
+{
+	static int	c = 0;
+	int		i;
+	struct timeval	start, end;
+
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		GF16mulAddRegionPool(pool, p, b, SPACE, coef[c++ & (N_COEF - 1)]);
+	}
+	gettimeofday(&end, NULL);
+
+	return Elapsed(&start, &end);
+}
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, n, n_cpu;
+	uint16_t	*coef;
+	uint8_t		*b, *p;
+	GFpool		*pool;
+	long		t;
+
+	// Initialize GF
+	GF16init(); // 16bit
+
+	// Allocate data b, output p (SPACE each) and coefficients
+	if ((b = (uint8_t *)malloc(SPACE * 2)) == NULL ||
+	    (coef = (uint16_t *)malloc(N_COEF * sizeof(uint16_t))) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	p = b + SPACE;
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to b and coef
+	for (i = 0; i < SPACE / sizeof(uint64_t); i++) {
+		((uint64_t *)b)[i] = genrand64_int64();
+	}
+	for (i = 0; i < N_COEF; i++) {
+		coef[i] = (uint16_t)genrand64_int64();
+	}
+	memset(p, 0, SPACE);
+
+	// All CPUs
+	if ((n_cpu = (int)sysconf(_SC_NPROCESSORS_ONLN)) < 1) {
+		n_cpu = 1;
+	}
+	if ((pool = GFpoolCrt(n_cpu)) == NULL) {
+		exit(1);
+	}
+	t = Run(pool, p, b, coef);
+	GFpoolFree(pool);
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t);
+
+	// Sweep # of threads
+	for (n = 1; ; n *= 2) {
+		if (n > n_cpu) {
+			n = n_cpu;
+		}
+		if ((pool = GFpoolCrt(n)) == NULL) {
+			exit(1);
+		}
+		t = Run(pool, p, b, coef);
+		GFpoolFree(pool);
+		printf("threads %d: %ld (%02x)\n", n, t, p[0]);
+		if (n == n_cpu) {
+			break;
+		}
+	}
+
+	// All CPUs pinned to NUMA nodes
+	if ((pool = GFpoolCrtNuma(n_cpu)) == NULL) {
+		exit(1);
+	}
+	t = Run(pool, p, b, coef);
+	printf("NUMA (%d nodes): %ld (%02x)\n", GFpoolGetNodes(pool), t, p[0]);
+	GFpoolFree(pool);
+
+	exit(0);
+}
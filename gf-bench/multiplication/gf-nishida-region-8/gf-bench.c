@@ -171,6 +171,100 @@ main(int argc, char **argv)
 		exit(1);
 	}
 }
+#if defined(__GFNI__)
+{
+	/*** Affine transformation by GFNI ***/
+
+	uint8_t		*_b, *_d;
+	uint64_t	*mtx_tb;
+#if defined(__AVX512BW__)
+	__m512i		mtx_a;
+#else
+	__m256i		mtx_a;
+#endif
+
+	// Reset d
+	memset(d, 0, SPACE); 
+
+#if defined(_REAL_USE_) // For real use, do this here, not inside loop
+	// Create 8x8 bit matrix for a
+	if ((mtx_tb = GF8crtAffineTbl(a, 0)) == NULL) {
+		exit(1);
+	}
+#endif
+
+	// Start measuring elapsed time
+	gettimeofday(&start, NULL); // Get start time
+
+	for (i = 0; i < REPEAT; i++) {
+		_b = b;
+		_d = d;
+
+#if !defined(_REAL_USE_) // For real use, do this outside loop, not here
+		// This is only for benchmarking purpose
+		// Create 8x8 bit matrix for a
+		if ((mtx_tb = GF8crtAffineTbl(a, 0)) == NULL) {
+			exit(1);
+		}
+#endif
+
+#if defined(__AVX512BW__)
+		// Load matrix
+		mtx_a = _mm512_load_si512((__m512i *)mtx_tb);
+
+		for (j = 0; j < SPACE; j += 64) { // Do every 512bit
+			// Use GFNI
+			GF8affineSIMD512(mtx_a, _b, _d);
+			_b += 64;
+			_d += 64;
+		}
+#else
+		// Load matrix
+		mtx_a = _mm256_load_si256((__m256i *)mtx_tb);
+
+		for (j = 0; j < SPACE; j += 32) { // Do every 256bit
+			// Use GFNI
+			GF8affineSIMD256(mtx_a, _b, _d);
+			_b += 32;
+			_d += 32;
+		}
+#endif
+
+#if !defined(_REAL_USE_) // For real use, do this outside loop, not here
+		// Don't forget this if you called GF8crtAffineTbl()
+		free(mtx_tb);
+#endif
+	}
+
+	// Get end time
+	gettimeofday(&end, NULL);
+
+	// Print result
+	printf("One step affine by GFNI      : %ld\n",
+		((end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec)));
+
+#if defined(_REAL_USE_) // For real use, do this here, not inside loop
+	// Don't forget this if you called GF8crtAffineTbl()
+	free(mtx_tb);
+#endif
+
+	// Compare c and d, they are supposed to be same
+	if (memcmp(c, d, SPACE)) {
+		fprintf(stderr, "Error at GFNI: E-mail me "
+			"(nishida at asusa.net) if this happened.\n");
+		for (i = 0; i < 16; i++) {
+			printf("%04x ", c[i]);
+		}
+		putchar('\n');
+		for (i = 0; i < 16; i++) {
+			printf("%04x ", d[i]);
+		}
+		putchar('\n');
+		exit(1);
+	}
+}
+#endif // __GFNI__
 #elif defined(_arm64_) // NEON
 {
 	/*** 4bit multi table region technique by NEON ***/
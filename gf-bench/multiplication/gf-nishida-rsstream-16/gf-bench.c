@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "rs.h"
+#include "mt64.h"
+
+// RS(K, M) encoding of an object of SPACE x REPEAT bytes streamed from
+// memory (RS16encodeStream()) in blocks of BLK bytes, and RS16encode() of
+// the whole buffer of SPACE bytes REPEAT times
+#define K	10		// # of data blocks
+#define M	4		// # of parity blocks
+#define BLK	(64 * 1024)	// Bytes per block of stripe
+
+// Input: data b read again and again up to SPACE x REPEAT bytes
+typedef struct {
+	const uint8_t	*b;
+	size_t		off;	// Offset in b
+	uint64_t	left;	// Bytes left
+} Input;
+
+// Output: XOR of first bytes of blocks
+typedef struct {
+	uint8_t		x;
+	uint64_t	n;	// # of blocks
+} Output;
+
+// Elapsed time in us
+static long
+Elapsed(const struct timeval *start, const struct timeval *end)
+{
+	return (end->tv_sec * 1000000 + end->tv_usec) -
+	       (start->tv_sec * 1000000 + start->tv_usec);
+}
+
+// Read callback
+static ssize_t
+Read(void *arg, uint8_t *buf, size_t len)
+{
+	Input	*in = (Input *)arg;
+
+	if (len > in->left) {
+		len = in->left;
+	}
+	if (len > SPACE - in->off) {
+		len = SPACE - in->off;
+	}
+	memcpy(buf, in->b + in->off, len);
+	in->off = (in->off + len) % SPACE;
+	in->left -= len;
+
+	return len;
+}
+
+// Write callback
+static int
+Write(void *arg, uint64_t stripe, int blk, const uint8_t *buf, size_t len)
+{
+	Output	*out = (Output *)arg;
+
+	out->x ^= buf[0];
+	out->n++;
+
+	return 0;
+}
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i;
+	struct timeval	start, end;
+	uint8_t		*b, *p, *blks[K + M];
+	size_t		len;
+	RS16		*rs;
+	Input		in;
+	Output		out;
+	long		t;
+
+	// Initialize GF
+	GF16init(); // 16bit
+	if ((rs = RS16crt(K, M, RS_CAUCHY)) == NULL) {
+		exit(1);
+	}
+
+	// Allocate data b (SPACE) and parity p (M / K of SPACE)
+	len = (SPACE / K) & ~(size_t)63;
+	if ((b = (uint8_t *)malloc(SPACE)) == NULL ||
+	    (p = (uint8_t *)malloc(len * M)) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	for (i = 0; i < K; i++) {
+		blks[i] = b + i * len;
+	}
+	for (i = 0; i < M; i++) {
+		blks[K + i] = p + i * len;
+	}
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to b
+	for (i = 0; i < SPACE / sizeof(uint64_t); i++) {
+		((uint64_t *)b)[i] = genrand64_int64();
+	}
+
+	// Stream
+	in.b = b;
+	in.off = 0;
+	in.left = (uint64_t)SPACE * REPEAT;
+	memset(&out, 0, sizeof(out));
+	gettimeofday(&start, NULL); // Get start time
+	if (RS16encodeStream(rs, BLK, Read, &in, Write, &out) < 0) {
+		exit(1);
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t);
+	printf("RS16encodeStream() memory: %d bytes, %llu blocks (%02x)\n",
+	       (1 + M) * BLK, (unsigned long long)out.n, out.x);
+
+	// Whole buffer in memory
+	gettimeofday(&start, NULL);
+	for (i = 0; i < REPEAT; i++) {
+		RS16encode(rs, blks, len);
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+	printf("RS16encode() (object in memory): %ld (%02x)\n", t, p[0]);
+
+	RS16free(rs);
+
+	exit(0);
+}
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "mt64.h"
+
+// Network coding: every packet of PKT bytes is multiplied by a random
+// coefficient, so a table is built for each packet.
+#define PKT	1024	// Bytes per packet
+#define N_COEF	65536	// # of random coefficients
+#define N_BUILD	(N_COEF * 64)	// # of table builds to measure
+
+// Build 4bit split tables by lookups in GF16memL (before GF16set4bitRegTbl)
+static void
+LkupSet4bitRegTbl(uint8_t *tb, uint16_t a)
+{
+	int		i;
+	uint16_t	*a_addr, tmp;
+
+	a_addr = GF16memL + GF16memIdx[a];
+	for (i = 0; i < 16; i++) {
+		tmp = a_addr[GF16memIdx[i]];
+		tb[i] = tmp & 0xff;
+		tb[16 + i] = tmp >> 8;
+		tmp = a_addr[GF16memIdx[i << 4]];
+		tb[32 + i] = tmp & 0xff;
+		tb[48 + i] = tmp >> 8;
+		tmp = a_addr[GF16memIdx[i << 8]];
+		tb[64 + i] = tmp & 0xff;
+		tb[80 + i] = tmp >> 8;
+		tmp = a_addr[GF16memIdx[i << 12]];
+		tb[96 + i] = tmp & 0xff;
+		tb[112 + i] = tmp >> 8;
+	}
+}
+
+// Elapsed time in us
+static long
+Elapsed(const struct timeval *start, const struct timeval *end)
+{
+	return (end->tv_sec * 1000000 + end->tv_usec) -
+	       (start->tv_sec * 1000000 + start->tv_usec);
+}
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, j;
+	struct timeval	start, end;
+	uint16_t	*coef;
+	uint8_t		*b, *p, sum;
+	_Alignas(64) uint8_t	gf_tb[512];
+	long		t_pkt, t;
+
+	// Initialize GF
+	GF16init(); // 16bit
+
+	// Allocate data b (SPACE), parity p (PKT) and coefficients
+	if ((b = (uint8_t *)malloc(SPACE + PKT)) == NULL ||
+	    (coef = (uint16_t *)malloc(N_COEF * sizeof(uint16_t))) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	p = b + SPACE;
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to b and coef
+	for (i = 0; i < SPACE / sizeof(uint64_t); i++) {
+		((uint64_t *)b)[i] = genrand64_int64();
+	}
+	for (i = 0; i < N_COEF; i++) {
+		coef[i] = (uint16_t)genrand64_int64();
+	}
+
+	// Encode packets with a random coefficient each
+	memset(p, 0, PKT);
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < SPACE / PKT; j++) {
+			GF16set4bitRegTbl(gf_tb, coef[j & (N_COEF - 1)], 0);
+			GF16lkupRegionXor(gf_tb, b + j * PKT, p, PKT);
+		}
+	}
+	gettimeofday(&end, NULL);
+	t_pkt = Elapsed(&start, &end);
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t_pkt);
+
+	// Table builds per second (sum avoids elimination by -O2)
+	sum = 0;
+	gettimeofday(&start, NULL);
+	for (i = 0; i < N_BUILD; i++) {
+		GF16set4bitRegTbl(gf_tb, coef[i & (N_COEF - 1)], 0);
+		sum ^= gf_tb[i & 127];
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+	printf("GF16set4bitRegTbl (%s)   : %.1f M builds/s\n",
+		GFnameSIMD(GFgetSIMD()), (double)N_BUILD / t);
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < N_BUILD; i++) {
+		GF16set4bitRegTbl256(gf_tb, coef[i & (N_COEF - 1)], 0);
+		sum ^= gf_tb[i & 255];
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+	printf("GF16set4bitRegTbl256 (%s): %.1f M builds/s\n",
+		GFnameSIMD(GFgetSIMD()), (double)N_BUILD / t);
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < N_BUILD; i++) {
+		LkupSet4bitRegTbl(gf_tb, coef[i & (N_COEF - 1)]);
+		sum ^= gf_tb[i & 127];
+	}
+	gettimeofday(&end, NULL);
+	t = Elapsed(&start, &end);
+	printf("Lookups in GF16memL          : %.1f M builds/s (%02x)\n",
+		(double)N_BUILD / t, sum);
+
+	exit(0);
+}
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "mt64.h"
+
+// Encoder with a fixed matrix: one parity row of N_COEF data chunks
+// of CHUNK bytes is calculated for each request.
+#define N_COEF	50	// # of coefficients
+#define CHUNK	4096	// Bytes per data chunk of a request
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, j, k, n_req;
+	struct timeval	start, end;
+	uint16_t	coef[N_COEF];
+	uint8_t		*b, *p, *gf_tb;
+	long		t_cache, t_crt, t_bank;
+
+	// Initialize GF
+	GF16init(); // 16bit
+
+	// Allocate data b (SPACE) and parity p
+	n_req = SPACE / (N_COEF * CHUNK); // # of requests per repeat
+	if ((b = (uint8_t *)malloc(SPACE + CHUNK)) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	p = b + SPACE;
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to b and coef
+	for (i = 0; i < SPACE / sizeof(uint64_t); i++) {
+		((uint64_t *)b)[i] = genrand64_int64();
+	}
+	for (i = 0; i < N_COEF; i++) {
+		coef[i] = (uint16_t)(genrand64_int64() % 65535 + 1);
+	}
+
+	// Tables from GF16getRegTbl()
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < n_req; j++) {
+			memset(p, 0, CHUNK);
+			for (k = 0; k < N_COEF; k++) {
+				gf_tb = GF16getRegTbl(coef[k], 0,
+						      GF16_TBL_4BIT);
+				GF16lkupRegionXor(gf_tb,
+					b + (j * N_COEF + k) * CHUNK, p, CHUNK);
+				GF16putRegTbl(gf_tb);
+			}
+		}
+	}
+	gettimeofday(&end, NULL);
+	t_cache = (end.tv_sec * 1000000 + end.tv_usec) -
+		  (start.tv_sec * 1000000 + start.tv_usec);
+
+	// Tables created and freed for each request
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < n_req; j++) {
+			memset(p, 0, CHUNK);
+			for (k = 0; k < N_COEF; k++) {
+				if ((gf_tb = GF16crt4bitRegTbl(coef[k], 0))
+						== NULL) {
+					exit(1);
+				}
+				GF16lkupRegionXor(gf_tb,
+					b + (j * N_COEF + k) * CHUNK, p, CHUNK);
+				free(gf_tb);
+			}
+		}
+	}
+	gettimeofday(&end, NULL);
+	t_crt = (end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec);
+
+	// Tables from the bank of all coefficients (8MB)
+	if (GF16init4bitBank(GF16_BANK_128) < 0) {
+		exit(1);
+	}
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < n_req; j++) {
+			memset(p, 0, CHUNK);
+			for (k = 0; k < N_COEF; k++) {
+				GF16lkupRegionXor(GF16get4bitBank(coef[k]),
+					b + (j * N_COEF + k) * CHUNK, p, CHUNK);
+			}
+		}
+	}
+	gettimeofday(&end, NULL);
+	t_bank = (end.tv_sec * 1000000 + end.tv_usec) -
+		 (start.tv_sec * 1000000 + start.tv_usec);
+	GF16free4bitBank();
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t_cache);
+	printf("GF16crt4bitRegTbl() + free(): %ld\n", t_crt);
+	printf("GF16get4bitBank()            : %ld\n", t_bank);
+
+	exit(0);
+}
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "common.h"
+#include "gf.h"
+#include "mt64.h"
+
+#define TBL_FILE	"gf-tables.tbl"	// Written by GFsaveTbl()
+
+// Elapsed time in us
+static long
+Elapsed(const struct timeval *start, const struct timeval *end)
+{
+	return (end->tv_sec * 1000000 + end->tv_usec) -
+	       (start->tv_sec * 1000000 + start->tv_usec);
+}
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, j;
+	struct timeval	start, end;
+	uint16_t	a, *b, *c;
+	uint64_t	*r;
+	long		t_init, t_file;
+
+	// Build tables as usual and save them
+	gettimeofday(&start, NULL);
+	GF8init(); // 8bit
+	GF16init(); // 16bit
+	gettimeofday(&end, NULL);
+	t_init = Elapsed(&start, &end);
+	if (GFsaveTbl(TBL_FILE) < 0) {
+		exit(1);
+	}
+
+	// Map them as other processes would
+	gettimeofday(&start, NULL);
+	if (GF8initFromFile(TBL_FILE) < 0 || GF16initFromFile(TBL_FILE) < 0) {
+		exit(1);
+	}
+	gettimeofday(&end, NULL);
+	t_file = Elapsed(&start, &end);
+	unlink(TBL_FILE);
+
+	// Allocate b and c
+	if ((b = (uint16_t *)malloc(SPACE * 2)) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	c = b + (SPACE / sizeof(uint16_t));
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to a, b
+	a = (uint16_t)(genrand64_int64() & 0xffff);
+	r = (uint64_t *)b;
+	for (i = 0; i < SPACE / sizeof(uint64_t); i++) {
+		r[i] = genrand64_int64();
+	}
+
+	// Start measuring elapsed time
+	gettimeofday(&start, NULL); // Get start time
+
+	// Use GF16mul to calculate a * b[j]
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < SPACE / sizeof(uint16_t); j++) {
+			// Calculate in GF
+			// To avoid elimination by cc's -O2 option,
+			// input result into c[j]
+			c[j] = GF16mul(a, b[j]);
+		}
+	}
+
+	// Get end time
+	gettimeofday(&end, NULL);
+
+	// Print result
+	printf("%ld\n", Elapsed(&start, &end));
+	printf("GF8init() + GF16init()                : %ld\n", t_init);
+	printf("GF8initFromFile() + GF16initFromFile(): %ld\n", t_file);
+
+	exit(0);
+}
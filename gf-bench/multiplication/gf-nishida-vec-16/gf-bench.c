@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "common.h"
+#include "gf.h"
+#include "mt64.h"
+
+// Main
+int
+main(int argc, char **argv)
+{
+	// Variables
+	int		i, j;
+	struct timeval	start, end;
+	uint16_t	*a, *b, *c;
+	uint64_t	*r;
+	long		t_vec, t_mac;
+
+	// Initialize GF
+	GF16init(); // 16bit
+
+	// Allocate a, b and c
+	if ((a = (uint16_t *)malloc(SPACE * 3)) == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	b = a + (SPACE / sizeof(uint16_t));
+	c = b + (SPACE / sizeof(uint16_t));
+
+	// Initialize random generator
+	init_genrand64(time(NULL));
+
+	// Input random numbers to a, b
+	r = (uint64_t *)a;
+	for (i = 0; i < SPACE * 2 / sizeof(uint64_t); i++) {
+		r[i] = genrand64_int64();
+	}
+
+	// Use GF16mulVec to calculate a[j] * b[j]
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		GF16mulVec(c, a, b, SPACE / sizeof(uint16_t));
+	}
+	gettimeofday(&end, NULL);
+	t_vec = (end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec);
+
+	// Same by GF16mul (the macro loop of gf-nishida-16)
+	gettimeofday(&start, NULL); // Get start time
+	for (i = 0; i < REPEAT; i++) {
+		for (j = 0; j < SPACE / sizeof(uint16_t); j++) {
+			// To avoid elimination by cc's -O2 option,
+			// input result into c[j]
+			c[j] = GF16mul(a[j], b[j]);
+		}
+	}
+	gettimeofday(&end, NULL);
+	t_mac = (end.tv_sec * 1000000 + end.tv_usec) -
+		(start.tv_sec * 1000000 + start.tv_usec);
+
+	// Print result (only the first line is read by gf-bench-all)
+	printf("%ld\n", t_vec);
+	printf("GF16mul loop (%s): %ld\n", GFnameSIMD(GFgetSIMD()), t_mac);
+
+	exit(0);
+}
@@ -1,24 +1,63 @@
 #ifndef _GF_H_
 #define _GF_H_
 
+#include <stddef.h>
 #include <stdint.h>
-#if defined(__SSSE3__) || defined(__AVX2__)
+#if defined(__x86_64__) || defined(__i386__)
+#define _GF_X86_
 #include <immintrin.h>
 #elif defined(_arm64_)
 //#elif defined(__ARM_NEON__) // Clang for arm64 does not support -march=native
 #include <arm_neon.h>
 #endif
 
+// Kernels for each instruction set are compiled with function attributes,
+// so they can be selected at run time regardless of -m options.
+// See GFsetSIMD() in gf.c.
+#if defined(_GF_X86_) && (defined(__GNUC__) || defined(__clang__))
+#define GF_TARGET(isa)	__attribute__((target(isa)))
+#else
+#define GF_TARGET(isa)
+#endif
+
 /****************************************************************************
 
 	Simple and fast multiplication and division functions in
 	GF(2^8) and GF(2^16) based on table lookup(s).
 	Memory consumption for the tables is as follows:
-		GF16mul(), GF16div(): 768kB
+		GF16mul(), GF16div(): 768kB (384kB with _GF16_COMPACT_)
 		GF16crtRegTbl: 128kB (may fit L2 cache)
 		GF16crtSpltRegTbl: 1kB (may fit L1 cache)
 		GF16crt4bitRegTbl: 128B (for 128bit SIMD (SSE))
 		GF16crt4bitRegTbl256: 256B (for 256bit SIMD (AVX))
+		GF16crt4bitRegTbl512: 512B (for 512bit SIMD (AVX-512))
+		GF16crtAffineTbl: 256B (for GFNI)
+		GF8crtAffineTbl: 64B (for GFNI)
+	GF16getRegTbl() lends these tables from a thread safe cache keyed
+	by (coefficient, type, layout) instead of creating them every time.
+	GF16set4bitRegTbl() (and 256, 512) fill them into the caller's
+	memory from 16 basis products a * 2^j by SIMD without lookup.
+	GF16init4bitBank() builds GF16crt4bitRegTbl() (and 256) of all
+	coefficients in 8MB (and 16MB) for GF16get4bitBank(a).
+
+	GF16mulRegion(), GF16divRegion() and GF16mulAddRegion() (and
+	GF8 versions) process a whole buffer of any length with the widest
+	SIMD kernel available without allocating memory.
+	GF16mulAddRegion() and GF16lkupRegionXor() compute
+	y[i] ^= a * x[i] in one pass, which is the parity update of
+	erasure coding.
+	GF16dotRegion() (and GF8dotRegion()) computes
+	y[i] = a_0 * x_0[i] + ... + a_k-1 * x_k-1[i] streaming y[] once,
+	which is one parity row of Reed-Solomon encoding.
+	GF16encodeRegion() computes m rows of them loading x_i[] once
+	for every 4 rows.
+	GF16mulVec() and GF16divVec() compute c[i] = a[i] * b[i] and
+	c[i] = a[i] / b[i] of two arrays with SIMD gathers (AVX2, AVX-512).
+	GF16setVec(GF_VEC_CLMUL) switches GF16mulVec() to carry-less
+	multiplication (PCLMULQDQ, VPCLMULQDQ or PMULL) without tables.
+	The SIMD kernels (SSSE3, AVX2, AVX-512BW, GFNI or NEON) for these region
+	functions are selected by CPUID at run time in GF8init() and
+	GF16init(). Set GF_SIMD environment variable to pin one.
 
 	CAUTION!! Never use b = 0 for disvision (e.g. GF16div(a, b))
 	as it will output a wrong value.
@@ -33,19 +72,32 @@
 ***************************************************************************/
 
 // Variables
+// Flat [256][256] tables aligned to 64 bytes (GF8memDiv follows
+// GF8memMul), so GF8mul(a, b) and GF8div(a, b) are one load each.
 #ifdef _GF_MAIN_
-uint8_t		**GF8memMul = NULL;
-uint8_t		**GF8memDiv = NULL;
+uint8_t		(*GF8memMul)[256] = NULL;
+uint8_t		(*GF8memDiv)[256] = NULL;
 #else
-extern uint8_t	**GF8memMul;
-extern uint8_t	**GF8memDiv;
+extern uint8_t	(*GF8memMul)[256];
+extern uint8_t	(*GF8memDiv)[256];
 #endif
 
+// Field instance with its own primitive polynomial and tables
+// (GF8crtCtx()). GF8init() sets up the default one (GF8memMul, GF8memDiv).
+typedef struct {
+	uint32_t	prim;		// Primitive polynomial
+	uint8_t		(*memMul)[256];	// memMul[a][b] = a * b
+	uint8_t		(*memDiv)[256];	// memDiv[a][b] = a / b
+} GF8ctx;
+
 // Macros
 #define GF8mul(a, b)	(GF8memMul[(a)][(b)])
 #define GF8div(a, b)	(GF8memDiv[(a)][(b)])
+#define GF8mulCtx(ctx, a, b)	((ctx)->memMul[(a)][(b)])
+#define GF8divCtx(ctx, a, b)	((ctx)->memDiv[(a)][(b)])
 
 #define GF8LkupRT(gf_a, x)	gf_a[(x)]
+#define GF8Lkup4bitRT(gf_tb, x)	((gf_tb)[16 + ((x) >> 4)] ^ (gf_tb)[(x) & 0x0f])
 
 // Functions
 void	GF8init(void); 
@@ -53,11 +105,31 @@ void	GF8test(void);
 uint8_t	*GF8crtRegTbl(uint8_t, int);
 uint8_t	*GF8crt4bitRegTbl(uint8_t, int);
 uint8_t	*GF8crt4bitRegTbl256(uint8_t, int);
+uint64_t *GF8crtAffineTbl(uint8_t, int);
+void	GF8lkupRegion(const uint8_t *, const uint8_t *, uint8_t *, size_t);
+void	GF8lkupRegionXor(const uint8_t *, const uint8_t *, uint8_t *, size_t);
+void	GF8mulRegion(uint8_t *, const uint8_t *, size_t, uint8_t);
+void	GF8divRegion(uint8_t *, const uint8_t *, size_t, uint8_t);
+void	GF8mulAddRegion(uint8_t *, const uint8_t *, size_t, uint8_t);
+void	GF8dotRegion(uint8_t *, const uint8_t * const *, const uint8_t *, int,
+		     size_t);
+int	GF8initFromFile(const char *);
+GF8ctx	*GF8crtCtx(uint32_t);
+void	GF8freeCtx(GF8ctx *);
+GF8ctx	*GF8dupCtx(const GF8ctx *);
+void	GF8mulRegionCtx(const GF8ctx *, uint8_t *, const uint8_t *, size_t,
+			uint8_t);
+void	GF8divRegionCtx(const GF8ctx *, uint8_t *, const uint8_t *, size_t,
+			uint8_t);
+void	GF8mulAddRegionCtx(const GF8ctx *, uint8_t *, const uint8_t *, size_t,
+			   uint8_t);
+void	GF8dotRegionCtx(const GF8ctx *, uint8_t *, const uint8_t * const *,
+			const uint8_t *, int, size_t);
 
 // Inline functions
-#if defined(__AVX2__)
+#if defined(_GF_X86_)
 // Get GF(2^8) result by lookup with AVX -- call every 32 bytes 
-static inline void
+GF_TARGET("avx2") static inline void
 GF8lkupSIMD256(const __m256i tb_a_l, const __m256i tb_a_h,
 	       const uint8_t *input, uint8_t *output)
 {
@@ -87,11 +159,177 @@ GF8lkupSIMD256(const __m256i tb_a_l, const __m256i tb_a_h,
 	// Save results
 	_mm256_storeu_si256((__m256i *)output, v_output);
 }
-#endif // __AVX2__
 
-#if defined(__SSSE3__)
+// Same as GF8lkupSIMD256() but XOR result into output (output ^= a * input)
+GF_TARGET("avx2") static inline void
+GF8lkupSIMD256Xor(const __m256i tb_a_l, const __m256i tb_a_h,
+		  const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit multi table region technique with AVX ***/
+	__m256i	v_input, input_l, input_h;
+	__m256i	output_l, output_h, v_output, tmp;
+
+	// Load input
+	v_input = _mm256_loadu_si256((__m256i *)input);
+
+	// Retrieve low 4bit of each byte from input
+	tmp = _mm256_set1_epi8(0x0f);
+	input_l = _mm256_and_si256(v_input, tmp);
+
+	// Retrieve high 4bit of each byte from input
+	input_h = _mm256_and_si256(_mm256_srli_epi16(v_input, 4), tmp);
+
+	// Get GF calc results for input_l (low 4bit)
+	output_l = _mm256_shuffle_epi8(tb_a_l, input_l);
+
+	// Get GF calc results for input_h (high 4bit)
+	output_h = _mm256_shuffle_epi8(tb_a_h, input_h);
+
+	// XOR and get result
+	v_output = _mm256_xor_si256(output_l, output_h);
+
+	// XOR result into output and save
+	v_output = _mm256_xor_si256(v_output,
+				    _mm256_loadu_si256((__m256i *)output));
+	_mm256_storeu_si256((__m256i *)output, v_output);
+}
+
+// Get GF(2^8) result by lookup with AVX-512 -- call every 64 bytes 
+GF_TARGET("avx512f,avx512bw") static inline void
+GF8lkupSIMD512(const __m512i tb_a_l, const __m512i tb_a_h,
+	       const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit multi table region technique with AVX-512 ***/
+	__m512i	v_input, input_l, input_h;
+	__m512i	output_l, output_h, v_output, tmp;
+
+	// Load input
+	v_input = _mm512_loadu_si512((__m512i *)input);
+
+	// Retrieve low 4bit of each byte from input
+	tmp = _mm512_set1_epi8(0x0f);
+	input_l = _mm512_and_si512(v_input, tmp);
+
+	// Retrieve high 4bit of each byte from input
+	input_h = _mm512_and_si512(_mm512_srli_epi16(v_input, 4), tmp);
+
+	// Get GF calc results for input_l (low 4bit)
+	output_l = _mm512_shuffle_epi8(tb_a_l, input_l);
+
+	// Get GF calc results for input_h (high 4bit)
+	output_h = _mm512_shuffle_epi8(tb_a_h, input_h);
+
+	// XOR and get result
+	v_output = _mm512_xor_si512(output_l, output_h);
+
+	// Save results
+	_mm512_storeu_si512((__m512i *)output, v_output);
+}
+
+// Same as GF8lkupSIMD512() but XOR result into output (output ^= a * input)
+GF_TARGET("avx512f,avx512bw") static inline void
+GF8lkupSIMD512Xor(const __m512i tb_a_l, const __m512i tb_a_h,
+		  const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit multi table region technique with AVX-512 ***/
+	__m512i	v_input, input_l, input_h;
+	__m512i	output_l, output_h, v_output, tmp;
+
+	// Load input
+	v_input = _mm512_loadu_si512((__m512i *)input);
+
+	// Retrieve low 4bit of each byte from input
+	tmp = _mm512_set1_epi8(0x0f);
+	input_l = _mm512_and_si512(v_input, tmp);
+
+	// Retrieve high 4bit of each byte from input
+	input_h = _mm512_and_si512(_mm512_srli_epi16(v_input, 4), tmp);
+
+	// Get GF calc results for input_l (low 4bit)
+	output_l = _mm512_shuffle_epi8(tb_a_l, input_l);
+
+	// Get GF calc results for input_h (high 4bit)
+	output_h = _mm512_shuffle_epi8(tb_a_h, input_h);
+
+	// XOR and get result
+	v_output = _mm512_xor_si512(output_l, output_h);
+
+	// XOR result into output and save
+	v_output = _mm512_xor_si512(v_output,
+				    _mm512_loadu_si512((__m512i *)output));
+	_mm512_storeu_si512((__m512i *)output, v_output);
+}
+
+// Get GF(2^8) result by GFNI with AVX -- call every 32 bytes
+// mtx_a is the matrix created by GF8crtAffineTbl() in each 64bit.
+GF_TARGET("gfni,avx2") static inline void
+GF8affineSIMD256(const __m256i mtx_a, const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m256i	v_output;
+
+	// Multiply each byte of input by a
+	v_output = _mm256_gf2p8affine_epi64_epi8(
+			_mm256_loadu_si256((__m256i *)input), mtx_a, 0);
+
+	// Save results
+	_mm256_storeu_si256((__m256i *)output, v_output);
+}
+
+// Same as GF8affineSIMD256() but XOR result into output (output ^= a * input)
+GF_TARGET("gfni,avx2") static inline void
+GF8affineSIMD256Xor(const __m256i mtx_a, const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m256i	v_output;
+
+	// Multiply each byte of input by a
+	v_output = _mm256_gf2p8affine_epi64_epi8(
+			_mm256_loadu_si256((__m256i *)input), mtx_a, 0);
+
+	// XOR result into output and save
+	v_output = _mm256_xor_si256(v_output,
+				    _mm256_loadu_si256((__m256i *)output));
+	_mm256_storeu_si256((__m256i *)output, v_output);
+}
+
+// Get GF(2^8) result by GFNI with AVX-512 -- call every 64 bytes
+// mtx_a is the matrix created by GF8crtAffineTbl() in each 64bit.
+GF_TARGET("gfni,avx512f,avx512bw") static inline void
+GF8affineSIMD512(const __m512i mtx_a, const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m512i	v_output;
+
+	// Multiply each byte of input by a
+	v_output = _mm512_gf2p8affine_epi64_epi8(
+			_mm512_loadu_si512((__m512i *)input), mtx_a, 0);
+
+	// Save results
+	_mm512_storeu_si512((__m512i *)output, v_output);
+}
+
+// Same as GF8affineSIMD512() but XOR result into output (output ^= a * input)
+GF_TARGET("gfni,avx512f,avx512bw") static inline void
+GF8affineSIMD512Xor(const __m512i mtx_a, const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m512i	v_output;
+
+	// Multiply each byte of input by a
+	v_output = _mm512_gf2p8affine_epi64_epi8(
+			_mm512_loadu_si512((__m512i *)input), mtx_a, 0);
+
+	// XOR result into output and save
+	v_output = _mm512_xor_si512(v_output,
+				    _mm512_loadu_si512((__m512i *)output));
+	_mm512_storeu_si512((__m512i *)output, v_output);
+}
+#endif // _GF_X86_
+
+#if defined(_GF_X86_)
 // Get GF(2^8) result by lookup by SSE -- call every 16 bytes 
-static inline void
+GF_TARGET("ssse3") static inline void
 GF8lkupSIMD128(const __m128i tb_a_l, const __m128i tb_a_h,
 	       const uint8_t *input, uint8_t *output)
 {
@@ -121,6 +359,39 @@ GF8lkupSIMD128(const __m128i tb_a_l, const __m128i tb_a_h,
 	// Save results
 	_mm_storeu_si128((__m128i *)output, v_output);
 }
+
+// Same as GF8lkupSIMD128() but XOR result into output (output ^= a * input)
+GF_TARGET("ssse3") static inline void
+GF8lkupSIMD128Xor(const __m128i tb_a_l, const __m128i tb_a_h,
+		  const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit multi table region technique by SSE ***/
+	__m128i	v_input, input_l, input_h;
+	__m128i	output_l, output_h, v_output, tmp;
+
+	// Load input
+	v_input = _mm_loadu_si128((__m128i *)input);
+
+	// Retrieve low 4bit of each byte from input
+	tmp = _mm_set1_epi8(0x0f);
+	input_l = _mm_and_si128(v_input, tmp);
+
+	// Retrieve high 4bit of each byte from input
+	input_h = _mm_and_si128(_mm_srli_epi16(v_input, 4), tmp);
+
+	// Get GF calc results for input_l (low 4bit)
+	output_l = _mm_shuffle_epi8(tb_a_l, input_l);
+
+	// Get GF calc results for input_h (high 4bit)
+	output_h = _mm_shuffle_epi8(tb_a_h, input_h);
+
+	// XOR and get result
+	v_output = _mm_xor_si128(output_l, output_h);
+
+	// XOR result into output and save
+	v_output = _mm_xor_si128(v_output, _mm_loadu_si128((__m128i *)output));
+	_mm_storeu_si128((__m128i *)output, v_output);
+}
 #elif defined(_arm64_) // NEON
 // Get GF(2^8) result by lookup by NEON -- call every 16 bytes 
 static inline void
@@ -153,7 +424,40 @@ GF8lkupSIMD128(const uint8x16_t tb_a_l, const uint8x16_t tb_a_h,
 	// Save result
 	vst1q_u8(output, v_output);
 }
-#endif // __SSSE3__ || _arm64_
+
+// Same as GF8lkupSIMD128() but XOR result into output (output ^= a * input)
+static inline void
+GF8lkupSIMD128Xor(const uint8x16_t tb_a_l, const uint8x16_t tb_a_h,
+		  const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit table lookup region technique with NEON ***/
+	uint8x16_t	v_input, input_l, input_h;
+	uint8x16_t	output_l, output_h, v_output, tmp;
+
+	// Load input
+	v_input = vld1q_u8(input);
+
+	// Retrieve low 4bit of each byte from v_input
+	tmp = vdupq_n_u8(0x0f);
+	input_l = vandq_u8(v_input, tmp);
+
+	// Retrieve high 4bit of each byte from v_input
+	input_h = vshrq_n_u8(v_input, 4);
+
+	// Get GF calc results for input_l (low 4bit)
+	output_l = vqtbl1q_u8(tb_a_l, input_l);
+
+	// Get GF calc results for input_h (high 4bit)
+	output_h = vqtbl1q_u8(tb_a_h, input_h);
+
+	// XOR and get result
+	v_output = veorq_u8(output_l, output_h);
+
+	// XOR result into output and save
+	v_output = veorq_u8(v_output, vld1q_u8(output));
+	vst1q_u8(output, v_output);
+}
+#endif // _GF_X86_ || _arm64_
 
 /***************************************************************************
 	16bit: GF(2^16)
@@ -162,8 +466,11 @@ GF8lkupSIMD128(const uint8x16_t tb_a_l, const uint8x16_t tb_a_h,
 // Macros 
 // To achieve fast computation, we do not check if a, b == 0
 // CAUTION: DO NOT USE b = 0 for GF16div(a, b). IT DOES NOT WORK CORRECTLY.
+// With _GF16_COMPACT_, they are inline functions below.
+#if !defined(_GF16_COMPACT_)
 #define	GF16mul(a, b)	(GF16memL[GF16memIdx[(a)] + GF16memIdx[(b)]])
 #define	GF16div(a, b)	(GF16memH[GF16memIdx[(a)] - GF16memIdx[(b)]])
+#endif
 
 #define GF16crtRegTblMul(a)		GF16crtRegTbl(a, 0)
 #define GF16crtRegTblDiv(a)		GF16crtRegTbl(a, 1)
@@ -173,27 +480,162 @@ GF8lkupSIMD128(const uint8x16_t tb_a_l, const uint8x16_t tb_a_h,
 #define GF16LkupRT(gf_a, x)		gf_a[(x)]
 #define GF16LkupSRT(gf_a_l, gf_a_h, x)	\
 		((gf_a_h)[(x) >> 8] ^ (gf_a_l)[(x) & 0xff])
+#define GF16Lkup4bitRT(gf_tb, x)	\
+		((uint16_t)((gf_tb)[(x) & 0xf] ^			\
+			    (gf_tb)[32 + (((x) >> 4) & 0xf)] ^		\
+			    (gf_tb)[64 + (((x) >> 8) & 0xf)] ^		\
+			    (gf_tb)[96 + (((x) >> 12) & 0xf)]) |		\
+		 (uint16_t)(((gf_tb)[16 + ((x) & 0xf)] ^		\
+			     (gf_tb)[48 + (((x) >> 4) & 0xf)] ^		\
+			     (gf_tb)[80 + (((x) >> 8) & 0xf)] ^		\
+			     (gf_tb)[112 + (((x) >> 12) & 0xf)]) << 8))
+
+// Definitions
+// Define _GF16_COMPACT_ to use compact tables for GF16mul() and GF16div()
+// (384kB instead of 768kB): logs (GF16memIdx) are uint16_t and antilogs
+// (GF16memL) are two periods without zero area, so a, b == 0 are checked
+// by branch. It fits L2 cache better on small cores.
+#if defined(_GF16_COMPACT_)
+typedef uint16_t	GF16idx;
+#define GF16_LOG0	0xffff	// Log of 0 (sentinel)
+#else
+typedef int		GF16idx;
+#endif
+
+// Field instance with its own primitive polynomial and tables
+// (GF16crtCtx()). Tables have the same layout as GF16memL, GF16memH and
+// GF16memIdx, which GF16init() sets up as the default one.
+typedef struct {
+	uint32_t	prim;		// Primitive polynomial
+	uint16_t	*memL, *memH;	// Antilogs (memH = memL + 65535)
+	GF16idx		*memIdx;	// Logs
+} GF16ctx;
+
+// Layouts of region tables for GF16getRegTbl()
+#define GF16_TBL_REG		0	// GF16crtRegTbl() (128kB)
+#define GF16_TBL_SPLT		1	// GF16crtSpltRegTbl() (1kB)
+#define GF16_TBL_4BIT		2	// GF16crt4bitRegTbl() (128B)
+#define GF16_TBL_4BIT256	3	// GF16crt4bitRegTbl256() (256B)
+#define GF16_TBL_4BIT512	4	// GF16crt4bitRegTbl512() (512B)
+#define GF16_TBL_AFFINE		5	// GF16crtAffineTbl() (256B)
+#define GF16_TBL_NUM		6
+
+// Banks of 4bit tables for GF16init4bitBank()
+#define GF16_BANK_128		1	// GF16crt4bitRegTbl() of all a (8MB)
+#define GF16_BANK_256		2	// GF16crt4bitRegTbl256() of all a (16MB)
+#define GF16_BANK_ALIGN		(2 * 1024 * 1024)	// Huge page size
+
+// Tables of a in the banks (GF16bank4bit* must not be NULL)
+#define GF16get4bitBank(a)	(GF16bank4bit + ((size_t)(a) << 7))
+#define GF16get4bitBank256(a)	(GF16bank4bit256 + ((size_t)(a) << 8))
+
+// Default budget of table cache (GF16setRegTblCache())
+#define GF16_TBL_CACHE_DEF	(8 * 1024 * 1024)
+
+// Backends of GF16mulVec() for GF16setVec()
+#define GF_VEC_TABLE	0	// Log/antilog tables (SIMD gathers)
+#define GF_VEC_CLMUL	1	// Carry-less multiplication + Barrett reduction
 
 // Variables
 #ifdef _GF_MAIN_
 uint16_t	*GF16memL = NULL, *GF16memH = NULL;
-int		*GF16memIdx = NULL;
+GF16idx		*GF16memIdx = NULL;
+uint8_t		*GF16bank4bit = NULL, *GF16bank4bit256 = NULL;
 #else
 extern uint16_t	*GF16memL, *GF16memH;
-extern int	*GF16memIdx;
+extern GF16idx	*GF16memIdx;
+extern uint8_t	*GF16bank4bit, *GF16bank4bit256;
+#endif
+
+#if defined(_GF16_COMPACT_)
+// Multiplication and division with compact tables
+static inline uint16_t
+GF16mul(uint16_t a, uint16_t b)
+{
+	return (a == 0 || b == 0) ? 0 :
+		GF16memL[GF16memIdx[a] + GF16memIdx[b]];
+}
+
+static inline uint16_t
+GF16div(uint16_t a, uint16_t b)
+{
+	return a == 0 ? 0 : GF16memH[GF16memIdx[a] - GF16memIdx[b]];
+}
+
+static inline uint16_t
+GF16mulCtx(const GF16ctx *ctx, uint16_t a, uint16_t b)
+{
+	return (a == 0 || b == 0) ? 0 :
+		ctx->memL[ctx->memIdx[a] + ctx->memIdx[b]];
+}
+
+static inline uint16_t
+GF16divCtx(const GF16ctx *ctx, uint16_t a, uint16_t b)
+{
+	return a == 0 ? 0 : ctx->memH[ctx->memIdx[a] - ctx->memIdx[b]];
+}
+#else
+#define GF16mulCtx(ctx, a, b)	\
+		((ctx)->memL[(ctx)->memIdx[(a)] + (ctx)->memIdx[(b)]])
+#define GF16divCtx(ctx, a, b)	\
+		((ctx)->memH[(ctx)->memIdx[(a)] - (ctx)->memIdx[(b)]])
 #endif
 
 // Functions
 void		GF16init(void); 
+int		GF16initFromFile(const char *);
 uint16_t	*GF16crtRegTbl(uint16_t, int);
 uint16_t	*GF16crtSpltRegTbl(uint16_t, int);
 uint8_t		*GF16crt4bitRegTbl(uint16_t, int);
 uint8_t		*GF16crt4bitRegTbl256(uint16_t, int);
+uint8_t		*GF16crt4bitRegTbl512(uint16_t, int);
+uint64_t	*GF16crtAffineTbl(uint16_t, int);
+void		GF16set4bitRegTbl(uint8_t *, uint16_t, int);
+void		GF16set4bitRegTbl256(uint8_t *, uint16_t, int);
+void		GF16set4bitRegTbl512(uint8_t *, uint16_t, int);
+void		*GF16getRegTbl(uint16_t, int, int);
+void		GF16putRegTbl(const void *);
+void		GF16setRegTblCache(size_t);
+int		GF16init4bitBank(int);
+void		GF16free4bitBank(void);
+void		GF16lkupRegion(const uint8_t *, const uint8_t *, uint8_t *,
+			       size_t);
+void		GF16lkupRegionXor(const uint8_t *, const uint8_t *, uint8_t *,
+				  size_t);
+void		GF16mulRegion(uint8_t *, const uint8_t *, size_t, uint16_t);
+void		GF16divRegion(uint8_t *, const uint8_t *, size_t, uint16_t);
+void		GF16mulAddRegion(uint8_t *, const uint8_t *, size_t, uint16_t);
+void		GF16dotRegion(uint8_t *, const uint8_t * const *,
+			      const uint16_t *, int, size_t);
+void		GF16encodeRegion(uint8_t * const *, const uint8_t * const *,
+				 const uint16_t *, int, int, size_t);
+void		GF16mulVec(uint16_t *, const uint16_t *, const uint16_t *,
+			   size_t);
+void		GF16divVec(uint16_t *, const uint16_t *, const uint16_t *,
+			   size_t);
+int		GF16setVec(int);
+int		GF16getVec(void);
+GF16ctx		*GF16crtCtx(uint32_t);
+void		GF16freeCtx(GF16ctx *);
+GF16ctx		*GF16dupCtx(const GF16ctx *);
+void		GF16set4bitRegTblCtx(const GF16ctx *, uint8_t *, uint16_t, int);
+void		GF16mulRegionCtx(const GF16ctx *, uint8_t *, const uint8_t *,
+				 size_t, uint16_t);
+void		GF16divRegionCtx(const GF16ctx *, uint8_t *, const uint8_t *,
+				 size_t, uint16_t);
+void		GF16mulAddRegionCtx(const GF16ctx *, uint8_t *, const uint8_t *,
+				    size_t, uint16_t);
+void		GF16dotRegionCtx(const GF16ctx *, uint8_t *,
+				 const uint8_t * const *, const uint16_t *, int,
+				 size_t);
+void		GF16encodeRegionCtx(const GF16ctx *, uint8_t * const *,
+				    const uint8_t * const *, const uint16_t *,
+				    int, int, size_t);
 
 // Inline functions
-#if defined(__SSSE3__)
+#if defined(_GF_X86_)
 // Get GF(2^16) result by lookup by SSE -- call every 32 bytes 
-static inline void
+GF_TARGET("ssse3") static inline void
 GF16lkupSIMD128x2(const __m128i tb_a_0_l, const __m128i tb_a_0_h,
 		  const __m128i tb_a_1_l, const __m128i tb_a_1_h,
 		  const __m128i tb_a_2_l, const __m128i tb_a_2_h,
@@ -270,9 +712,78 @@ GF16lkupSIMD128x2(const __m128i tb_a_0_l, const __m128i tb_a_0_h,
 	_mm_storeu_si128((__m128i *)(output + 16), output_h);
 }
 
-#if defined(__AVX2__)
+// Same as GF16lkupSIMD128x2() but XOR results into output
+// (output ^= a * input) -- call every 32 bytes
+GF_TARGET("ssse3") static inline void
+GF16lkupSIMD128x2Xor(const __m128i tb_a_0_l, const __m128i tb_a_0_h,
+		     const __m128i tb_a_1_l, const __m128i tb_a_1_h,
+		     const __m128i tb_a_2_l, const __m128i tb_a_2_h,
+		     const __m128i tb_a_3_l, const __m128i tb_a_3_h,
+		     const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit table lookup region technique with SSSE3 ***/
+	__m128i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m128i	input_l_l, input_l_h, input_h_l, input_h_h;
+	__m128i	output_l, output_h, tmp;
+
+	// Load inputs
+	input_0 = _mm_loadu_si128((__m128i *)input);
+	input_1 = _mm_loadu_si128((__m128i *)(input + 16));
+
+	// Pack low bytes of inputs to input_l
+	tmp = _mm_set1_epi16(0x00ff);
+	v_0 = _mm_and_si128(input_0, tmp);
+	v_1 = _mm_and_si128(input_1, tmp);
+	input_l = _mm_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm_srli_epi16(input_0, 8);
+	v_1 = _mm_srli_epi16(input_1, 8);
+	input_h = _mm_packus_epi16(v_0, v_1);
+
+	// Retrieve low 4bit of each byte from input_l
+	tmp = _mm_set1_epi8(0x0f);
+	input_l_l = _mm_and_si128(input_l, tmp);
+
+	// Retrieve high 4bit of each byte from input_l
+	v_0 = _mm_srli_epi16(input_l, 4);
+	input_l_h = _mm_and_si128(v_0, tmp);
+
+	// Retrieve low 4bit of each byte from input_h
+	input_h_l = _mm_and_si128(input_h, tmp);
+
+	// Retrieve high 4bit of each byte from input_h
+	v_0 = _mm_srli_epi16(input_h, 4);
+	input_h_h = _mm_and_si128(v_0, tmp);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm_shuffle_epi8(tb_a_0_l, input_l_l);
+	v_0 = _mm_xor_si128(v_0, _mm_shuffle_epi8(tb_a_1_l, input_l_h));
+	v_0 = _mm_xor_si128(v_0, _mm_shuffle_epi8(tb_a_2_l, input_h_l));
+	v_0 = _mm_xor_si128(v_0, _mm_shuffle_epi8(tb_a_3_l, input_h_h));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm_shuffle_epi8(tb_a_0_h, input_l_l);
+	v_1 = _mm_xor_si128(v_1, _mm_shuffle_epi8(tb_a_1_h, input_l_h));
+	v_1 = _mm_xor_si128(v_1, _mm_shuffle_epi8(tb_a_2_h, input_h_l));
+	v_1 = _mm_xor_si128(v_1, _mm_shuffle_epi8(tb_a_3_h, input_h_h));
+
+	// Unpack low bytes and XOR into output
+	output_l = _mm_unpacklo_epi8(v_0, v_1);
+	output_l = _mm_xor_si128(output_l, _mm_loadu_si128((__m128i *)output));
+
+	// Unpack high bytes and XOR into output
+	output_h = _mm_unpackhi_epi8(v_0, v_1);
+	output_h = _mm_xor_si128(output_h,
+				 _mm_loadu_si128((__m128i *)(output + 16)));
+
+	// Save results
+	_mm_storeu_si128((__m128i *)output, output_l);
+	_mm_storeu_si128((__m128i *)(output + 16), output_h);
+}
+
 // Get GF(2^16) result by lookup with AVX -- call every 64 bytes 
-static inline void
+GF_TARGET("avx2") static inline void
 GF16lkupSIMD256x2(const __m256i tb_a_0_l, const __m256i tb_a_0_h,
 		  const __m256i tb_a_1_l, const __m256i tb_a_1_h,
 		  const __m256i tb_a_2_l, const __m256i tb_a_2_h,
@@ -335,8 +846,409 @@ GF16lkupSIMD256x2(const __m256i tb_a_0_l, const __m256i tb_a_0_h,
 	_mm256_storeu_si256((__m256i *)output, output_l);
 	_mm256_storeu_si256((__m256i *)(output + 32), output_h);
 }
-#endif // __AVX2__
 
+// Same as GF16lkupSIMD256x2() but XOR results into output
+// (output ^= a * input) -- call every 64 bytes
+GF_TARGET("avx2") static inline void
+GF16lkupSIMD256x2Xor(const __m256i tb_a_0_l, const __m256i tb_a_0_h,
+		     const __m256i tb_a_1_l, const __m256i tb_a_1_h,
+		     const __m256i tb_a_2_l, const __m256i tb_a_2_h,
+		     const __m256i tb_a_3_l, const __m256i tb_a_3_h,
+		     const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit multi table region technique with AVX ***/
+	__m256i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m256i	input_l_l, input_l_h, input_h_l, input_h_h;
+	__m256i	output_l, output_h, tmp;
+
+	input_0 = _mm256_loadu_si256((__m256i *)input);
+	input_1 = _mm256_loadu_si256((__m256i *)(input + 32));
+
+	// Pack low bytes of inputs to input_l
+	tmp = _mm256_set1_epi16(0x00ff);
+	v_0 = _mm256_and_si256(input_0, tmp);
+	v_1 = _mm256_and_si256(input_1, tmp);
+	input_l = _mm256_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm256_srli_epi16(input_0, 8);
+	v_1 = _mm256_srli_epi16(input_1, 8);
+	input_h = _mm256_packus_epi16(v_0, v_1);
+
+	// Retrieve low 4bit of each byte from input_l
+	tmp = _mm256_set1_epi8(0x0f);
+	input_l_l = _mm256_and_si256(input_l, tmp);
+
+	// Retrieve high 4bit of each byte from input_l
+	v_0 = _mm256_srli_epi16(input_l, 4);
+	input_l_h = _mm256_and_si256(v_0, tmp);
+
+	// Retrieve low 4bit of each byte from input_h
+	input_h_l = _mm256_and_si256(input_h, tmp);
+
+	// Retrieve high 4bit of each byte from input_h
+	v_0 = _mm256_srli_epi16(input_h, 4);
+	input_h_h = _mm256_and_si256(v_0, tmp);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm256_shuffle_epi8(tb_a_0_l, input_l_l);
+	v_0 = _mm256_xor_si256(v_0, _mm256_shuffle_epi8(tb_a_1_l, input_l_h));
+	v_0 = _mm256_xor_si256(v_0, _mm256_shuffle_epi8(tb_a_2_l, input_h_l));
+	v_0 = _mm256_xor_si256(v_0, _mm256_shuffle_epi8(tb_a_3_l, input_h_h));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm256_shuffle_epi8(tb_a_0_h, input_l_l);
+	v_1 = _mm256_xor_si256(v_1, _mm256_shuffle_epi8(tb_a_1_h, input_l_h));
+	v_1 = _mm256_xor_si256(v_1, _mm256_shuffle_epi8(tb_a_2_h, input_h_l));
+	v_1 = _mm256_xor_si256(v_1, _mm256_shuffle_epi8(tb_a_3_h, input_h_h));
+
+	// Unpack low bytes and XOR into output
+	output_l = _mm256_unpacklo_epi8(v_0, v_1);
+	output_l = _mm256_xor_si256(output_l,
+				    _mm256_loadu_si256((__m256i *)output));
+
+	// Unpack high bytes and XOR into output
+	output_h = _mm256_unpackhi_epi8(v_0, v_1);
+	output_h = _mm256_xor_si256(output_h,
+				    _mm256_loadu_si256((__m256i *)(output + 32)));
+
+	// Save results
+	_mm256_storeu_si256((__m256i *)output, output_l);
+	_mm256_storeu_si256((__m256i *)(output + 32), output_h);
+}
+
+// Get GF(2^16) result by lookup with AVX-512 -- call every 128 bytes 
+GF_TARGET("avx512f,avx512bw") static inline void
+GF16lkupSIMD512x2(const __m512i tb_a_0_l, const __m512i tb_a_0_h,
+		  const __m512i tb_a_1_l, const __m512i tb_a_1_h,
+		  const __m512i tb_a_2_l, const __m512i tb_a_2_h,
+		  const __m512i tb_a_3_l, const __m512i tb_a_3_h,
+		  const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit multi table region technique with AVX-512 ***/
+	__m512i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m512i	input_l_l, input_l_h, input_h_l, input_h_h;
+	__m512i	output_l, output_h, tmp;
+
+	input_0 = _mm512_loadu_si512((__m512i *)input);
+	input_1 = _mm512_loadu_si512((__m512i *)(input + 64));
+
+	// Pack low bytes of inputs to input_l
+	// (packus works in each 128bit lane as AVX2 does, so unpack below
+	//  restores the original order)
+	tmp = _mm512_set1_epi16(0x00ff);
+	v_0 = _mm512_and_si512(input_0, tmp);
+	v_1 = _mm512_and_si512(input_1, tmp);
+	input_l = _mm512_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm512_srli_epi16(input_0, 8);
+	v_1 = _mm512_srli_epi16(input_1, 8);
+	input_h = _mm512_packus_epi16(v_0, v_1);
+
+	// Retrieve low 4bit of each byte from input_l
+	tmp = _mm512_set1_epi8(0x0f);
+	input_l_l = _mm512_and_si512(input_l, tmp);
+
+	// Retrieve high 4bit of each byte from input_l
+	v_0 = _mm512_srli_epi16(input_l, 4);
+	input_l_h = _mm512_and_si512(v_0, tmp);
+
+	// Retrieve low 4bit of each byte from input_h
+	input_h_l = _mm512_and_si512(input_h, tmp);
+
+	// Retrieve high 4bit of each byte from input_h
+	v_0 = _mm512_srli_epi16(input_h, 4);
+	input_h_h = _mm512_and_si512(v_0, tmp);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm512_shuffle_epi8(tb_a_0_l, input_l_l);
+	v_0 = _mm512_xor_si512(v_0, _mm512_shuffle_epi8(tb_a_1_l, input_l_h));
+	v_0 = _mm512_xor_si512(v_0, _mm512_shuffle_epi8(tb_a_2_l, input_h_l));
+	v_0 = _mm512_xor_si512(v_0, _mm512_shuffle_epi8(tb_a_3_l, input_h_h));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm512_shuffle_epi8(tb_a_0_h, input_l_l);
+	v_1 = _mm512_xor_si512(v_1, _mm512_shuffle_epi8(tb_a_1_h, input_l_h));
+	v_1 = _mm512_xor_si512(v_1, _mm512_shuffle_epi8(tb_a_2_h, input_h_l));
+	v_1 = _mm512_xor_si512(v_1, _mm512_shuffle_epi8(tb_a_3_h, input_h_h));
+
+	// Unpack low bytes
+	output_l = _mm512_unpacklo_epi8(v_0, v_1);
+
+	// Unpack high bytes
+	output_h = _mm512_unpackhi_epi8(v_0, v_1);
+
+	// Save results
+	_mm512_storeu_si512((__m512i *)output, output_l);
+	_mm512_storeu_si512((__m512i *)(output + 64), output_h);
+}
+
+// Same as GF16lkupSIMD512x2() but XOR results into output
+// (output ^= a * input) -- call every 128 bytes
+GF_TARGET("avx512f,avx512bw") static inline void
+GF16lkupSIMD512x2Xor(const __m512i tb_a_0_l, const __m512i tb_a_0_h,
+		     const __m512i tb_a_1_l, const __m512i tb_a_1_h,
+		     const __m512i tb_a_2_l, const __m512i tb_a_2_h,
+		     const __m512i tb_a_3_l, const __m512i tb_a_3_h,
+		     const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit multi table region technique with AVX-512 ***/
+	__m512i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m512i	input_l_l, input_l_h, input_h_l, input_h_h;
+	__m512i	output_l, output_h, tmp;
+
+	input_0 = _mm512_loadu_si512((__m512i *)input);
+	input_1 = _mm512_loadu_si512((__m512i *)(input + 64));
+
+	// Pack low bytes of inputs to input_l
+	// (packus works in each 128bit lane as AVX2 does, so unpack below
+	//  restores the original order)
+	tmp = _mm512_set1_epi16(0x00ff);
+	v_0 = _mm512_and_si512(input_0, tmp);
+	v_1 = _mm512_and_si512(input_1, tmp);
+	input_l = _mm512_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm512_srli_epi16(input_0, 8);
+	v_1 = _mm512_srli_epi16(input_1, 8);
+	input_h = _mm512_packus_epi16(v_0, v_1);
+
+	// Retrieve low 4bit of each byte from input_l
+	tmp = _mm512_set1_epi8(0x0f);
+	input_l_l = _mm512_and_si512(input_l, tmp);
+
+	// Retrieve high 4bit of each byte from input_l
+	v_0 = _mm512_srli_epi16(input_l, 4);
+	input_l_h = _mm512_and_si512(v_0, tmp);
+
+	// Retrieve low 4bit of each byte from input_h
+	input_h_l = _mm512_and_si512(input_h, tmp);
+
+	// Retrieve high 4bit of each byte from input_h
+	v_0 = _mm512_srli_epi16(input_h, 4);
+	input_h_h = _mm512_and_si512(v_0, tmp);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm512_shuffle_epi8(tb_a_0_l, input_l_l);
+	v_0 = _mm512_xor_si512(v_0, _mm512_shuffle_epi8(tb_a_1_l, input_l_h));
+	v_0 = _mm512_xor_si512(v_0, _mm512_shuffle_epi8(tb_a_2_l, input_h_l));
+	v_0 = _mm512_xor_si512(v_0, _mm512_shuffle_epi8(tb_a_3_l, input_h_h));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm512_shuffle_epi8(tb_a_0_h, input_l_l);
+	v_1 = _mm512_xor_si512(v_1, _mm512_shuffle_epi8(tb_a_1_h, input_l_h));
+	v_1 = _mm512_xor_si512(v_1, _mm512_shuffle_epi8(tb_a_2_h, input_h_l));
+	v_1 = _mm512_xor_si512(v_1, _mm512_shuffle_epi8(tb_a_3_h, input_h_h));
+
+	// Unpack low bytes and XOR into output
+	output_l = _mm512_unpacklo_epi8(v_0, v_1);
+	output_l = _mm512_xor_si512(output_l,
+				    _mm512_loadu_si512((__m512i *)output));
+
+	// Unpack high bytes and XOR into output
+	output_h = _mm512_unpackhi_epi8(v_0, v_1);
+	output_h = _mm512_xor_si512(output_h,
+				    _mm512_loadu_si512((__m512i *)(output + 64)));
+
+	// Save results
+	_mm512_storeu_si512((__m512i *)output, output_l);
+	_mm512_storeu_si512((__m512i *)(output + 64), output_h);
+}
+
+// Get GF(2^16) result by GFNI with AVX -- call every 64 bytes
+// Multiplication by a is a 16x16 bit matrix, which is split into four
+// 8x8 bit matrices created by GF16crtAffineTbl().
+// mtx_a_XY maps byte Y (l: low, h: high) of input to byte X of output.
+GF_TARGET("gfni,avx2") static inline void
+GF16affineSIMD256x2(const __m256i mtx_a_ll, const __m256i mtx_a_lh,
+		    const __m256i mtx_a_hl, const __m256i mtx_a_hh,
+		    const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m256i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m256i	output_l, output_h, tmp;
+
+	input_0 = _mm256_loadu_si256((__m256i *)input);
+	input_1 = _mm256_loadu_si256((__m256i *)(input + 32));
+
+	// Pack low bytes of inputs to input_l
+	tmp = _mm256_set1_epi16(0x00ff);
+	v_0 = _mm256_and_si256(input_0, tmp);
+	v_1 = _mm256_and_si256(input_1, tmp);
+	input_l = _mm256_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm256_srli_epi16(input_0, 8);
+	v_1 = _mm256_srli_epi16(input_1, 8);
+	input_h = _mm256_packus_epi16(v_0, v_1);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm256_gf2p8affine_epi64_epi8(input_l, mtx_a_ll, 0);
+	v_0 = _mm256_xor_si256(v_0,
+		_mm256_gf2p8affine_epi64_epi8(input_h, mtx_a_lh, 0));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm256_gf2p8affine_epi64_epi8(input_l, mtx_a_hl, 0);
+	v_1 = _mm256_xor_si256(v_1,
+		_mm256_gf2p8affine_epi64_epi8(input_h, mtx_a_hh, 0));
+
+	// Unpack low bytes
+	output_l = _mm256_unpacklo_epi8(v_0, v_1);
+
+	// Unpack high bytes
+	output_h = _mm256_unpackhi_epi8(v_0, v_1);
+
+	// Save results
+	_mm256_storeu_si256((__m256i *)output, output_l);
+	_mm256_storeu_si256((__m256i *)(output + 32), output_h);
+}
+
+// Same as GF16affineSIMD256x2() but XOR results into output
+// (output ^= a * input) -- call every 64 bytes
+GF_TARGET("gfni,avx2") static inline void
+GF16affineSIMD256x2Xor(const __m256i mtx_a_ll, const __m256i mtx_a_lh,
+		       const __m256i mtx_a_hl, const __m256i mtx_a_hh,
+		       const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m256i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m256i	output_l, output_h, tmp;
+
+	input_0 = _mm256_loadu_si256((__m256i *)input);
+	input_1 = _mm256_loadu_si256((__m256i *)(input + 32));
+
+	// Pack low bytes of inputs to input_l
+	tmp = _mm256_set1_epi16(0x00ff);
+	v_0 = _mm256_and_si256(input_0, tmp);
+	v_1 = _mm256_and_si256(input_1, tmp);
+	input_l = _mm256_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm256_srli_epi16(input_0, 8);
+	v_1 = _mm256_srli_epi16(input_1, 8);
+	input_h = _mm256_packus_epi16(v_0, v_1);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm256_gf2p8affine_epi64_epi8(input_l, mtx_a_ll, 0);
+	v_0 = _mm256_xor_si256(v_0,
+		_mm256_gf2p8affine_epi64_epi8(input_h, mtx_a_lh, 0));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm256_gf2p8affine_epi64_epi8(input_l, mtx_a_hl, 0);
+	v_1 = _mm256_xor_si256(v_1,
+		_mm256_gf2p8affine_epi64_epi8(input_h, mtx_a_hh, 0));
+
+	// Unpack low bytes
+	output_l = _mm256_unpacklo_epi8(v_0, v_1);
+
+	// Unpack high bytes
+	output_h = _mm256_unpackhi_epi8(v_0, v_1);
+
+	// XOR results into output and save
+	output_l = _mm256_xor_si256(output_l, _mm256_loadu_si256((__m256i *)output));
+	output_h = _mm256_xor_si256(output_h,
+			_mm256_loadu_si256((__m256i *)(output + 32)));
+	_mm256_storeu_si256((__m256i *)output, output_l);
+	_mm256_storeu_si256((__m256i *)(output + 32), output_h);
+}
+
+// Get GF(2^16) result by GFNI with AVX-512 -- call every 128 bytes
+// Multiplication by a is a 16x16 bit matrix, which is split into four
+// 8x8 bit matrices created by GF16crtAffineTbl().
+// mtx_a_XY maps byte Y (l: low, h: high) of input to byte X of output.
+GF_TARGET("gfni,avx512f,avx512bw") static inline void
+GF16affineSIMD512x2(const __m512i mtx_a_ll, const __m512i mtx_a_lh,
+		    const __m512i mtx_a_hl, const __m512i mtx_a_hh,
+		    const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m512i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m512i	output_l, output_h, tmp;
+
+	input_0 = _mm512_loadu_si512((__m512i *)input);
+	input_1 = _mm512_loadu_si512((__m512i *)(input + 64));
+
+	// Pack low bytes of inputs to input_l
+	tmp = _mm512_set1_epi16(0x00ff);
+	v_0 = _mm512_and_si512(input_0, tmp);
+	v_1 = _mm512_and_si512(input_1, tmp);
+	input_l = _mm512_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm512_srli_epi16(input_0, 8);
+	v_1 = _mm512_srli_epi16(input_1, 8);
+	input_h = _mm512_packus_epi16(v_0, v_1);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm512_gf2p8affine_epi64_epi8(input_l, mtx_a_ll, 0);
+	v_0 = _mm512_xor_si512(v_0,
+		_mm512_gf2p8affine_epi64_epi8(input_h, mtx_a_lh, 0));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm512_gf2p8affine_epi64_epi8(input_l, mtx_a_hl, 0);
+	v_1 = _mm512_xor_si512(v_1,
+		_mm512_gf2p8affine_epi64_epi8(input_h, mtx_a_hh, 0));
+
+	// Unpack low bytes
+	output_l = _mm512_unpacklo_epi8(v_0, v_1);
+
+	// Unpack high bytes
+	output_h = _mm512_unpackhi_epi8(v_0, v_1);
+
+	// Save results
+	_mm512_storeu_si512((__m512i *)output, output_l);
+	_mm512_storeu_si512((__m512i *)(output + 64), output_h);
+}
+
+// Same as GF16affineSIMD512x2() but XOR results into output
+// (output ^= a * input) -- call every 128 bytes
+GF_TARGET("gfni,avx512f,avx512bw") static inline void
+GF16affineSIMD512x2Xor(const __m512i mtx_a_ll, const __m512i mtx_a_lh,
+		       const __m512i mtx_a_hl, const __m512i mtx_a_hh,
+		       const uint8_t *input, uint8_t *output)
+{
+	/*** Affine transformation (8x8 bit matrix * byte) with GFNI ***/
+	__m512i	v_0, v_1, input_0, input_1, input_l, input_h;
+	__m512i	output_l, output_h, tmp;
+
+	input_0 = _mm512_loadu_si512((__m512i *)input);
+	input_1 = _mm512_loadu_si512((__m512i *)(input + 64));
+
+	// Pack low bytes of inputs to input_l
+	tmp = _mm512_set1_epi16(0x00ff);
+	v_0 = _mm512_and_si512(input_0, tmp);
+	v_1 = _mm512_and_si512(input_1, tmp);
+	input_l = _mm512_packus_epi16(v_0, v_1);
+
+	// Pack high bytes of inputs to input_h
+	v_0 = _mm512_srli_epi16(input_0, 8);
+	v_1 = _mm512_srli_epi16(input_1, 8);
+	input_h = _mm512_packus_epi16(v_0, v_1);
+
+	// Get GF calc results for low bytes
+	v_0 = _mm512_gf2p8affine_epi64_epi8(input_l, mtx_a_ll, 0);
+	v_0 = _mm512_xor_si512(v_0,
+		_mm512_gf2p8affine_epi64_epi8(input_h, mtx_a_lh, 0));
+
+	// Get GF calc results for high bytes
+	v_1 = _mm512_gf2p8affine_epi64_epi8(input_l, mtx_a_hl, 0);
+	v_1 = _mm512_xor_si512(v_1,
+		_mm512_gf2p8affine_epi64_epi8(input_h, mtx_a_hh, 0));
+
+	// Unpack low bytes
+	output_l = _mm512_unpacklo_epi8(v_0, v_1);
+
+	// Unpack high bytes
+	output_h = _mm512_unpackhi_epi8(v_0, v_1);
+
+	// XOR results into output and save
+	output_l = _mm512_xor_si512(output_l, _mm512_loadu_si512((__m512i *)output));
+	output_h = _mm512_xor_si512(output_h,
+			_mm512_loadu_si512((__m512i *)(output + 64)));
+	_mm512_storeu_si512((__m512i *)output, output_l);
+	_mm512_storeu_si512((__m512i *)(output + 64), output_h);
+}
 #elif defined(_arm64_) // NEON
 // Get GF(2^16) result by lookup with NEON -- call every 32 bytes 
 static inline void
@@ -386,6 +1298,57 @@ GF16lkupSIMD128x2(const uint8x16_t tb_a_0_l, const uint8x16_t tb_a_0_h,
 	output_v.val[1] = v_1;
 	vst2q_u8(output, output_v);
 }
+
+// Same as GF16lkupSIMD128x2() but XOR results into output
+// (output ^= a * input) -- call every 32 bytes
+static inline void
+GF16lkupSIMD128x2Xor(const uint8x16_t tb_a_0_l, const uint8x16_t tb_a_0_h,
+		     const uint8x16_t tb_a_1_l, const uint8x16_t tb_a_1_h,
+		     const uint8x16_t tb_a_2_l, const uint8x16_t tb_a_2_h,
+		     const uint8x16_t tb_a_3_l, const uint8x16_t tb_a_3_h,
+		     const uint8_t *input, uint8_t *output)
+{
+	/*** 4bit table lookup region technique with NEON ***/
+	uint8x16x2_t	input_v, output_v;
+	uint8x16_t	input_l, input_h, v_0, v_1;
+	uint8x16_t	input_l_l, input_l_h, input_h_l, input_h_h, tmp;
+
+	// Load interleaved inputs and outputs
+	input_v = vld2q_u8(input);
+	input_l = input_v.val[0];
+	input_h = input_v.val[1];
+	output_v = vld2q_u8(output);
+
+	// Retrieve low 4bit of each byte from input_l
+	tmp = vdupq_n_u8(0x0f);
+	input_l_l = vandq_u8(input_l, tmp);
+
+	// Retrieve high 4bit of each byte from input_l
+	input_l_h = vshrq_n_u8(input_l, 4);
+
+	// Retrieve low 4bit of each byte from input_h
+	input_h_l = vandq_u8(input_h, tmp);
+
+	// Retrieve high 4bit of each byte from input_h
+	input_h_h = vshrq_n_u8(input_h, 4);
+
+	// Get GF calc results for low bytes
+	v_0 = vqtbl1q_u8(tb_a_0_l, input_l_l);
+	v_0 = veorq_u8(v_0, vqtbl1q_u8(tb_a_1_l, input_l_h));
+	v_0 = veorq_u8(v_0, vqtbl1q_u8(tb_a_2_l, input_h_l));
+	v_0 = veorq_u8(v_0, vqtbl1q_u8(tb_a_3_l, input_h_h));
+
+	// Get GF calc results for high bytes
+	v_1 = vqtbl1q_u8(tb_a_0_h, input_l_l);
+	v_1 = veorq_u8(v_1, vqtbl1q_u8(tb_a_1_h, input_l_h));
+	v_1 = veorq_u8(v_1, vqtbl1q_u8(tb_a_2_h, input_h_l));
+	v_1 = veorq_u8(v_1, vqtbl1q_u8(tb_a_3_h, input_h_h));
+
+	// XOR into outputs and save interleaved results
+	output_v.val[0] = veorq_u8(output_v.val[0], v_0);
+	output_v.val[1] = veorq_u8(output_v.val[1], v_1);
+	vst2q_u8(output, output_v);
+}
 #endif
 
 
@@ -393,6 +1356,29 @@ GF16lkupSIMD128x2(const uint8x16_t tb_a_0_l, const uint8x16_t tb_a_0_h,
 	Common
 ***************************************************************************/
 
+// SIMD instruction sets for GFsetSIMD()
+// GF8init() and GF16init() select the best one supported by CPU at run
+// time. Set environment variable GF_SIMD to "none", "ssse3", "avx2",
+// "avx512", "neon", "avx2-gfni" or "avx512-gfni" to pin one
+// (e.g. for A/B benchmarking).
+#define GF_SIMD_NONE	0	// No SIMD (table lookup only)
+#define GF_SIMD_SSSE3	1	// SSSE3 (128bit)
+#define GF_SIMD_AVX2	2	// AVX2 (256bit)
+#define GF_SIMD_AVX512	3	// AVX-512BW (512bit)
+#define GF_SIMD_NEON	4	// NEON (128bit)
+#define GF_SIMD_AVX2_GFNI	5	// AVX2 + GFNI (256bit)
+#define GF_SIMD_AVX512_GFNI	6	// AVX-512BW + GFNI (512bit)
+
+// Version of table file of GFsaveTbl() (changed with its format)
+#define GF_TBL_VERSION	2
+
+// Functions
+int		GFdetectSIMD(void);
+int		GFsetSIMD(int);
+int		GFgetSIMD(void);
+const char	*GFnameSIMD(int);
+int		GFsaveTbl(const char *);
+
 // Definitions 
 #if defined(__SSSE3__) || defined(__AVX2__)
 typedef __m128i		v128_t;
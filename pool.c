@@ -0,0 +1,1880 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2016, 2022
+ *      ASUSA Corporation.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the University nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/****************************************************************************
+
+	Thread pool for the region functions of gf.c (see pool.h).
+	The caller posts a job and takes chunks together with the
+	worker threads, then waits until the workers are done.
+
+****************************************************************************/
+
+#ifdef __linux__
+#define _GNU_SOURCE	// sched_setaffinity(), sched_getcpu()
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+#include "gf.h"
+#include "pool.h"
+
+/**************************************************************************
+	Jobs
+**************************************************************************/
+
+// Process len bytes of job from offset off
+// ptr: k + m pointers for dot and encode (NULL if inline)
+// node: NUMA node whose tables are used (NULL: default tables)
+static void
+GFpoolDo(const GFpoolJob *job, size_t off, size_t len, uint8_t **ptr,
+	 const GFpoolNode *node)
+{
+	int			i;
+	const uint8_t * const	*srcs = job->srcs;
+	uint8_t * const		*dsts = job->dsts;
+	const GF16ctx		*gf16 = node != NULL ? node->gf16 : NULL;
+	const GF8ctx		*gf8 = node != NULL ? node->gf8 : NULL;
+
+	// Inputs and outputs from offset
+	if (ptr != NULL && off > 0) {
+		for (i = 0; i < job->k; i++) {
+			ptr[i] = (uint8_t *)job->srcs[i] + off;
+		}
+		for (i = 0; i < job->m; i++) {
+			ptr[job->k + i] = job->dsts[i] + off;
+		}
+		srcs = (const uint8_t * const *)ptr;
+		dsts = ptr + job->k;
+	}
+
+	switch (job->op) {
+	case GF_POOL_MUL16:
+		if (gf16 != NULL) {
+			GF16mulRegionCtx(gf16, job->dst + off, job->src + off,
+					 len, job->a);
+		} else {
+			GF16mulRegion(job->dst + off, job->src + off, len,
+				      job->a);
+		}
+		break;
+
+	case GF_POOL_DIV16:
+		if (gf16 != NULL) {
+			GF16divRegionCtx(gf16, job->dst + off, job->src + off,
+					 len, job->a);
+		} else {
+			GF16divRegion(job->dst + off, job->src + off, len,
+				      job->a);
+		}
+		break;
+
+	case GF_POOL_MULADD16:
+		if (gf16 != NULL) {
+			GF16mulAddRegionCtx(gf16, job->dst + off,
+					    job->src + off, len, job->a);
+		} else {
+			GF16mulAddRegion(job->dst + off, job->src + off, len,
+					 job->a);
+		}
+		break;
+
+	case GF_POOL_DOT16:
+		if (gf16 != NULL) {
+			GF16dotRegionCtx(gf16, job->dst + off, srcs,
+				(const uint16_t *)job->coefs, job->k, len);
+		} else {
+			GF16dotRegion(job->dst + off, srcs,
+				(const uint16_t *)job->coefs, job->k, len);
+		}
+		break;
+
+	case GF_POOL_ENC16:
+		if (gf16 != NULL) {
+			GF16encodeRegionCtx(gf16, dsts, srcs,
+				(const uint16_t *)job->coefs, job->m, job->k,
+				len);
+		} else {
+			GF16encodeRegion(dsts, srcs,
+				(const uint16_t *)job->coefs, job->m, job->k,
+				len);
+		}
+		break;
+
+	case GF_POOL_MUL8:
+		if (gf8 != NULL) {
+			GF8mulRegionCtx(gf8, job->dst + off, job->src + off,
+					len, (uint8_t)job->a);
+		} else {
+			GF8mulRegion(job->dst + off, job->src + off, len,
+				     (uint8_t)job->a);
+		}
+		break;
+
+	case GF_POOL_DIV8:
+		if (gf8 != NULL) {
+			GF8divRegionCtx(gf8, job->dst + off, job->src + off,
+					len, (uint8_t)job->a);
+		} else {
+			GF8divRegion(job->dst + off, job->src + off, len,
+				     (uint8_t)job->a);
+		}
+		break;
+
+	case GF_POOL_MULADD8:
+		if (gf8 != NULL) {
+			GF8mulAddRegionCtx(gf8, job->dst + off, job->src + off,
+					   len, (uint8_t)job->a);
+		} else {
+			GF8mulAddRegion(job->dst + off, job->src + off, len,
+					(uint8_t)job->a);
+		}
+		break;
+
+	case GF_POOL_DOT8:
+		if (gf8 != NULL) {
+			GF8dotRegionCtx(gf8, job->dst + off, srcs,
+				(const uint8_t *)job->coefs, job->k, len);
+		} else {
+			GF8dotRegion(job->dst + off, srcs,
+				(const uint8_t *)job->coefs, job->k, len);
+		}
+		break;
+	}
+}
+
+// Process chunk i of job
+static inline void
+GFpoolDoChunk(const GFpoolJob *job, size_t i, uint8_t **ptr,
+	      const GFpoolNode *node)
+{
+	size_t	off = i * job->chunk;
+
+	GFpoolDo(job, off, job->len - off < job->chunk ?
+		 job->len - off : job->chunk, ptr, node);
+}
+
+// Result of GFpoolDequePop() and GFpoolDequeSteal()
+#define GF_POOL_EMPTY	SIZE_MAX	// Deque is empty
+#define GF_POOL_ABORT	(SIZE_MAX - 1)	// Lost race with another thread
+
+// Push task t to bottom of deque (owner only)
+static void
+GFpoolDequePush(GFpoolDeque *deq, size_t t)
+{
+	long	b;
+
+	b = atomic_load_explicit(&deq->bottom, memory_order_relaxed);
+	atomic_store_explicit(&deq->buf[b & deq->mask], t,
+			      memory_order_relaxed);
+	atomic_store_explicit(&deq->bottom, b + 1, memory_order_release);
+}
+
+// Pop task from bottom of deque (owner only)
+static size_t
+GFpoolDequePop(GFpoolDeque *deq)
+{
+	long	b, t;
+	size_t	x;
+
+	b = atomic_load_explicit(&deq->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&deq->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	t = atomic_load_explicit(&deq->top, memory_order_relaxed);
+	if (t > b) { // Empty
+		atomic_store_explicit(&deq->bottom, b + 1,
+				      memory_order_relaxed);
+		return GF_POOL_EMPTY;
+	}
+	x = atomic_load_explicit(&deq->buf[b & deq->mask],
+				 memory_order_relaxed);
+	if (t == b) { // Last one (race with thieves)
+		if (!atomic_compare_exchange_strong_explicit(&deq->top, &t,
+				t + 1, memory_order_seq_cst,
+				memory_order_relaxed)) {
+			x = GF_POOL_EMPTY;
+		}
+		atomic_store_explicit(&deq->bottom, b + 1,
+				      memory_order_relaxed);
+	}
+
+	return x;
+}
+
+// Steal task from top of deque (other threads)
+static size_t
+GFpoolDequeSteal(GFpoolDeque *deq)
+{
+	long	b, t;
+	size_t	x;
+
+	t = atomic_load_explicit(&deq->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	b = atomic_load_explicit(&deq->bottom, memory_order_acquire);
+	if (t >= b) {
+		return GF_POOL_EMPTY;
+	}
+	x = atomic_load_explicit(&deq->buf[t & deq->mask],
+				 memory_order_relaxed);
+	if (!atomic_compare_exchange_strong_explicit(&deq->top, &t, t + 1,
+			memory_order_seq_cst, memory_order_relaxed)) {
+		return GF_POOL_ABORT;
+	}
+
+	return x;
+}
+
+// Key of coefficient table of descriptor (UINT32_MAX if illegal)
+// Jobs of the same key share tables (mul and mulAdd of the same a).
+static uint32_t
+GFpoolKey(const GFpoolDesc *desc)
+{
+	if (desc->len > 0 && (desc->dst == NULL || desc->src == NULL)) {
+		return UINT32_MAX;
+	}
+
+	switch (desc->op) {
+	case GF_POOL_MUL16:
+	case GF_POOL_MULADD16:
+		return desc->a;
+	case GF_POOL_DIV16:
+		return desc->a == 0 ? UINT32_MAX : 1 << 16 | desc->a;
+	case GF_POOL_MUL8:
+	case GF_POOL_MULADD8:
+		return desc->a > 0xff ? UINT32_MAX : 2 << 16 | desc->a;
+	case GF_POOL_DIV8:
+		return desc->a == 0 || desc->a > 0xff ? UINT32_MAX :
+		       3 << 16 | desc->a;
+	}
+
+	return UINT32_MAX;
+}
+
+static void	GFpoolRingPutResv(GFpoolRing *, const GFpoolCmpl *);
+
+// Process task t of batch
+// tb and key are the 4bit tables of GF(2^16) of the thread and their key,
+// which are rebuilt only when the coefficient changes.
+static void
+GFpoolDoTask(const GFpoolJob *job, size_t t, uint8_t *tb, uint32_t *key,
+	     const GFpoolNode *node)
+{
+	const GFpoolTask	*task = &job->task[t];
+	const GFpoolDesc	*desc = &job->desc[task->desc];
+	uint8_t			*dst = desc->dst + task->off;
+	const uint8_t		*src = desc->src + task->off;
+	const GF8ctx		*gf8 = node != NULL ? node->gf8 : NULL;
+	GFpoolCmpl		cmpl;
+	uint32_t		k;
+
+	switch (desc->op) {
+	case GF_POOL_MUL16:
+	case GF_POOL_DIV16:
+	case GF_POOL_MULADD16:
+		if ((k = GFpoolKey(desc)) != *key) {
+			if (node != NULL && node->gf16 != NULL) {
+				GF16set4bitRegTblCtx(node->gf16, tb, desc->a,
+						     k >> 16);
+			} else {
+				GF16set4bitRegTbl(tb, desc->a, k >> 16);
+			}
+			*key = k;
+		}
+		if (desc->op == GF_POOL_MULADD16) {
+			GF16lkupRegionXor(tb, src, dst, task->len);
+		} else {
+			GF16lkupRegion(tb, src, dst, task->len);
+		}
+		break;
+
+	case GF_POOL_MUL8:
+		if (gf8 != NULL) {
+			GF8mulRegionCtx(gf8, dst, src, task->len,
+					(uint8_t)desc->a);
+		} else {
+			GF8mulRegion(dst, src, task->len, (uint8_t)desc->a);
+		}
+		break;
+
+	case GF_POOL_DIV8:
+		if (gf8 != NULL) {
+			GF8divRegionCtx(gf8, dst, src, task->len,
+					(uint8_t)desc->a);
+		} else {
+			GF8divRegion(dst, src, task->len, (uint8_t)desc->a);
+		}
+		break;
+
+	case GF_POOL_MULADD8:
+		if (gf8 != NULL) {
+			GF8mulAddRegionCtx(gf8, dst, src, task->len,
+					   (uint8_t)desc->a);
+		} else {
+			GF8mulAddRegion(dst, src, task->len, (uint8_t)desc->a);
+		}
+		break;
+	}
+
+	// Report job when its last task is done
+	if (atomic_fetch_sub_explicit(&job->left[task->desc], 1,
+				      memory_order_acq_rel) == 1 &&
+	    job->ring != NULL) {
+		cmpl.id = desc->id;
+		cmpl.err = 0;
+		GFpoolRingPutResv(job->ring, &cmpl);
+	}
+}
+
+// Process tasks of batch: first those of own deque from bottom, then
+// steal from top of others until all deques are empty
+static void
+GFpoolWorkBatch(GFpoolJob *job, int w, const GFpoolNode *node)
+{
+	_Alignas(64) uint8_t	tb[128];
+	uint32_t		key = UINT32_MAX;
+	size_t			t;
+	int			j, abort;
+
+	while ((t = GFpoolDequePop(&job->deq[w])) != GF_POOL_EMPTY) {
+		GFpoolDoTask(job, t, tb, &key, node);
+	}
+
+	// No task is pushed after start, so all are done if no steal
+	// is aborted in a round
+	do {
+		abort = 0;
+		for (j = 1; j < job->n_deq; j++) {
+			while ((t = GFpoolDequeSteal(&job->deq[(w + j) %
+					job->n_deq])) != GF_POOL_EMPTY) {
+				if (t == GF_POOL_ABORT) {
+					abort = 1;
+					break;
+				}
+				GFpoolDoTask(job, t, tb, &key, node);
+			}
+		}
+	} while (abort);
+}
+
+// Take chunks of job until none is left
+// w: index of thread, v: node index of thread (-1: not NUMA)
+// On NUMA, chunks of node v are taken first, then those of other nodes.
+static void
+GFpoolWork(GFpool *pool, GFpoolJob *job, int w, int v)
+{
+	int		j;
+	size_t		i;
+	uint8_t		**ptr;
+	GFpoolQue	*que;
+	const GFpoolNode *node = v >= 0 ? &pool->node[v] : NULL;
+
+	// Batch
+	if (job->op == GF_POOL_BATCH) {
+		GFpoolWorkBatch(job, w, node);
+		return;
+	}
+
+	ptr = job->ptr != NULL ? job->ptr + w * (job->k + job->m) : NULL;
+
+	// All chunks in one
+	if (job->que == NULL) {
+		for (;;) {
+			i = atomic_fetch_add_explicit(&job->next, 1,
+						      memory_order_relaxed);
+			if (i >= job->n_chunk) {
+				break;
+			}
+			GFpoolDoChunk(job, i, ptr, node);
+		}
+		return;
+	}
+
+	// Chunks per node
+	for (j = 0; j < job->n_que; j++) {
+		que = &job->que[(v + j) % job->n_que];
+		for (;;) {
+			i = atomic_fetch_add_explicit(&que->next, 1,
+						      memory_order_relaxed);
+			if (i >= que->n) {
+				break;
+			}
+			GFpoolDoChunk(job, que->idx[i], ptr, node);
+		}
+	}
+}
+
+// Get node index of the CPU the caller runs on (-1: not NUMA)
+static int
+GFpoolCurNode(const GFpool *pool)
+{
+#ifdef __linux__
+	int	cpu;
+
+	if (pool->n_node > 0) {
+		cpu = sched_getcpu();
+		return cpu >= 0 && cpu < pool->n_cpu_node &&
+		       pool->cpu_node[cpu] >= 0 ? pool->cpu_node[cpu] : 0;
+	}
+#endif
+	return -1;
+}
+
+// Sort chunks of job by the node where their pages are
+// Chunks of pages not yet touched are spread to all nodes.
+//
+// Args:
+//     idx: n_chunk indices
+//     que: n_node queues
+//     node: n_chunk ints (work space)
+//     page: n_chunk pointers (work space)
+//
+static void
+GFpoolSortChunk(const GFpool *pool, GFpoolJob *job, size_t *idx,
+		GFpoolQue *que, int *node, void **page)
+{
+	int		v;
+	size_t		i, n[GF_POOL_NODE_MAX];
+	const uint8_t	*p;
+	uintptr_t	mask = ~(uintptr_t)(sysconf(_SC_PAGESIZE) - 1);
+
+	// Region the chunks are placed by (input if any)
+	switch (job->op) {
+	case GF_POOL_DOT16:
+	case GF_POOL_ENC16:
+	case GF_POOL_DOT8:
+		p = job->k > 0 ? job->srcs[0] :
+		    job->op == GF_POOL_ENC16 ? job->dsts[0] : job->dst;
+		break;
+	default:
+		p = job->src;
+	}
+
+	// Node of the first page of each chunk
+	for (i = 0; i < job->n_chunk; i++) {
+		page[i] = (void *)((uintptr_t)(p + i * job->chunk) & mask);
+		node[i] = -1;
+	}
+#ifdef __linux__
+	if (syscall(SYS_move_pages, 0, (unsigned long)job->n_chunk, page,
+		    NULL, node, 0) < 0) {
+		for (i = 0; i < job->n_chunk; i++) {
+			node[i] = -1;
+		}
+	}
+#endif
+	for (i = 0; i < job->n_chunk; i++) {
+		v = node[i];
+		node[i] = v >= 0 && v < GF_POOL_NODE_MAX &&
+			  pool->node_idx[v] >= 0 ? pool->node_idx[v] :
+			  (int)(i % pool->n_node);
+	}
+
+	// Counting sort
+	memset(n, 0, sizeof(n));
+	for (i = 0; i < job->n_chunk; i++) {
+		n[node[i]]++;
+	}
+	for (v = 0; v < pool->n_node; v++) {
+		atomic_init(&que[v].next, 0);
+		que[v].idx = idx;
+		que[v].n = 0;
+		idx += n[v];
+	}
+	for (i = 0; i < job->n_chunk; i++) {
+		que[node[i]].idx[que[node[i]].n++] = i;
+	}
+	job->que = que;
+	job->n_que = pool->n_node;
+}
+
+// Post job to workers, work as thread 0 and wait for them
+static void
+GFpoolPost(GFpool *pool, GFpoolJob *job)
+{
+	// Post job (one job at a time)
+	pthread_mutex_lock(&pool->run);
+	pthread_mutex_lock(&pool->lock);
+	pool->job = job;
+	pool->gen++;
+	pool->busy = pool->n - 1;
+	pthread_cond_broadcast(&pool->cv_start);
+	pthread_mutex_unlock(&pool->lock);
+
+	// Work as well
+	GFpoolWork(pool, job, 0, GFpoolCurNode(pool));
+
+	// Wait for workers
+	pthread_mutex_lock(&pool->lock);
+	while (pool->busy > 0) {
+		pthread_cond_wait(&pool->cv_done, &pool->lock);
+	}
+	pool->job = NULL;
+	pthread_mutex_unlock(&pool->lock);
+	pthread_mutex_unlock(&pool->run);
+}
+
+// Run job by threads of pool and wait for it
+// Short regions are processed inline.
+static void
+GFpoolRun(GFpool *pool, GFpoolJob *job)
+{
+	size_t		n_ptr, size, *idx;
+	uint8_t		*buf;
+	void		**page;
+	GFpoolQue	*que;
+
+	// Inline
+	if (pool == NULL || pool->n <= 1 || job->len < pool->min) {
+		GFpoolDo(job, 0, job->len, NULL, NULL);
+		return;
+	}
+
+	// Split into chunks
+	job->chunk = pool->chunk;
+	job->n_chunk = (job->len + job->chunk - 1) / job->chunk;
+	atomic_init(&job->next, 0);
+	job->ptr = NULL;
+	job->que = NULL;
+
+	// Work space for pointers (dot, encode) and sort (NUMA)
+	n_ptr = job->op == GF_POOL_DOT16 || job->op == GF_POOL_ENC16 ||
+		job->op == GF_POOL_DOT8 ? pool->n * (job->k + job->m) : 0;
+	size = sizeof(uint8_t *) * n_ptr;
+	if (pool->n_node > 1) {
+		size += sizeof(GFpoolQue) * pool->n_node +
+			(sizeof(size_t) + sizeof(void *) + sizeof(int)) *
+			job->n_chunk;
+	}
+	buf = NULL;
+	if (size > 0) {
+		if ((buf = (uint8_t *)malloc(size)) == NULL) {
+			fprintf(stderr, "Error: %s: malloc: %s\n",
+				__func__, strerror(errno));
+			GFpoolDo(job, 0, job->len, NULL, NULL);
+			return;
+		}
+		if (n_ptr > 0) {
+			job->ptr = (uint8_t **)buf;
+		}
+		if (pool->n_node > 1) { // Queues, indices, pages and nodes
+			que = (GFpoolQue *)(buf + sizeof(uint8_t *) * n_ptr);
+			idx = (size_t *)(que + pool->n_node);
+			page = (void **)(idx + job->n_chunk);
+			GFpoolSortChunk(pool, job, idx, que,
+					(int *)(page + job->n_chunk), page);
+		}
+	}
+
+	GFpoolPost(pool, job);
+
+	free(buf);
+}
+
+/**************************************************************************
+	NUMA
+**************************************************************************/
+
+#ifdef __linux__
+// Pin the calling thread to CPUs of node
+static int
+GFpoolPin(const GFpoolNode *node)
+{
+	int		i;
+	cpu_set_t	set;
+
+	CPU_ZERO(&set);
+	for (i = 0; i < node->n_cpu; i++) {
+		if (node->cpu[i] < CPU_SETSIZE) {
+			CPU_SET(node->cpu[i], &set);
+		}
+	}
+	if (sched_setaffinity(0, sizeof(set), &set) < 0) {
+		fprintf(stderr, "Error: %s: sched_setaffinity: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+// Parse CPU list of sysfs such as "0-3,8-11"
+//
+// Return value:
+//     # of CPUs set to cpu (max GF_POOL_CPU_MAX)
+//
+static int
+GFpoolParseCpus(const char *s, int *cpu)
+{
+	int	n = 0, c, first, last;
+	char	*e;
+
+	while (*s != '\0' && *s != '\n') {
+		first = last = (int)strtol(s, &e, 10);
+		if (e == s) {
+			break;
+		}
+		if (*e == '-') {
+			s = e + 1;
+			last = (int)strtol(s, &e, 10);
+		}
+		for (c = first; c <= last && n < GF_POOL_CPU_MAX; c++) {
+			if (c >= 0 && c < GF_POOL_CPU_MAX) {
+				cpu[n++] = c;
+			}
+		}
+		s = *e == ',' ? e + 1 : e;
+	}
+
+	return n;
+}
+
+// Read NUMA nodes from GF_POOL_NODE_DIR, assign them to threads and copy
+// tables of fields to each node
+//
+// Return value:
+//     0 or -1 if failed (not NUMA if pool->n_node is 0)
+//
+static int
+GFpoolInitNodes(GFpool *pool)
+{
+	int		id, i, n, v, *cpu;
+	char		path[256], buf[4096];
+	FILE		*fp;
+	GFpoolNode	*node;
+	cpu_set_t	set;
+
+	// Read CPUs of nodes (memory-only nodes are skipped)
+	if ((cpu = (int *)malloc(sizeof(int) * GF_POOL_CPU_MAX)) == NULL ||
+	    (pool->node = (GFpoolNode *)calloc(GF_POOL_NODE_MAX,
+					       sizeof(GFpoolNode))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		free(cpu);
+		return -1;
+	}
+	for (id = 0; id < GF_POOL_NODE_MAX; id++) {
+		snprintf(path, sizeof(path), "%s/node%d/cpulist",
+			 GF_POOL_NODE_DIR, id);
+		if ((fp = fopen(path, "r")) == NULL) {
+			continue;
+		}
+		n = fgets(buf, sizeof(buf), fp) != NULL ?
+		    GFpoolParseCpus(buf, cpu) : 0;
+		fclose(fp);
+		if (n == 0) {
+			continue;
+		}
+		node = &pool->node[pool->n_node];
+		if ((node->cpu = (int *)malloc(sizeof(int) * n)) == NULL) {
+			fprintf(stderr, "Error: %s: malloc: %s\n",
+				__func__, strerror(errno));
+			free(cpu);
+			return -1;
+		}
+		memcpy(node->cpu, cpu, sizeof(int) * n);
+		node->n_cpu = n;
+		node->id = id;
+		pool->node_idx[id] = pool->n_node++;
+		for (i = 0; i < n; i++) {
+			if (cpu[i] >= pool->n_cpu_node) {
+				pool->n_cpu_node = cpu[i] + 1;
+			}
+		}
+	}
+	free(cpu);
+	if (pool->n_node == 0) { // Not NUMA
+		return 0;
+	}
+
+	// CPU to node, and node of each thread (0: caller, not pinned)
+	if ((pool->cpu_node = (int *)malloc(sizeof(int) *
+					    pool->n_cpu_node)) == NULL ||
+	    (pool->w_node = (int *)malloc(sizeof(int) * pool->n)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	for (i = 0; i < pool->n_cpu_node; i++) {
+		pool->cpu_node[i] = -1;
+	}
+	for (v = 0; v < pool->n_node; v++) {
+		for (i = 0; i < pool->node[v].n_cpu; i++) {
+			pool->cpu_node[pool->node[v].cpu[i]] = v;
+		}
+	}
+	for (i = 0; i < pool->n; i++) {
+		pool->w_node[i] = i % pool->n_node;
+	}
+
+	// Copy tables while running on each node, so the pages of the
+	// copies are on the node (first touch)
+	if (sched_getaffinity(0, sizeof(set), &set) < 0) {
+		fprintf(stderr, "Error: %s: sched_getaffinity: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	for (v = 0; v < pool->n_node; v++) {
+		node = &pool->node[v];
+		if (GFpoolPin(node) < 0 ||
+		    (GF16memL != NULL &&
+		     (node->gf16 = GF16dupCtx(NULL)) == NULL) ||
+		    (GF8memMul != NULL &&
+		     (node->gf8 = GF8dupCtx(NULL)) == NULL)) {
+			sched_setaffinity(0, sizeof(set), &set);
+			return -1;
+		}
+	}
+	sched_setaffinity(0, sizeof(set), &set);
+
+	return 0;
+}
+#endif
+
+// Free NUMA nodes of pool
+static void
+GFpoolFreeNodes(GFpool *pool)
+{
+	int	v;
+
+	if (pool->node == NULL) {
+		return;
+	}
+	for (v = 0; v < GF_POOL_NODE_MAX; v++) {
+		free(pool->node[v].cpu);
+		GF16freeCtx(pool->node[v].gf16);
+		GF8freeCtx(pool->node[v].gf8);
+	}
+	free(pool->node);
+	free(pool->w_node);
+	free(pool->cpu_node);
+}
+
+/**************************************************************************
+	Pool
+**************************************************************************/
+
+static void	GFpoolBatchFree(GFpoolJob *);
+
+// Worker thread
+static void *
+GFpoolThread(void *arg)
+{
+	GFpool		*pool = (GFpool *)arg;
+	GFpoolJob	*job;
+	uint64_t	gen = 0; // Jobs posted before start are taken, too
+	int		w, v;
+
+	pthread_mutex_lock(&pool->lock);
+	w = ++pool->n_tid; // Index of thread (0 is caller)
+	pthread_mutex_unlock(&pool->lock);
+
+	// Pin to node
+	v = -1;
+#ifdef __linux__
+	if (pool->n_node > 0) {
+		v = pool->w_node[w];
+		GFpoolPin(&pool->node[v]);
+	}
+#endif
+
+	pthread_mutex_lock(&pool->lock);
+	for (;;) {
+		// Wait for job
+		while (pool->gen == gen && pool->aq_head == NULL &&
+		       !pool->quit) {
+			pthread_cond_wait(&pool->cv_start, &pool->lock);
+		}
+
+		// Job of caller first (it is waiting)
+		if (pool->gen != gen) {
+			gen = pool->gen;
+			job = pool->job;
+			pthread_mutex_unlock(&pool->lock);
+
+			GFpoolWork(pool, job, w, v);
+
+			// Done
+			pthread_mutex_lock(&pool->lock);
+			if (--pool->busy == 0) {
+				pthread_cond_signal(&pool->cv_done);
+			}
+			continue;
+		}
+
+		// Submitted batch (quit after all are done)
+		if ((job = pool->aq_head) == NULL) {
+			break;
+		}
+		job->n_ref++;
+		pthread_mutex_unlock(&pool->lock);
+
+		GFpoolWorkBatch(job, w - 1, v >= 0 ? &pool->node[v] : NULL);
+
+		// No task is left in deques, so nobody joins any more. The
+		// last one to leave frees it.
+		pthread_mutex_lock(&pool->lock);
+		if (pool->aq_head == job) {
+			if ((pool->aq_head = job->aq_next) == NULL) {
+				pool->aq_tail = NULL;
+			}
+		}
+		if (--job->n_ref == 0) {
+			GFpoolBatchFree(job);
+			free(job);
+		}
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+// Create pool of n threads (NUMA if numa is 1)
+static GFpool *
+GFpoolCrtInt(int n, int numa)
+{
+	int	i, err;
+	GFpool	*pool;
+
+	// # of threads
+	if (n <= 0) {
+		n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (n < 1) {
+		n = 1;
+	}
+	if (n > GF_POOL_MAX) {
+		fprintf(stderr, "Error: %s: Too many threads: %d (max %d)\n",
+			__func__, n, GF_POOL_MAX);
+		return NULL;
+	}
+
+	// Allocate pool and threads at once
+	if ((pool = (GFpool *)malloc(sizeof(GFpool) +
+				     sizeof(pthread_t) * n)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	memset(pool, 0, sizeof(GFpool));
+	pool->n = n;
+	pool->chunk = GF_POOL_CHUNK;
+	pool->min = GF_POOL_MIN;
+	pool->tid = (pthread_t *)(pool + 1);
+	for (i = 0; i < GF_POOL_NODE_MAX; i++) {
+		pool->node_idx[i] = -1;
+	}
+	pthread_mutex_init(&pool->run, NULL);
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->cv_start, NULL);
+	pthread_cond_init(&pool->cv_done, NULL);
+
+	// NUMA nodes
+#ifdef __linux__
+	if (numa && GFpoolInitNodes(pool) < 0) {
+		pool->n = 1; // No workers to join
+		GFpoolFree(pool);
+		return NULL;
+	}
+#endif
+
+	// Start workers
+	for (i = 0; i < n - 1; i++) {
+		if ((err = pthread_create(&pool->tid[i], NULL, GFpoolThread,
+					  pool)) != 0) {
+			fprintf(stderr, "Error: %s: pthread_create: %s\n",
+				__func__, strerror(err));
+			pool->n = i + 1; // Only started ones are joined
+			GFpoolFree(pool);
+			return NULL;
+		}
+	}
+
+	return pool;
+}
+
+// Create thread pool of n threads including the caller (n - 1 workers)
+// The workers sleep until a job is posted.
+//
+// Args:
+//     n: # of threads (0: # of online CPUs)
+//
+// Return value:
+//     pointer to pool or NULL if failed. Free it by GFpoolFree().
+//
+// Usage:
+//     GFpool *pool = GFpoolCrt(0);
+//     GF16mulAddRegionPool(pool, (uint8_t *)y, (uint8_t *)x, len, a);
+//     GFpoolFree(pool);
+//
+GFpool *
+GFpoolCrt(int n)
+{
+	return GFpoolCrtInt(n, 0);
+}
+
+// Same as GFpoolCrt() but for NUMA systems (Linux only)
+// Workers are pinned to the CPUs of nodes in turn and each node has its
+// own copy of the tables of GF16init() and GF8init(), so call them first.
+// Chunks are sorted by the node of their pages (input region) and the
+// threads of the node take them first. Chunk tables (4bit tables) are
+// built on the stack of each thread, so they are always local. Allocate
+// stripes on nodes by GFpoolAllocNode(). On other systems or if no node
+// is found, this is the same as GFpoolCrt().
+//
+GFpool *
+GFpoolCrtNuma(int n)
+{
+	return GFpoolCrtInt(n, 1);
+}
+
+// Stop threads and free pool created by GFpoolCrt()
+void
+GFpoolFree(GFpool *pool)
+{
+	int	i;
+
+	if (pool == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = 1;
+	pthread_cond_broadcast(&pool->cv_start);
+	pthread_mutex_unlock(&pool->lock);
+	for (i = 0; i < pool->n - 1; i++) {
+		pthread_join(pool->tid[i], NULL);
+	}
+
+	GFpoolFreeNodes(pool);
+	pthread_mutex_destroy(&pool->run);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->cv_start);
+	pthread_cond_destroy(&pool->cv_done);
+	free(pool);
+}
+
+// Get # of threads of pool including the caller
+int
+GFpoolGetThreads(const GFpool *pool)
+{
+	return pool->n;
+}
+
+// Get # of NUMA nodes of pool (0: not NUMA)
+int
+GFpoolGetNodes(const GFpool *pool)
+{
+	return pool->n_node;
+}
+
+// Allocate memory of len bytes on NUMA node of pool
+// Pages are bound to the node when touched (mbind()). Without NUMA
+// (or node < 0), it is plain anonymous memory.
+//
+// Args:
+//     node: node index of pool (0 - GFpoolGetNodes() - 1)
+//
+// Return value:
+//     pointer aligned to page or NULL if failed. Free it by
+//     GFpoolFreeNode() with the same len.
+//
+void *
+GFpoolAllocNode(const GFpool *pool, size_t len, int node)
+{
+	void		*p;
+#ifdef __linux__
+	unsigned long	mask[GF_POOL_NODE_MAX / (sizeof(long) * 8)];
+	int		id;
+#endif
+
+	if ((p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED) {
+		fprintf(stderr, "Error: %s: mmap: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+
+#ifdef __linux__
+	if (pool != NULL && node >= 0 && node < pool->n_node) {
+		id = pool->node[node].id;
+		memset(mask, 0, sizeof(mask));
+		mask[id / (sizeof(long) * 8)] = 1UL << (id % (sizeof(long) * 8));
+		if (syscall(SYS_mbind, p, len, MPOL_BIND, mask,
+			    GF_POOL_NODE_MAX + 1, 0) < 0 && errno != ENOSYS) {
+			fprintf(stderr, "Error: %s: mbind: %s\n",
+				__func__, strerror(errno));
+		}
+	}
+#endif
+
+	return p;
+}
+
+// Free memory allocated by GFpoolAllocNode()
+void
+GFpoolFreeNode(void *p, size_t len)
+{
+	if (p != NULL) {
+		munmap(p, len);
+	}
+}
+
+// Set bytes per chunk and min bytes of region to use threads
+// chunk is rounded up to a multiple of 64 bytes, so chunks of GF(2^16)
+// regions never split a word and keep alignment of SIMD stores.
+//
+// Args:
+//     chunk: bytes per chunk (0: GF_POOL_CHUNK)
+//     min: regions shorter than this are processed inline by caller
+//
+void
+GFpoolSetChunk(GFpool *pool, size_t chunk, size_t min)
+{
+	if (chunk == 0) {
+		chunk = GF_POOL_CHUNK;
+	}
+	pthread_mutex_lock(&pool->run);
+	pool->chunk = (chunk + 63) & ~(size_t)63;
+	pool->min = min;
+	pthread_mutex_unlock(&pool->run);
+}
+
+/**************************************************************************
+	16bit: GF(2^16)
+**************************************************************************/
+
+// Same as GF16mulRegion() but by threads of pool
+void
+GF16mulRegionPool(GFpool *pool, uint8_t *dst, const uint8_t *src,
+		  size_t len, uint16_t a)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_MUL16;
+	job.dst = dst;
+	job.src = src;
+	job.a = a;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+// Same as GF16divRegion() but by threads of pool
+void
+GF16divRegionPool(GFpool *pool, uint8_t *dst, const uint8_t *src,
+		  size_t len, uint16_t a)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_DIV16;
+	job.dst = dst;
+	job.src = src;
+	job.a = a;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+// Same as GF16mulAddRegion() but by threads of pool
+void
+GF16mulAddRegionPool(GFpool *pool, uint8_t *dst, const uint8_t *src,
+		     size_t len, uint16_t a)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_MULADD16;
+	job.dst = dst;
+	job.src = src;
+	job.a = a;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+// Same as GF16dotRegion() but by threads of pool
+void
+GF16dotRegionPool(GFpool *pool, uint8_t *dst, const uint8_t * const *srcs,
+		  const uint16_t *coefs, int k, size_t len)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_DOT16;
+	job.dst = dst;
+	job.srcs = srcs;
+	job.coefs = coefs;
+	job.k = k > 0 ? k : 0;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+// Same as GF16encodeRegion() but by threads of pool
+void
+GF16encodeRegionPool(GFpool *pool, uint8_t * const *parity,
+		     const uint8_t * const *data, const uint16_t *matrix,
+		     int m, int k, size_t len)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_ENC16;
+	job.dsts = parity;
+	job.srcs = data;
+	job.coefs = matrix;
+	job.m = m > 0 ? m : 0;
+	job.k = k > 0 ? k : 0;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+/**************************************************************************
+	8bit: GF(2^8)
+**************************************************************************/
+
+// Same as GF8mulRegion() but by threads of pool
+void
+GF8mulRegionPool(GFpool *pool, uint8_t *dst, const uint8_t *src,
+		 size_t len, uint8_t a)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_MUL8;
+	job.dst = dst;
+	job.src = src;
+	job.a = a;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+// Same as GF8divRegion() but by threads of pool
+void
+GF8divRegionPool(GFpool *pool, uint8_t *dst, const uint8_t *src,
+		 size_t len, uint8_t a)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_DIV8;
+	job.dst = dst;
+	job.src = src;
+	job.a = a;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+// Same as GF8mulAddRegion() but by threads of pool
+void
+GF8mulAddRegionPool(GFpool *pool, uint8_t *dst, const uint8_t *src,
+		    size_t len, uint8_t a)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_MULADD8;
+	job.dst = dst;
+	job.src = src;
+	job.a = a;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+// Same as GF8dotRegion() but by threads of pool
+void
+GF8dotRegionPool(GFpool *pool, uint8_t *dst, const uint8_t * const *srcs,
+		 const uint8_t *coefs, int k, size_t len)
+{
+	GFpoolJob	job;
+
+	memset(&job, 0, sizeof(job));
+	job.op = GF_POOL_DOT8;
+	job.dst = dst;
+	job.srcs = srcs;
+	job.coefs = coefs;
+	job.k = k > 0 ? k : 0;
+	job.len = len;
+	GFpoolRun(pool, &job);
+}
+
+/**************************************************************************
+	Batch
+**************************************************************************/
+
+// Create completion ring of n slots (rounded up to a power of 2)
+// Any threads may put and get completions without locks.
+//
+// Return value:
+//     pointer to ring or NULL if failed. Free it by GFpoolRingFree().
+//
+GFpoolRing *
+GFpoolRingCrt(size_t n)
+{
+	size_t		i, size;
+	GFpoolRing	*ring;
+
+	for (size = 1; size < n; size <<= 1) {
+		if (size > SIZE_MAX / 2 / sizeof(GFpoolSlot)) {
+			fprintf(stderr, "Error: %s: Too many slots: %zu\n",
+				__func__, n);
+			return NULL;
+		}
+	}
+
+	if ((ring = (GFpoolRing *)aligned_alloc(64,
+					sizeof(GFpoolRing))) == NULL ||
+	    (ring->slot = (GFpoolSlot *)malloc(sizeof(GFpoolSlot) *
+					       size)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		free(ring);
+		return NULL;
+	}
+	for (i = 0; i < size; i++) {
+		atomic_init(&ring->slot[i].seq, i);
+	}
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+	atomic_init(&ring->armed, 1);
+	atomic_init(&ring->resv, 0);
+	ring->mask = size - 1;
+
+	// Descriptor readable when completions are put
+#ifdef __linux__
+	if ((ring->fd[0] = ring->fd[1] = eventfd(0,
+				EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+		fprintf(stderr, "Error: %s: eventfd: %s\n",
+			__func__, strerror(errno));
+#else
+	if (pipe(ring->fd) < 0 ||
+	    fcntl(ring->fd[0], F_SETFL, O_NONBLOCK) < 0 ||
+	    fcntl(ring->fd[1], F_SETFL, O_NONBLOCK) < 0) {
+		fprintf(stderr, "Error: %s: pipe: %s\n",
+			__func__, strerror(errno));
+#endif
+		free(ring->slot);
+		free(ring);
+		return NULL;
+	}
+
+	return ring;
+}
+
+// Free completion ring created by GFpoolRingCrt()
+// A worker may still be notifying ring after its last completion was got,
+// so wait until all slots kept for batches are given back.
+void
+GFpoolRingFree(GFpoolRing *ring)
+{
+	if (ring == NULL) {
+		return;
+	}
+	while (atomic_load_explicit(&ring->resv, memory_order_acquire) > 0) {
+		sched_yield();
+	}
+	close(ring->fd[0]);
+	if (ring->fd[1] != ring->fd[0]) {
+		close(ring->fd[1]);
+	}
+	free(ring->slot);
+	free(ring);
+}
+
+// Get descriptor of ring, which is readable when completions are put
+// Add it to epoll etc. and get completions by GFpoolPoll().
+int
+GFpoolRingGetFd(const GFpoolRing *ring)
+{
+	return ring->fd[0];
+}
+
+// Make descriptor of ring readable
+static void
+GFpoolRingNotify(GFpoolRing *ring)
+{
+	uint64_t	one = 1;
+	ssize_t		n;
+
+#ifdef __linux__
+	n = write(ring->fd[1], &one, sizeof(one));
+#else
+	n = write(ring->fd[1], &one, 1);
+#endif
+	if (n < 0 && errno != EAGAIN) { // EAGAIN: already readable
+		fprintf(stderr, "Error: %s: write: %s\n",
+			__func__, strerror(errno));
+	}
+}
+
+// Put completion to slot of ring and make its descriptor readable
+// Slots kept for batches are not checked (see GFpoolRingPut()).
+//
+// Return value:
+//     0 or -1 if ring is full
+//
+static int
+GFpoolRingPush(GFpoolRing *ring, const GFpoolCmpl *cmpl)
+{
+	size_t		pos, seq;
+	GFpoolSlot	*slot;
+
+	pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	for (;;) {
+		slot = &ring->slot[pos & ring->mask];
+		seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+		if (seq == pos) { // Free slot
+			if (atomic_compare_exchange_weak_explicit(&ring->head,
+					&pos, pos + 1, memory_order_relaxed,
+					memory_order_relaxed)) {
+				break;
+			}
+		} else if ((intptr_t)(seq - pos) < 0) { // Full
+			return -1;
+		} else { // Taken by another thread
+			pos = atomic_load_explicit(&ring->head,
+						   memory_order_relaxed);
+		}
+	}
+	slot->cmpl = *cmpl;
+	atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+	// Wake consumer if it is waiting (armed by GFpoolPoll())
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_exchange_explicit(&ring->armed, 0, memory_order_relaxed)) {
+		GFpoolRingNotify(ring);
+	}
+
+	return 0;
+}
+
+// Get completion from ring
+//
+// Return value:
+//     1 or 0 if ring is empty
+//
+int
+GFpoolRingGet(GFpoolRing *ring, GFpoolCmpl *cmpl)
+{
+	size_t		pos, seq;
+	GFpoolSlot	*slot;
+
+	pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	for (;;) {
+		slot = &ring->slot[pos & ring->mask];
+		seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+		if (seq == pos + 1) { // Filled slot
+			if (atomic_compare_exchange_weak_explicit(&ring->tail,
+					&pos, pos + 1, memory_order_relaxed,
+					memory_order_relaxed)) {
+				break;
+			}
+		} else if ((intptr_t)(seq - (pos + 1)) < 0) { // Empty
+			return 0;
+		} else { // Taken by another thread
+			pos = atomic_load_explicit(&ring->tail,
+						   memory_order_relaxed);
+		}
+	}
+	*cmpl = slot->cmpl;
+	atomic_store_explicit(&slot->seq, pos + ring->mask + 1,
+			      memory_order_release);
+
+	return 1;
+}
+
+// # of free slots of ring
+// tail is loaded first, so the result may be smaller than the real one
+// while other threads get and put completions but never larger. head may
+// pass tail by more than the size of ring between the loads; then 0.
+static size_t
+GFpoolRingSpace(GFpoolRing *ring)
+{
+	size_t	tail, head;
+
+	tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+	head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	if (head - tail > ring->mask + 1) {
+		return 0;
+	}
+
+	return ring->mask + 1 - (head - tail);
+}
+
+// Keep n slots of ring for completions of batch, so they are never full
+// while the batch runs
+//
+// Return value:
+//     0 or -1 if ring has less than n slots neither used nor kept
+//
+static int
+GFpoolRingReserve(GFpoolRing *ring, size_t n)
+{
+	size_t	resv, space;
+
+	resv = atomic_load_explicit(&ring->resv, memory_order_relaxed);
+	do {
+		space = GFpoolRingSpace(ring);
+		space = space > resv ? space - resv : 0;
+		if (n > space) {
+			return -1;
+		}
+	} while (!atomic_compare_exchange_weak_explicit(&ring->resv, &resv,
+			resv + n, memory_order_relaxed, memory_order_relaxed));
+
+	return 0;
+}
+
+// Put completion of batch to slot kept by GFpoolRingReserve()
+// The slot may look full only while another thread is getting it.
+// Giving back the slot is the last access to ring, so GFpoolRingFree()
+// can free it after that.
+static void
+GFpoolRingPutResv(GFpoolRing *ring, const GFpoolCmpl *cmpl)
+{
+	while (GFpoolRingPush(ring, cmpl) < 0) {
+		sched_yield();
+	}
+	atomic_fetch_sub_explicit(&ring->resv, 1, memory_order_release);
+}
+
+// Put completion to ring and make its descriptor readable
+// Slots kept for running batches (GFpoolBatch(), GFpoolSubmit()) are not
+// used, so completions of the caller can share ring with batches.
+//
+// Return value:
+//     0 or -1 if ring is full
+//
+int
+GFpoolRingPut(GFpoolRing *ring, const GFpoolCmpl *cmpl)
+{
+	if (GFpoolRingReserve(ring, 1) < 0) {
+		return -1;
+	}
+	GFpoolRingPutResv(ring, cmpl);
+
+	return 0;
+}
+
+// Key and index of descriptor to sort batch
+typedef struct {
+	uint32_t	key;
+	size_t		i;
+} GFpoolSort;
+
+// Compare keys (and indices to keep order of jobs of the same key)
+static int
+GFpoolCmpSort(const void *p, const void *q)
+{
+	const GFpoolSort	*a = (const GFpoolSort *)p;
+	const GFpoolSort	*b = (const GFpoolSort *)q;
+
+	if (a->key != b->key) {
+		return a->key < b->key ? -1 : 1;
+	}
+	return a->i < b->i ? -1 : a->i > b->i;
+}
+
+// Free batch job prepared by GFpoolBatchInit()
+static void
+GFpoolBatchFree(GFpoolJob *job)
+{
+	if (job->deq != NULL) {
+		free(job->deq[0].buf);
+	}
+	free(job->deq);
+	free(job->task);
+	free(job->left);
+}
+
+// Prepare batch job of n jobs for nt threads (0: by size of batch)
+// Jobs are sorted by coefficient and split into tasks, which are dealt
+// to the deques of threads. Illegal jobs are put to ring at once.
+// n slots of ring must be kept by GFpoolRingReserve(); those not used are
+// given back if failed.
+//
+// Return value:
+//     0 or -1 if failed
+//
+static int
+GFpoolBatchInit(GFpool *pool, GFpoolJob *job, const GFpoolDesc *desc,
+		size_t n, GFpoolRing *ring, int nt)
+{
+	int		w;
+	size_t		i, j, n_task, n_job, total, chunk, cap, first, last;
+	size_t		n_rep = 0;
+	GFpoolSort	*sort = NULL;
+	GFpoolCmpl	cmpl;
+	const GFpoolDesc *d;
+
+	memset(job, 0, sizeof(GFpoolJob));
+	job->op = GF_POOL_BATCH;
+	job->desc = desc;
+	job->ring = ring;
+
+	// Sort jobs by coefficient and count tasks
+	if ((sort = (GFpoolSort *)malloc(sizeof(GFpoolSort) *
+					 (n + 1))) == NULL ||
+	    (job->left = (atomic_uint *)malloc(sizeof(atomic_uint) *
+					       (n + 1))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		goto err;
+	}
+	for (i = 0; i < n; i++) {
+		sort[i].key = GFpoolKey(&desc[i]);
+		sort[i].i = i;
+	}
+	qsort(sort, n, sizeof(GFpoolSort), GFpoolCmpSort);
+	chunk = pool != NULL ? pool->chunk : GF_POOL_CHUNK;
+	n_task = n_job = total = 0;
+	for (i = 0; i < n; i++) {
+		d = &desc[sort[i].i];
+		if (sort[i].key == UINT32_MAX) { // Illegal (sorted last)
+			break;
+		}
+		j = d->len > chunk ? (d->len + chunk - 1) / chunk : 1;
+		atomic_init(&job->left[sort[i].i], (unsigned int)j);
+		n_task += j;
+		total += d->len;
+		n_job++;
+	}
+
+	// Report illegal jobs
+	for (i = n_job; i < n; i++) {
+		fprintf(stderr, "Error: %s: Illegal job: %zu (op %d)\n",
+			__func__, sort[i].i, desc[sort[i].i].op);
+		if (ring != NULL) {
+			cmpl.id = desc[sort[i].i].id;
+			cmpl.err = -1;
+			GFpoolRingPutResv(ring, &cmpl);
+			n_rep++;
+		}
+	}
+
+	// Threads (inline if short)
+	if (nt <= 0) {
+		nt = pool == NULL || total < pool->min ? 1 : pool->n;
+	}
+	for (cap = 1; cap < (n_task + nt - 1) / nt; cap <<= 1);
+	job->n_deq = nt;
+	if ((job->task = (GFpoolTask *)malloc(sizeof(GFpoolTask) *
+					      (n_task + 1))) == NULL ||
+	    (job->deq = (GFpoolDeque *)aligned_alloc(64,
+				sizeof(GFpoolDeque) * nt)) == NULL ||
+	    (job->deq[0].buf = (atomic_size_t *)malloc(
+				sizeof(atomic_size_t) * cap * nt)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		goto err;
+	}
+
+	// Split jobs into tasks in sorted order
+	for (i = j = 0; i < n_job; i++) {
+		d = &desc[sort[i].i];
+		first = 0;
+		do {
+			job->task[j].desc = sort[i].i;
+			job->task[j].off = first;
+			job->task[j].len = d->len - first < chunk ?
+					   d->len - first : chunk;
+			first += chunk;
+			j++;
+		} while (first < d->len);
+	}
+
+	// Deal runs of tasks to threads (pushed backward, so the owner pops
+	// them forward and thieves steal from the other end)
+	for (w = 0; w < nt; w++) {
+		atomic_init(&job->deq[w].top, 0);
+		atomic_init(&job->deq[w].bottom, 0);
+		job->deq[w].mask = cap - 1;
+		job->deq[w].buf = job->deq[0].buf + cap * w;
+		first = n_task * w / nt;
+		last = n_task * (w + 1) / nt;
+		for (i = last; i > first; i--) {
+			GFpoolDequePush(&job->deq[w], i - 1);
+		}
+	}
+
+	free(sort);
+
+	return 0;
+
+err:
+	free(sort);
+	GFpoolBatchFree(job);
+	if (ring != NULL) {
+		atomic_fetch_sub_explicit(&ring->resv, n - n_rep,
+					  memory_order_relaxed);
+	}
+
+	return -1;
+}
+
+// Run batch of n independent jobs by threads of pool
+// Jobs are sorted by coefficient, so a thread builds 4bit tables once for
+// a run of jobs of the same coefficient. Jobs longer than the chunk size
+// of pool are split into chunks. The chunks are dealt to a deque of every
+// thread in that order and idle threads steal from the other end of the
+// deques of others, so threads are kept busy with jobs of mixed sizes.
+// The end of every job is put to ring (if not NULL) as soon as its last
+// chunk is done, so another thread can get completions while the batch
+// runs. Illegal jobs (unknown op, division by 0, coefficient over 255 of
+// GF(2^8) or NULL region) are put to ring with err -1 at once. Batches
+// smaller than the min bytes of pool are processed inline (pool may be
+// NULL, too).
+// The caller is one of the threads and cannot get completions until the
+// batch ends, so the batch is refused if ring has less than n free slots
+// (slots kept for submitted batches are not free).
+//
+// Args:
+//     desc: n jobs
+//     ring: completion ring of n free slots or more (or NULL)
+//
+// Return value:
+//     0 or -1 if failed
+//
+// Usage:
+//     GFpoolRing *ring = GFpoolRingCrt(N);
+//     GFpoolDesc desc[N] = {{GF_POOL_MULADD16, a, y, x, len, id}, ...};
+//     GFpoolCmpl cmpl;
+//     GFpoolBatch(pool, desc, N, ring);
+//     while (GFpoolRingGet(ring, &cmpl)) {
+//         Done(cmpl.id);
+//     }
+//
+int
+GFpoolBatch(GFpool *pool, const GFpoolDesc *desc, size_t n, GFpoolRing *ring)
+{
+	GFpoolJob	job;
+
+	if (n == 0) {
+		return 0;
+	}
+	if (ring != NULL && GFpoolRingReserve(ring, n) < 0) {
+		fprintf(stderr, "Error: %s: Too many jobs for ring: %zu\n",
+			__func__, n);
+		return -1;
+	}
+	if (GFpoolBatchInit(pool, &job, desc, n, ring, 0) < 0) {
+		return -1;
+	}
+
+	// Run
+	if (job.n_deq == 1) {
+		GFpoolWorkBatch(&job, 0, NULL);
+	} else {
+		GFpoolPost(pool, &job);
+	}
+
+	GFpoolBatchFree(&job);
+
+	return 0;
+}
+
+/**************************************************************************
+	Asynchronous batch
+**************************************************************************/
+
+// Submit batch of n independent jobs to workers of pool and return
+// without waiting. Jobs are run as GFpoolBatch() by the workers only, and
+// their completions are put to ring, whose descriptor (GFpoolRingGetFd())
+// becomes readable, so the caller can wait for them in its event loop
+// (epoll, io_uring, ...) with its I/O. desc is copied, but the regions
+// must be kept until their completions are got. Batches are run in order
+// of submission; a pool without workers (1 thread) runs them at once.
+// n slots of ring are kept for the batch until its completions are put,
+// so the call fails if ring has less than n slots neither holding
+// completions nor kept for other batches; get completions and submit
+// again. GFpoolFree() waits for all batches.
+//
+// Args:
+//     desc: n jobs
+//     ring: completion ring of n free slots or more
+//
+// Return value:
+//     0 or -1 if failed
+//
+// Usage:
+//     GFpoolSubmit(pool, desc, N, ring);
+//     epoll_ctl(ep, EPOLL_CTL_ADD, GFpoolRingGetFd(ring), &ev);
+//     ... (fd is readable)
+//     n = GFpoolPoll(ring, cmpl, N);
+//
+int
+GFpoolSubmit(GFpool *pool, const GFpoolDesc *desc, size_t n,
+	     GFpoolRing *ring)
+{
+	GFpoolJob	*job;
+	GFpoolDesc	*copy;
+
+	if (ring == NULL) {
+		fprintf(stderr, "Error: %s: No ring\n", __func__);
+		return -1;
+	}
+	if (n == 0) {
+		return 0;
+	}
+
+	// No workers
+	if (pool == NULL || pool->n <= 1) {
+		return GFpoolBatch(pool, desc, n, ring);
+	}
+
+	// Job and copy of descriptors at once
+	if ((job = (GFpoolJob *)malloc(sizeof(GFpoolJob) +
+				       sizeof(GFpoolDesc) * n)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	copy = (GFpoolDesc *)(job + 1);
+	memcpy(copy, desc, sizeof(GFpoolDesc) * n);
+	if (GFpoolRingReserve(ring, n) < 0) {
+		fprintf(stderr, "Error: %s: Too many jobs for ring: %zu\n",
+			__func__, n);
+		free(job);
+		return -1;
+	}
+	if (GFpoolBatchInit(pool, job, copy, n, ring, pool->n - 1) < 0) {
+		free(job);
+		return -1;
+	}
+
+	// Queue
+	pthread_mutex_lock(&pool->lock);
+	if (pool->aq_tail != NULL) {
+		pool->aq_tail->aq_next = job;
+	} else {
+		pool->aq_head = job;
+	}
+	pool->aq_tail = job;
+	pthread_cond_broadcast(&pool->cv_start);
+	pthread_mutex_unlock(&pool->lock);
+
+	return 0;
+}
+
+// Get completions from ring without blocking
+// The descriptor of ring is cleared, so it becomes readable again when
+// a new completion is put.
+//
+// Args:
+//     cmpl: max completions
+//
+// Return value:
+//     # of completions got (0 if none)
+//
+size_t
+GFpoolPoll(GFpoolRing *ring, GFpoolCmpl *cmpl, size_t max)
+{
+	size_t	n;
+	uint8_t	buf[64];
+
+	// Clear descriptor and arm notification, then get
+	while (read(ring->fd[0], buf, sizeof(buf)) > 0);
+	atomic_store_explicit(&ring->armed, 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	for (n = 0; n < max && GFpoolRingGet(ring, &cmpl[n]); n++);
+
+	// More left
+	if (n == max && max > 0) {
+		GFpoolRingNotify(ring);
+	}
+
+	return n;
+}
+
+// Same as GFpoolPoll() but wait for completions up to timeout ms
+// (-1: forever). Wakeups without completions (e.g. got by another
+// consumer) wait only for the rest of timeout.
+//
+// Return value:
+//     # of completions got (0 if timed out or poll() failed)
+//
+size_t
+GFpoolWait(GFpoolRing *ring, GFpoolCmpl *cmpl, size_t max, int timeout)
+{
+	int		left = timeout, ret;
+	size_t		n;
+	int64_t		ns;
+	struct pollfd	pfd;
+	struct timespec	end, now;
+
+	// Deadline
+	if (timeout > 0) {
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		ns = end.tv_nsec + (int64_t)(timeout % 1000) * 1000000;
+		end.tv_sec += timeout / 1000 + ns / 1000000000;
+		end.tv_nsec = ns % 1000000000;
+	}
+
+	for (;;) {
+		if ((n = GFpoolPoll(ring, cmpl, max)) > 0 || max == 0) {
+			return n;
+		}
+
+		// Rest of timeout in ms (rounded up)
+		if (timeout > 0) {
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			ns = (int64_t)(end.tv_sec - now.tv_sec) * 1000000000 +
+			     (end.tv_nsec - now.tv_nsec);
+			if (ns <= 0) {
+				return 0;
+			}
+			left = (int)((ns + 999999) / 1000000);
+		}
+
+		pfd.fd = ring->fd[0];
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if ((ret = poll(&pfd, 1, left)) == 0) {
+			return 0;
+		}
+		if (ret < 0 && errno != EINTR) {
+			fprintf(stderr, "Error: %s: poll: %s\n",
+				__func__, strerror(errno));
+			return 0;
+		}
+	}
+}
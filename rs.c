@@ -0,0 +1,1334 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2016, 2022
+ *      ASUSA Corporation.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the University nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/****************************************************************************
+
+	Systematic Reed-Solomon erasure code RS(k, m) in GF(2^16) and
+	GF(2^8). Encoding and decoding are done by GF16encodeRegion()
+	(or GF8dotRegion()), so they run at the speed of the SIMD region
+	kernels. Only the small k x k matrices are computed by scalar
+	GF16mul() and GF16div().
+
+****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h> 
+#include <stdint.h> 
+#include <string.h> 
+#include <errno.h> 
+#include <unistd.h>
+#include "gf.h"
+#include "rs.h"
+
+// Definitions
+#define RS16_MAX	65536	// Max k + m in GF(2^16)
+#define RS8_MAX		256	// Max k + m in GF(2^8)
+#define RS16_ROW_MIN	128	// Min # of elements of row for region functions
+				// (= 256 bytes)
+#define RS8_ROW_MIN	64	// (= 64 bytes)
+
+// Check if block i is erased in bitmap
+#define RSisErased(bmp, i)	(((bmp)[(i) >> 6] >> ((i) & 63)) & 1)
+
+/**************************************************************************
+	Common
+**************************************************************************/
+
+// Check erasure pattern and make its bitmap
+//
+// Args:
+//     k, m: # of data and parity blocks
+//     era: indices of erased blocks
+//     n_era: # of erased blocks
+//     bmp: bitmap of erased blocks ((k + m + 63) / 64 words, output)
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+static int
+RScheckEra(int k, int m, const int *era, int n_era, uint64_t *bmp)
+{
+	int	i;
+
+	if (n_era < 0 || n_era > m) {
+		fprintf(stderr, "Error: %s: Too many erasures: %d "
+			"(must be <= %d)\n", __func__, n_era, m);
+		return -1;
+	}
+
+	memset(bmp, 0, sizeof(uint64_t) * ((k + m + 63) >> 6));
+	for (i = 0; i < n_era; i++) {
+		if (era[i] < 0 || era[i] >= k + m) {
+			fprintf(stderr, "Error: %s: Illegal block index: %d\n",
+				__func__, era[i]);
+			return -1;
+		}
+		if (RSisErased(bmp, era[i])) {
+			fprintf(stderr, "Error: %s: Duplicate block index: %d\n",
+				__func__, era[i]);
+			return -1;
+		}
+		bmp[era[i] >> 6] |= (uint64_t)1 << (era[i] & 63);
+	}
+
+	return 0;
+}
+
+/**************************************************************************
+	16bit
+**************************************************************************/
+
+/******************** Matrix ********************/
+
+// Matrices are arrays of uint16_t (row major). Rows are calculated by
+// the region functions (GF16mulAddRegion(), GF16dotRegion()) instead of
+// GF16mul() of each element. Rows shorter than RS16_ROW_MIN elements
+// don't fill a SIMD register, so they are calculated by GF16mul().
+
+// row[j] = row[j] / f (j = 0, ..., n - 1)
+static void
+RS16rowDiv(uint16_t *row, int n, uint16_t f)
+{
+	int	j;
+
+	if (n < RS16_ROW_MIN) {
+		for (j = 0; j < n; j++) {
+			row[j] = GF16div(row[j], f);
+		}
+	} else {
+		GF16divRegion((uint8_t *)row, (const uint8_t *)row,
+			      sizeof(uint16_t) * n, f);
+	}
+}
+
+// dst[j] ^= f * src[j] (j = 0, ..., n - 1)
+static void
+RS16rowMulAdd(uint16_t *dst, const uint16_t *src, int n, uint16_t f)
+{
+	int	j;
+
+	if (n < RS16_ROW_MIN) {
+		for (j = 0; j < n; j++) {
+			dst[j] ^= GF16mul(f, src[j]);
+		}
+	} else {
+		GF16mulAddRegion((uint8_t *)dst, (const uint8_t *)src,
+				 sizeof(uint16_t) * n, f);
+	}
+}
+
+// Invert k x k matrix by Gauss-Jordan elimination
+//
+// Args:
+//     inv: inverse of a (k x k, output)
+//     a: k x k matrix
+//     k: # of rows and columns
+//
+// Return value:
+//     0 if OK, -1 if a is singular or failed
+//
+int
+RS16mtxInv(uint16_t *inv, const uint16_t *a, int k)
+{
+	int		c, n, r, w = k << 1;
+	uint16_t	*aug, *row_c, *row_r, *tmp, f;
+
+	// Augmented matrix [a | I] of k rows (+ 1 row for swap)
+	if ((aug = (uint16_t *)malloc(sizeof(uint16_t) * w * (k + 1)))
+			== NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	tmp = aug + w * k;
+	for (r = 0; r < k; r++) {
+		memcpy(aug + r * w, a + r * k, sizeof(uint16_t) * k);
+		memset(aug + r * w + k, 0, sizeof(uint16_t) * k);
+		aug[r * w + k + r] = 1;
+	}
+
+	for (c = 0; c < k; c++) {
+		// Find pivot
+		for (r = c; r < k && aug[r * w + c] == 0; r++);
+		if (r == k) {
+			fprintf(stderr, "Error: %s: Singular matrix\n",
+				__func__);
+			free(aug);
+			return -1;
+		}
+
+		// Swap rows
+		row_c = aug + c * w;
+		if (r != c) {
+			row_r = aug + r * w;
+			memcpy(tmp, row_r, sizeof(uint16_t) * w);
+			memcpy(row_r, row_c, sizeof(uint16_t) * w);
+			memcpy(row_c, tmp, sizeof(uint16_t) * w);
+		}
+
+		// Columns before c are already 0 and columns after the last
+		// non-zero one of pivot row don't change
+		for (n = w; row_c[n - 1] == 0; n--);
+		n -= c;
+
+		// Make pivot 1
+		if ((f = row_c[c]) != 1) {
+			RS16rowDiv(row_c + c, n, f);
+		}
+
+		// Eliminate column c of other rows
+		for (r = 0; r < k; r++) {
+			row_r = aug + r * w;
+			if (r == c || (f = row_r[c]) == 0) {
+				continue;
+			}
+			RS16rowMulAdd(row_r + c, row_c + c, n, f);
+		}
+	}
+
+	// Right half is the inverse
+	for (r = 0; r < k; r++) {
+		memcpy(inv + r * k, aug + r * w + k, sizeof(uint16_t) * k);
+	}
+	free(aug);
+
+	return 0;
+}
+
+// Multiply matrices: c = a * b
+//
+// Args:
+//     c: n x p matrix (output, must not overlap b)
+//     a: n x k matrix
+//     b: k x p matrix
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS16mtxMul(uint16_t *c, const uint16_t *a, const uint16_t *b, int n, int k,
+	   int p)
+{
+	int		i;
+	const uint8_t	**rows;
+
+	if ((rows = (const uint8_t **)malloc(sizeof(uint8_t *) * k))
+			== NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	for (i = 0; i < k; i++) {
+		rows[i] = (const uint8_t *)(b + i * p);
+	}
+
+	// Row i of c = a[i][0] * row 0 of b + ... + a[i][k - 1] * row k - 1
+	for (i = 0; i < n; i++) {
+		GF16dotRegion((uint8_t *)(c + i * p), rows, a + i * k, k,
+			      sizeof(uint16_t) * p);
+	}
+	free(rows);
+
+	return 0;
+}
+
+// Set m x k Cauchy matrix: mtx[r][i] = 1 / (x_r + y_i) where
+// x_r = k + r, y_i = i (k + m <= 65536)
+void
+RS16cauchyMtx(uint16_t *mtx, int k, int m)
+{
+	int	i, r;
+
+	for (r = 0; r < m; r++) {
+		for (i = 0; i < k; i++) {
+			mtx[r * k + i] = GF16div(1, (k + r) ^ i);
+		}
+	}
+}
+
+// Set m x k systematic Vandermonde matrix (k + m <= 65536)
+// Vandermonde matrix V[x][j] = x^j (x = 0 to k + m - 1) is multiplied by
+// the inverse of its top k rows, and mtx is its bottom m rows.
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS16vandMtx(uint16_t *mtx, int k, int m)
+{
+	int		i, j, ret;
+	uint16_t	*v, *inv, p;
+
+	if ((v = (uint16_t *)malloc(sizeof(uint16_t) * k * (2 * k + m)))
+			== NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	inv = v + k * (k + m);
+
+	for (i = 0; i < k + m; i++) {
+		for (j = 0, p = 1; j < k; j++) {
+			v[i * k + j] = p;
+			p = GF16mul(p, i);
+		}
+	}
+
+	if ((ret = RS16mtxInv(inv, v, k)) == 0) {
+		ret = RS16mtxMul(mtx, v + k * k, inv, m, k, k);
+	}
+	free(v);
+
+	return ret;
+}
+
+/******************** Codec ********************/
+
+// Create RS(k, m) encoder in GF(2^16)
+//
+// Args:
+//     k: # of data blocks
+//     m: # of parity blocks (k + m <= 65536)
+//     type: coding matrix: RS_CAUCHY or RS_VAND
+//
+// Return value:
+//     pointer to encoder or NULL if failed. Free it by RS16free().
+//
+// Usage:
+//     RS16 *rs = RS16crt(10, 4, RS_CAUCHY);
+//     RS16encode(rs, blks, len);
+//     RS16free(rs);
+//
+RS16 *
+RS16crt(int k, int m, int type)
+{
+	RS16		*rs;
+
+	if (k <= 0 || m < 0 || k + m > RS16_MAX) {
+		fprintf(stderr, "Error: %s: Illegal arguments: k = %d, m = %d\n",
+			__func__, k, m);
+		return NULL;
+	}
+
+	// Allocate encoder and matrix at once
+	if ((rs = (RS16 *)malloc(sizeof(RS16) +
+				 sizeof(uint16_t) * m * k)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	rs->k = k;
+	rs->m = m;
+	rs->mtx = (uint16_t *)(rs + 1);
+	rs->n_cache = 0;
+
+	switch (type) {
+	case RS_CAUCHY:
+		RS16cauchyMtx(rs->mtx, k, m);
+		break;
+
+	case RS_VAND:
+		if (RS16vandMtx(rs->mtx, k, m) < 0) {
+			free(rs);
+			return NULL;
+		}
+		break;
+
+	default:
+		fprintf(stderr, "Error: %s: Illegal third argument value: %d "
+			"(value must be 0 or 1)\n", __func__, type);
+		free(rs);
+		return NULL;
+	}
+
+	return rs;
+}
+
+// Free encoder and its cached decoders
+void
+RS16free(RS16 *rs)
+{
+	int	i;
+
+	if (rs == NULL) {
+		return;
+	}
+	for (i = 0; i < rs->n_cache; i++) {
+		RS16freeDec(rs->cache[i]);
+	}
+	free(rs);
+}
+
+// Encode m parity blocks from k data blocks
+//
+// Args:
+//     rs: encoder
+//     blks: k data blocks followed by m parity blocks (output)
+//     len: length of each block in bytes (must be a multiple of 2)
+//
+void
+RS16encode(const RS16 *rs, uint8_t * const *blks, size_t len)
+{
+	GF16encodeRegion(blks + rs->k, (const uint8_t * const *)blks,
+			 rs->mtx, rs->m, rs->k, len);
+}
+
+// Create decoder for an erasure pattern
+// The decoder can be reused for any blocks with the same pattern.
+//
+// Args:
+//     rs: encoder
+//     era: indices of erased blocks (0 to k + m - 1)
+//     n_era: # of erased blocks (<= m)
+//
+// Return value:
+//     pointer to decoder or NULL if failed. Free it by RS16freeDec().
+//
+// Usage:
+//     int era[2] = { 3, 11 }; // Data 3 and parity 1 (k = 10) are lost
+//     RS16dec *dec = RS16crtDec(rs, era, 2);
+//     RS16decode(dec, blks, len); // blks[3] and blks[11] are recovered
+//     RS16freeDec(dec);
+//
+RS16dec *
+RS16crtDec(const RS16 *rs, const int *era, int n_era)
+{
+	int		i, n, x, k = rs->k, n_w = (k + rs->m + 63) >> 6;
+	uint16_t	*a, *inv;
+	RS16dec		*dec;
+
+	// Allocate decoder and its arrays at once
+	if ((dec = (RS16dec *)malloc(sizeof(RS16dec) +
+				     sizeof(uint64_t) * n_w +
+				     sizeof(int) * (n_era + k) +
+				     sizeof(uint16_t) * n_era * k)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	dec->k = k;
+	dec->m = rs->m;
+	dec->n_era = n_era;
+	dec->bmp = (uint64_t *)(dec + 1);
+	dec->era = (int *)(dec->bmp + n_w);
+	dec->surv = dec->era + n_era;
+	dec->mtx = (uint16_t *)(dec->surv + k);
+
+	if (RScheckEra(k, rs->m, era, n_era, dec->bmp) < 0) {
+		free(dec);
+		return NULL;
+	}
+	memcpy(dec->era, era, sizeof(int) * n_era);
+
+	// Use first k blocks not erased
+	for (i = n = 0; n < k; i++) {
+		if (!RSisErased(dec->bmp, i)) {
+			dec->surv[n++] = i;
+		}
+	}
+
+	// Working matrices
+	if ((a = (uint16_t *)malloc(sizeof(uint16_t) * k * k * 2)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		free(dec);
+		return NULL;
+	}
+	inv = a + k * k;
+
+	// Rows of generator matrix for survivors
+	for (i = 0; i < k; i++) {
+		x = dec->surv[i];
+		if (x < k) {
+			memset(a + i * k, 0, sizeof(uint16_t) * k);
+			a[i * k + x] = 1;
+		} else {
+			memcpy(a + i * k, rs->mtx + (x - k) * k,
+			       sizeof(uint16_t) * k);
+		}
+	}
+
+	// data = inv * survivors
+	if (RS16mtxInv(inv, a, k) < 0) {
+		free(a);
+		free(dec);
+		return NULL;
+	}
+
+	// Rows of decoding matrix
+	for (i = 0; i < n_era; i++) {
+		x = era[i];
+		if (x < k) { // Data
+			memcpy(dec->mtx + i * k, inv + x * k,
+			       sizeof(uint16_t) * k);
+		} else if (RS16mtxMul(dec->mtx + i * k, rs->mtx + (x - k) * k,
+				      inv, 1, k, k) < 0) { // Parity
+			free(a);
+			free(dec);
+			return NULL;
+		}
+	}
+	free(a);
+
+	return dec;
+}
+
+// Free decoder
+void
+RS16freeDec(RS16dec *dec)
+{
+	free(dec);
+}
+
+// Get decoder for an erasure pattern from cache of encoder
+// Decoders of the last RS_DEC_CACHE patterns are kept in rs (LRU) and
+// looked up by bitmap of erased blocks, so repeated patterns skip the
+// matrix inversion. The order of era[] does not matter.
+// Not thread-safe: use one encoder per thread or lock it.
+//
+// Return value:
+//     pointer to decoder or NULL if failed. Do not free it; it is valid
+//     until the next RS16getDec() or RS16free() of rs.
+//
+RS16dec *
+RS16getDec(RS16 *rs, const int *era, int n_era)
+{
+	int		i, n_w = (rs->k + rs->m + 63) >> 6;
+	uint64_t	bmp[RS16_MAX >> 6];
+	RS16dec		*dec;
+
+	if (RScheckEra(rs->k, rs->m, era, n_era, bmp) < 0) {
+		return NULL;
+	}
+
+	// Hit: move it to front
+	for (i = 0; i < rs->n_cache; i++) {
+		dec = rs->cache[i];
+		if (dec->n_era == n_era &&
+		    memcmp(dec->bmp, bmp, sizeof(uint64_t) * n_w) == 0) {
+			memmove(rs->cache + 1, rs->cache,
+				sizeof(RS16dec *) * i);
+			rs->cache[0] = dec;
+			return dec;
+		}
+	}
+
+	// Miss: create it and evict least recently used one
+	if ((dec = RS16crtDec(rs, era, n_era)) == NULL) {
+		return NULL;
+	}
+	if (rs->n_cache == RS_DEC_CACHE) {
+		RS16freeDec(rs->cache[--rs->n_cache]);
+	}
+	memmove(rs->cache + 1, rs->cache, sizeof(RS16dec *) * rs->n_cache);
+	rs->cache[0] = dec;
+	rs->n_cache++;
+
+	return dec;
+}
+
+// Recover erased blocks with decoder
+//
+// Args:
+//     dec: decoder created by RS16crtDec() or RS16getDec()
+//     blks: k + m blocks; erased ones are output
+//     len: length of each block in bytes (must be a multiple of 2)
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS16decode(const RS16dec *dec, uint8_t * const *blks, size_t len)
+{
+	int		i;
+	const uint8_t	**srcs;
+	uint8_t		**dsts;
+
+	if (dec->n_era == 0) {
+		return 0;
+	}
+
+	if ((srcs = (const uint8_t **)malloc(sizeof(uint8_t *) *
+					     (dec->k + dec->n_era))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	dsts = (uint8_t **)(srcs + dec->k);
+
+	for (i = 0; i < dec->k; i++) {
+		srcs[i] = blks[dec->surv[i]];
+	}
+	for (i = 0; i < dec->n_era; i++) {
+		dsts[i] = blks[dec->era[i]];
+	}
+
+	// All erased blocks in one pass over survivors
+	GF16encodeRegion(dsts, srcs, dec->mtx, dec->n_era, dec->k, len);
+
+	free(srcs);
+
+	return 0;
+}
+
+// Recover erased blocks (RS16getDec() + RS16decode())
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS16recover(RS16 *rs, uint8_t * const *blks, const int *era, int n_era,
+	    size_t len)
+{
+	RS16dec		*dec;
+
+	if ((dec = RS16getDec(rs, era, n_era)) == NULL) {
+		return -1;
+	}
+
+	return RS16decode(dec, blks, len);
+}
+
+/******************** Stream ********************/
+
+// Read len bytes to buf by rd (short reads are continued)
+//
+// Return value:
+//     # of bytes read (< len at end of input) or -1 if failed
+//
+static ssize_t
+RS16readFull(RSread rd, void *arg, uint8_t *buf, size_t len)
+{
+	size_t	n;
+	ssize_t	r;
+
+	for (n = 0; n < len; n += r) {
+		if ((r = rd(arg, buf + n, len - n)) < 0) {
+			return -1;
+		}
+		if (r == 0) { // End of input
+			break;
+		}
+	}
+
+	return n;
+}
+
+// Encode input of any length stripe by stripe with bounded memory
+// Input is read from rd in blocks of len bytes: block i of stripe s is
+// bytes (s * k + i) * len to (s * k + i + 1) * len - 1 of the input.
+// As each data block is read, it is multiplied and added to the m parity
+// blocks of the stripe (GF16mulAddRegion()), so only one data block and
+// m parity blocks ((1 + m) x len bytes) are held whatever the length of
+// the input. Every block of a stripe (k data, then m parity) is given to
+// wr. The last stripe is padded with zero, so keep the return value (the
+// length of the input) to cut the padding when decoding.
+//
+// Args:
+//     rs: encoder
+//     len: length of each block in bytes (multiple of 2, e.g. 64kB so
+//          that m parity blocks fit L2 cache)
+//     rd: reads up to n bytes to buf and returns # of bytes (0 at end of
+//         input, -1 if failed) like read()
+//     wr: writes block blk (0 to k + m - 1) of stripe and returns 0 (-1
+//         if failed)
+//     rd_arg, wr_arg: first argument of rd and wr
+//
+// Return value:
+//     length of input in bytes or -1 if failed
+//
+// Usage:
+//     static ssize_t Rd(void *arg, uint8_t *buf, size_t n) { ... }
+//     static int Wr(void *arg, uint64_t stripe, int blk,
+//                   const uint8_t *buf, size_t n) { ... }
+//     int64_t size = RS16encodeStream(rs, 65536, Rd, &in, Wr, &out);
+//
+int64_t
+RS16encodeStream(const RS16 *rs, size_t len, RSread rd, void *rd_arg,
+		 RSwrite wr, void *wr_arg)
+{
+	int		i, r, eof = 0;
+	uint64_t	stripe;
+	int64_t		total = 0;
+	ssize_t		n;
+	size_t		size;
+	uint8_t		*data, *parity;
+
+	if (len == 0 || (len & 1) != 0) {
+		fprintf(stderr, "Error: %s: Illegal block length: %zu "
+			"(must be a multiple of 2)\n", __func__, len);
+		return -1;
+	}
+
+	// One data block and m parity blocks
+	size = (len * (1 + rs->m) + 63) & ~(size_t)63;
+	if ((data = (uint8_t *)aligned_alloc(64, size)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	parity = data + len;
+
+	for (stripe = 0; ; stripe++) {
+		for (i = 0; i < rs->k; i++) {
+			// Read data block (zero after end of input)
+			if (eof) {
+				n = 0;
+			} else if ((n = RS16readFull(rd, rd_arg, data,
+						     len)) < 0) {
+				fprintf(stderr, "Error: %s: Read failed\n",
+					__func__);
+				goto err;
+			}
+			if (n == 0 && i == 0) { // End at stripe boundary
+				goto end;
+			}
+			eof = n < (ssize_t)len;
+			memset(data + n, 0, len - n);
+			total += n;
+
+			// parity[r] += mtx[r][i] * data
+			for (r = 0; r < rs->m; r++) {
+				if (i == 0) {
+					GF16mulRegion(parity + r * len, data,
+						      len, rs->mtx[r * rs->k]);
+				} else if (n > 0) {
+					GF16mulAddRegion(parity + r * len,
+						data, len, rs->mtx[r * rs->k + i]);
+				}
+			}
+
+			if (wr(wr_arg, stripe, i, data, len) < 0) {
+				fprintf(stderr, "Error: %s: Write failed\n",
+					__func__);
+				goto err;
+			}
+		}
+
+		// Parity blocks of stripe
+		for (r = 0; r < rs->m; r++) {
+			if (wr(wr_arg, stripe, rs->k + r, parity + r * len,
+			       len) < 0) {
+				fprintf(stderr, "Error: %s: Write failed\n",
+					__func__);
+				goto err;
+			}
+		}
+
+		// End in stripe
+		if (eof) {
+			break;
+		}
+	}
+
+end:
+	free(data);
+	return total;
+
+err:
+	free(data);
+	return -1;
+}
+
+// Read by read() of fd for RS16encodeFd()
+static ssize_t
+RS16readFd(void *arg, uint8_t *buf, size_t len)
+{
+	ssize_t	n;
+
+	while ((n = read(*(int *)arg, buf, len)) < 0 && errno == EINTR);
+	if (n < 0) {
+		fprintf(stderr, "Error: %s: read: %s\n",
+			__func__, strerror(errno));
+	}
+
+	return n;
+}
+
+// Write block blk to fd[blk] for RS16encodeFd() (skipped if fd is -1)
+static int
+RS16writeFd(void *arg, uint64_t stripe, int blk, const uint8_t *buf,
+	    size_t len)
+{
+	int	fd = ((int *)arg)[blk];
+	ssize_t	n;
+
+	if (fd < 0) {
+		return 0;
+	}
+	while (len > 0) {
+		if ((n = write(fd, buf, len)) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fprintf(stderr, "Error: %s: write: %s\n",
+				__func__, strerror(errno));
+			return -1;
+		}
+		buf += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+// Same as RS16encodeStream() but read input from fd in and append block
+// i of every stripe to fd out[i]
+//
+// Args:
+//     out: k + m descriptors (-1 to skip the block, e.g. data blocks)
+//
+// Return value:
+//     length of input in bytes or -1 if failed
+//
+// Usage:
+//     int out[14] = { -1, ..., -1, p0, p1, p2, p3 }; // Parity only
+//     int64_t size = RS16encodeFd(rs, 65536, in, out);
+//
+int64_t
+RS16encodeFd(const RS16 *rs, size_t len, int in, const int *out)
+{
+	return RS16encodeStream(rs, len, RS16readFd, &in, RS16writeFd,
+				(void *)out);
+}
+
+/**************************************************************************
+	8bit
+**************************************************************************/
+
+/******************** Matrix ********************/
+
+// Matrices are arrays of uint8_t (row major). Rows are calculated by
+// the region functions (GF8mulAddRegion(), GF8dotRegion()) instead of
+// GF8mul() of each element. Rows shorter than RS8_ROW_MIN elements
+// don't fill a SIMD register, so they are calculated by GF8mul().
+
+// row[j] = row[j] / f (j = 0, ..., n - 1)
+static void
+RS8rowDiv(uint8_t *row, int n, uint8_t f)
+{
+	int	j;
+
+	if (n < RS8_ROW_MIN) {
+		for (j = 0; j < n; j++) {
+			row[j] = GF8div(row[j], f);
+		}
+	} else {
+		GF8divRegion(row, row, n, f);
+	}
+}
+
+// dst[j] ^= f * src[j] (j = 0, ..., n - 1)
+static void
+RS8rowMulAdd(uint8_t *dst, const uint8_t *src, int n, uint8_t f)
+{
+	int	j;
+
+	if (n < RS8_ROW_MIN) {
+		for (j = 0; j < n; j++) {
+			dst[j] ^= GF8mul(f, src[j]);
+		}
+	} else {
+		GF8mulAddRegion(dst, src, n, f);
+	}
+}
+
+// Invert k x k matrix by Gauss-Jordan elimination
+//
+// Args:
+//     inv: inverse of a (k x k, output)
+//     a: k x k matrix
+//     k: # of rows and columns
+//
+// Return value:
+//     0 if OK, -1 if a is singular or failed
+//
+int
+RS8mtxInv(uint8_t *inv, const uint8_t *a, int k)
+{
+	int		c, n, r, w = k << 1;
+	uint8_t		*aug, *row_c, *row_r, *tmp, f;
+
+	// Augmented matrix [a | I] of k rows (+ 1 row for swap)
+	if ((aug = (uint8_t *)malloc(w * (k + 1))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	tmp = aug + w * k;
+	for (r = 0; r < k; r++) {
+		memcpy(aug + r * w, a + r * k, k);
+		memset(aug + r * w + k, 0, k);
+		aug[r * w + k + r] = 1;
+	}
+
+	for (c = 0; c < k; c++) {
+		// Find pivot
+		for (r = c; r < k && aug[r * w + c] == 0; r++);
+		if (r == k) {
+			fprintf(stderr, "Error: %s: Singular matrix\n",
+				__func__);
+			free(aug);
+			return -1;
+		}
+
+		// Swap rows
+		row_c = aug + c * w;
+		if (r != c) {
+			row_r = aug + r * w;
+			memcpy(tmp, row_r, w);
+			memcpy(row_r, row_c, w);
+			memcpy(row_c, tmp, w);
+		}
+
+		// Columns before c are already 0 and columns after the last
+		// non-zero one of pivot row don't change
+		for (n = w; row_c[n - 1] == 0; n--);
+		n -= c;
+
+		// Make pivot 1
+		if ((f = row_c[c]) != 1) {
+			RS8rowDiv(row_c + c, n, f);
+		}
+
+		// Eliminate column c of other rows
+		for (r = 0; r < k; r++) {
+			row_r = aug + r * w;
+			if (r == c || (f = row_r[c]) == 0) {
+				continue;
+			}
+			RS8rowMulAdd(row_r + c, row_c + c, n, f);
+		}
+	}
+
+	// Right half is the inverse
+	for (r = 0; r < k; r++) {
+		memcpy(inv + r * k, aug + r * w + k, k);
+	}
+	free(aug);
+
+	return 0;
+}
+
+// Multiply matrices: c = a * b
+//
+// Args:
+//     c: n x p matrix (output, must not overlap b)
+//     a: n x k matrix
+//     b: k x p matrix
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS8mtxMul(uint8_t *c, const uint8_t *a, const uint8_t *b, int n, int k,
+	  int p)
+{
+	int		i;
+	const uint8_t	**rows;
+
+	if ((rows = (const uint8_t **)malloc(sizeof(uint8_t *) * k))
+			== NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	for (i = 0; i < k; i++) {
+		rows[i] = b + i * p;
+	}
+
+	// Row i of c = a[i][0] * row 0 of b + ... + a[i][k - 1] * row k - 1
+	for (i = 0; i < n; i++) {
+		GF8dotRegion(c + i * p, rows, a + i * k, k, p);
+	}
+	free(rows);
+
+	return 0;
+}
+
+// Set m x k Cauchy matrix: mtx[r][i] = 1 / (x_r + y_i) where
+// x_r = k + r, y_i = i (k + m <= 256)
+void
+RS8cauchyMtx(uint8_t *mtx, int k, int m)
+{
+	int	i, r;
+
+	for (r = 0; r < m; r++) {
+		for (i = 0; i < k; i++) {
+			mtx[r * k + i] = GF8div(1, (k + r) ^ i);
+		}
+	}
+}
+
+// Set m x k systematic Vandermonde matrix (k + m <= 256)
+// Vandermonde matrix V[x][j] = x^j (x = 0 to k + m - 1) is multiplied by
+// the inverse of its top k rows, and mtx is its bottom m rows.
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS8vandMtx(uint8_t *mtx, int k, int m)
+{
+	int		i, j, ret;
+	uint8_t		*v, *inv, p;
+
+	if ((v = (uint8_t *)malloc(k * (2 * k + m)))
+			== NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	inv = v + k * (k + m);
+
+	for (i = 0; i < k + m; i++) {
+		for (j = 0, p = 1; j < k; j++) {
+			v[i * k + j] = p;
+			p = GF8mul(p, i);
+		}
+	}
+
+	if ((ret = RS8mtxInv(inv, v, k)) == 0) {
+		ret = RS8mtxMul(mtx, v + k * k, inv, m, k, k);
+	}
+	free(v);
+
+	return ret;
+}
+
+/******************** Codec ********************/
+
+// Create RS(k, m) encoder in GF(2^8)
+//
+// Args:
+//     k: # of data blocks
+//     m: # of parity blocks (k + m <= 256)
+//     type: coding matrix: RS_CAUCHY or RS_VAND
+//
+// Return value:
+//     pointer to encoder or NULL if failed. Free it by RS8free().
+//
+// Usage:
+//     RS8 *rs = RS8crt(10, 4, RS_CAUCHY);
+//     RS8encode(rs, blks, len);
+//     RS8free(rs);
+//
+RS8 *
+RS8crt(int k, int m, int type)
+{
+	RS8		*rs;
+
+	if (k <= 0 || m < 0 || k + m > RS8_MAX) {
+		fprintf(stderr, "Error: %s: Illegal arguments: k = %d, m = %d\n",
+			__func__, k, m);
+		return NULL;
+	}
+
+	// Allocate encoder and matrix at once
+	if ((rs = (RS8 *)malloc(sizeof(RS8) + m * k)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	rs->k = k;
+	rs->m = m;
+	rs->mtx = (uint8_t *)(rs + 1);
+	rs->n_cache = 0;
+
+	switch (type) {
+	case RS_CAUCHY:
+		RS8cauchyMtx(rs->mtx, k, m);
+		break;
+
+	case RS_VAND:
+		if (RS8vandMtx(rs->mtx, k, m) < 0) {
+			free(rs);
+			return NULL;
+		}
+		break;
+
+	default:
+		fprintf(stderr, "Error: %s: Illegal third argument value: %d "
+			"(value must be 0 or 1)\n", __func__, type);
+		free(rs);
+		return NULL;
+	}
+
+	return rs;
+}
+
+// Free encoder and its cached decoders
+void
+RS8free(RS8 *rs)
+{
+	int	i;
+
+	if (rs == NULL) {
+		return;
+	}
+	for (i = 0; i < rs->n_cache; i++) {
+		RS8freeDec(rs->cache[i]);
+	}
+	free(rs);
+}
+
+// Encode m parity blocks from k data blocks
+//
+// Args:
+//     rs: encoder
+//     blks: k data blocks followed by m parity blocks (output)
+//     len: length of each block in bytes
+//
+void
+RS8encode(const RS8 *rs, uint8_t * const *blks, size_t len)
+{
+	int	r;
+
+	for (r = 0; r < rs->m; r++) {
+		GF8dotRegion(blks[rs->k + r], (const uint8_t * const *)blks,
+			     rs->mtx + r * rs->k, rs->k, len);
+	}
+}
+
+// Create decoder for an erasure pattern
+// The decoder can be reused for any blocks with the same pattern.
+//
+// Args:
+//     rs: encoder
+//     era: indices of erased blocks (0 to k + m - 1)
+//     n_era: # of erased blocks (<= m)
+//
+// Return value:
+//     pointer to decoder or NULL if failed. Free it by RS8freeDec().
+//
+// Usage:
+//     int era[2] = { 3, 11 }; // Data 3 and parity 1 (k = 10) are lost
+//     RS8dec *dec = RS8crtDec(rs, era, 2);
+//     RS8decode(dec, blks, len); // blks[3] and blks[11] are recovered
+//     RS8freeDec(dec);
+//
+RS8dec *
+RS8crtDec(const RS8 *rs, const int *era, int n_era)
+{
+	int		i, n, x, k = rs->k, n_w = (k + rs->m + 63) >> 6;
+	uint8_t		*a, *inv;
+	RS8dec		*dec;
+
+	// Allocate decoder and its arrays at once
+	if ((dec = (RS8dec *)malloc(sizeof(RS8dec) +
+				    sizeof(uint64_t) * n_w +
+				    sizeof(int) * (n_era + k) +
+				    n_era * k)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return NULL;
+	}
+	dec->k = k;
+	dec->m = rs->m;
+	dec->n_era = n_era;
+	dec->bmp = (uint64_t *)(dec + 1);
+	dec->era = (int *)(dec->bmp + n_w);
+	dec->surv = dec->era + n_era;
+	dec->mtx = (uint8_t *)(dec->surv + k);
+
+	if (RScheckEra(k, rs->m, era, n_era, dec->bmp) < 0) {
+		free(dec);
+		return NULL;
+	}
+	memcpy(dec->era, era, sizeof(int) * n_era);
+
+	// Use first k blocks not erased
+	for (i = n = 0; n < k; i++) {
+		if (!RSisErased(dec->bmp, i)) {
+			dec->surv[n++] = i;
+		}
+	}
+
+	// Working matrices
+	if ((a = (uint8_t *)malloc(k * k * 2)) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		free(dec);
+		return NULL;
+	}
+	inv = a + k * k;
+
+	// Rows of generator matrix for survivors
+	for (i = 0; i < k; i++) {
+		x = dec->surv[i];
+		if (x < k) {
+			memset(a + i * k, 0, k);
+			a[i * k + x] = 1;
+		} else {
+			memcpy(a + i * k, rs->mtx + (x - k) * k, k);
+		}
+	}
+
+	// data = inv * survivors
+	if (RS8mtxInv(inv, a, k) < 0) {
+		free(a);
+		free(dec);
+		return NULL;
+	}
+
+	// Rows of decoding matrix
+	for (i = 0; i < n_era; i++) {
+		x = era[i];
+		if (x < k) { // Data
+			memcpy(dec->mtx + i * k, inv + x * k, k);
+		} else if (RS8mtxMul(dec->mtx + i * k, rs->mtx + (x - k) * k,
+				     inv, 1, k, k) < 0) { // Parity
+			free(a);
+			free(dec);
+			return NULL;
+		}
+	}
+	free(a);
+
+	return dec;
+}
+
+// Free decoder
+void
+RS8freeDec(RS8dec *dec)
+{
+	free(dec);
+}
+
+// Get decoder for an erasure pattern from cache of encoder
+// Decoders of the last RS_DEC_CACHE patterns are kept in rs (LRU) and
+// looked up by bitmap of erased blocks, so repeated patterns skip the
+// matrix inversion. The order of era[] does not matter.
+// Not thread-safe: use one encoder per thread or lock it.
+//
+// Return value:
+//     pointer to decoder or NULL if failed. Do not free it; it is valid
+//     until the next RS8getDec() or RS8free() of rs.
+//
+RS8dec *
+RS8getDec(RS8 *rs, const int *era, int n_era)
+{
+	int		i, n_w = (rs->k + rs->m + 63) >> 6;
+	uint64_t	bmp[RS8_MAX >> 6];
+	RS8dec		*dec;
+
+	if (RScheckEra(rs->k, rs->m, era, n_era, bmp) < 0) {
+		return NULL;
+	}
+
+	// Hit: move it to front
+	for (i = 0; i < rs->n_cache; i++) {
+		dec = rs->cache[i];
+		if (dec->n_era == n_era &&
+		    memcmp(dec->bmp, bmp, sizeof(uint64_t) * n_w) == 0) {
+			memmove(rs->cache + 1, rs->cache,
+				sizeof(RS8dec *) * i);
+			rs->cache[0] = dec;
+			return dec;
+		}
+	}
+
+	// Miss: create it and evict least recently used one
+	if ((dec = RS8crtDec(rs, era, n_era)) == NULL) {
+		return NULL;
+	}
+	if (rs->n_cache == RS_DEC_CACHE) {
+		RS8freeDec(rs->cache[--rs->n_cache]);
+	}
+	memmove(rs->cache + 1, rs->cache, sizeof(RS8dec *) * rs->n_cache);
+	rs->cache[0] = dec;
+	rs->n_cache++;
+
+	return dec;
+}
+
+// Recover erased blocks with decoder
+//
+// Args:
+//     dec: decoder created by RS8crtDec() or RS8getDec()
+//     blks: k + m blocks; erased ones are output
+//     len: length of each block in bytes
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS8decode(const RS8dec *dec, uint8_t * const *blks, size_t len)
+{
+	int		i;
+	const uint8_t	**srcs;
+	uint8_t		**dsts;
+
+	if (dec->n_era == 0) {
+		return 0;
+	}
+
+	if ((srcs = (const uint8_t **)malloc(sizeof(uint8_t *) *
+					     (dec->k + dec->n_era))) == NULL) {
+		fprintf(stderr, "Error: %s: malloc: %s\n",
+			__func__, strerror(errno));
+		return -1;
+	}
+	dsts = (uint8_t **)(srcs + dec->k);
+
+	for (i = 0; i < dec->k; i++) {
+		srcs[i] = blks[dec->surv[i]];
+	}
+	for (i = 0; i < dec->n_era; i++) {
+		dsts[i] = blks[dec->era[i]];
+	}
+
+	for (i = 0; i < dec->n_era; i++) {
+		GF8dotRegion(dsts[i], srcs, dec->mtx + i * dec->k, dec->k, len);
+	}
+
+	free(srcs);
+
+	return 0;
+}
+
+// Recover erased blocks (RS8getDec() + RS8decode())
+//
+// Return value:
+//     0 if OK, -1 if failed
+//
+int
+RS8recover(RS8 *rs, uint8_t * const *blks, const int *era, int n_era,
+	   size_t len)
+{
+	RS8dec		*dec;
+
+	if ((dec = RS8getDec(rs, era, n_era)) == NULL) {
+		return -1;
+	}
+
+	return RS8decode(dec, blks, len);
+}
@@ -0,0 +1,130 @@
+#ifndef _RS_H_
+#define _RS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "gf.h"
+
+/****************************************************************************
+
+	Systematic Reed-Solomon erasure code RS(k, m) in GF(2^16) and
+	GF(2^8) built on the region functions of gf.c.
+	k data blocks are encoded into m parity blocks, and any k of
+	the k + m blocks recover the others.
+
+	The coding matrix is Cauchy: parity[r] = sum of
+	1 / ((k + r) ^ i) * data[i], so every k x k sub-matrix of the
+	generator (identity on top of it) is invertible.
+	Thus k + m must be <= 65536 for RS16 and <= 256 for RS8.
+
+	The systematic Vandermonde matrix (RS_VAND) can be used instead.
+	Matrices are inverted and multiplied with the region functions
+	(RS16mtxInv(), RS16mtxMul()).
+
+	Blocks are given as one array blks[k + m]: blks[0] to blks[k - 1]
+	are data and blks[k] to blks[k + m - 1] are parity.
+
+	RS16encodeStream() encodes input of any length read by a callback
+	(or fd by RS16encodeFd()) stripe by stripe in (1 + m) blocks of
+	memory and gives the blocks to a write callback.
+	Call GF16init() (or GF8init()) before using these functions.
+
+****************************************************************************/
+
+// Types of coding matrix for RS16crt() and RS8crt()
+#define RS_CAUCHY	0	// Cauchy: 1 / ((k + r) ^ i)
+#define RS_VAND		1	// Systematic Vandermonde
+
+#define RS_DEC_CACHE	16	// # of decoders cached in an encoder (LRU)
+
+// Callbacks of RS16encodeStream()
+// RSread reads up to len bytes to buf (returns # of bytes, 0 at end, -1
+// if failed), RSwrite writes block blk of stripe (returns 0 or -1).
+typedef ssize_t	(*RSread)(void *, uint8_t *, size_t);
+typedef int	(*RSwrite)(void *, uint64_t, int, const uint8_t *, size_t);
+
+/***************************************************************************
+	16bit: GF(2^16)
+***************************************************************************/
+
+// Decoder for one erasure pattern
+typedef struct {
+	int		k;	// # of data blocks
+	int		m;	// # of parity blocks
+	int		n_era;	// # of erased blocks
+	uint64_t	*bmp;	// Bitmap of erased blocks (key of cache)
+	int		*era;	// Indices of erased blocks (n_era)
+	int		*surv;	// Indices of survivors used for decoding (k)
+	uint16_t	*mtx;	// n_era x k decoding matrix (row major)
+} RS16dec;
+
+// Encoder
+typedef struct {
+	int		k;	// # of data blocks
+	int		m;	// # of parity blocks
+	uint16_t	*mtx;	// m x k coding matrix (row major)
+	int		n_cache;	// # of cached decoders
+	RS16dec		*cache[RS_DEC_CACHE];	// Most recently used first
+} RS16;
+
+// Functions
+int		RS16mtxInv(uint16_t *, const uint16_t *, int);
+int		RS16mtxMul(uint16_t *, const uint16_t *, const uint16_t *,
+			   int, int, int);
+void		RS16cauchyMtx(uint16_t *, int, int);
+int		RS16vandMtx(uint16_t *, int, int);
+RS16		*RS16crt(int, int, int);
+void		RS16free(RS16 *);
+void		RS16encode(const RS16 *, uint8_t * const *, size_t);
+RS16dec		*RS16crtDec(const RS16 *, const int *, int);
+void		RS16freeDec(RS16dec *);
+RS16dec		*RS16getDec(RS16 *, const int *, int);
+int		RS16decode(const RS16dec *, uint8_t * const *, size_t);
+int		RS16recover(RS16 *, uint8_t * const *, const int *, int,
+			    size_t);
+int64_t		RS16encodeStream(const RS16 *, size_t, RSread, void *,
+				 RSwrite, void *);
+int64_t		RS16encodeFd(const RS16 *, size_t, int, const int *);
+
+/***************************************************************************
+	8bit: GF(2^8)
+***************************************************************************/
+
+// Decoder for one erasure pattern
+typedef struct {
+	int		k;	// # of data blocks
+	int		m;	// # of parity blocks
+	int		n_era;	// # of erased blocks
+	uint64_t	*bmp;	// Bitmap of erased blocks (key of cache)
+	int		*era;	// Indices of erased blocks (n_era)
+	int		*surv;	// Indices of survivors used for decoding (k)
+	uint8_t		*mtx;	// n_era x k decoding matrix (row major)
+} RS8dec;
+
+// Encoder
+typedef struct {
+	int		k;	// # of data blocks
+	int		m;	// # of parity blocks
+	uint8_t		*mtx;	// m x k coding matrix (row major)
+	int		n_cache;	// # of cached decoders
+	RS8dec		*cache[RS_DEC_CACHE];	// Most recently used first
+} RS8;
+
+// Functions
+int		RS8mtxInv(uint8_t *, const uint8_t *, int);
+int		RS8mtxMul(uint8_t *, const uint8_t *, const uint8_t *,
+			  int, int, int);
+void		RS8cauchyMtx(uint8_t *, int, int);
+int		RS8vandMtx(uint8_t *, int, int);
+RS8		*RS8crt(int, int, int);
+void		RS8free(RS8 *);
+void		RS8encode(const RS8 *, uint8_t * const *, size_t);
+RS8dec		*RS8crtDec(const RS8 *, const int *, int);
+void		RS8freeDec(RS8dec *);
+RS8dec		*RS8getDec(RS8 *, const int *, int);
+int		RS8decode(const RS8dec *, uint8_t * const *, size_t);
+int		RS8recover(RS8 *, uint8_t * const *, const int *, int,
+			   size_t);
+
+#endif // _RS_H_